@@ -0,0 +1,784 @@
+/////////////////////////////////////////////////////////////////////////////////
+//                                                                             //
+//                            Copyright (C) 2012-2023                          //
+//                  Zachary Seth Hartwig : All rights reserved                 //
+//                                                                             //
+//      The ADAQAnalysis source code is licensed under the GNU GPL v3.0.       //
+//      You have the right to modify and/or redistribute this source code      //
+//      under the terms specified in the license, which is found online        //
+//      at http://www.gnu.org/licenses or at $ADAQANALYSIS/License.txt.        //
+//                                                                             //
+/////////////////////////////////////////////////////////////////////////////////
+
+/////////////////////////////////////////////////////////////////////////////////
+//
+// name: ADAQAnalysisBench.cc
+// date: 18 Oct 26
+// auth: Zach Hartwig
+// mail: hartwig@psfc.mit.edu
+//
+// desc: ADAQAnalysisBench is a microbenchmark of the waveform
+//       processing kernels of AAComputation and the energy
+//       conversions of AAInterpolation. Each kernel is run in
+//       isolation over a set of synthetic digitized waveforms --
+//       exponential detector pulses on a noisy baseline -- with a
+//       controllable record length, mean number of pulses per
+//       waveform, and fraction of piled-up pulses. The waveforms are
+//       prepared in advance such that only the kernel itself is timed;
+//       each kernel is run repeatedly over all waveforms for at least
+//       the specified time and the mean time per operation and the
+//       throughput are printed. Note that the waveforms are built
+//       from memory with AAComputation::FillBSWaveform() and
+//       ::FillZSWaveform(), which are the CalculateBSWaveform() and
+//       ::CalculateZSWaveform() methods less the TTree read.
+//
+//       Build with 'make bench'; run 'bin/ADAQAnalysisBench -h' for
+//       the list of options.
+//
+/////////////////////////////////////////////////////////////////////////////////
+
+// ROOT
+#include <TApplication.h>
+#include <TRandom3.h>
+#include <TH1F.h>
+#include <TF1.h>
+#include <TGraph.h>
+#include <TCutG.h>
+
+// C++
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <cstdlib>
+#include <cmath>
+using namespace std;
+
+// ADAQAnalysis
+#include "AAComputation.hh"
+#include "AAInterpolation.hh"
+#include "AASettings.hh"
+#include "AATypes.hh"
+
+
+// Exposes the protected kernel interface of the computation manager
+class AABenchComputation : public AAComputation
+{
+public:
+  AABenchComputation() : AAComputation("Unspecified", false) {;}
+
+  using AAComputation::FillBSWaveform;
+  using AAComputation::FillZSWaveform;
+  using AAComputation::SetKernelInput;
+  using AAComputation::GetKernelWaveform;
+  using AAComputation::InitializePulseStores;
+  using AAComputation::InitializeAccumulators;
+  using AAComputation::GetPSDTotalStore;
+  using AAComputation::GetPSDTailStore;
+  using AAComputation::SelectProcessingKernels;
+  using AAComputation::RunIntegratePeaksKernel;
+  using AAComputation::RunFindPeakHeightsKernel;
+  using AAComputation::RunCalculatePSDIntegralsKernel;
+  using AAComputation::RunFillPulseKernel;
+};
+
+
+class AAKernelBenchmark
+{
+public:
+  AAKernelBenchmark(Int_t, Double_t, Double_t, Int_t, Double_t, UInt_t);
+  ~AAKernelBenchmark();
+
+  void Run();
+
+private:
+  void CreateSettings();
+  void CreateWaveforms();
+  void CreateCalibrations();
+  void CreatePSDRegion();
+
+  // Each benchmark runs a kernel over all of the waveforms in passes
+  // until the minimum time has elapsed
+  void BenchmarkBaseline();
+  void BenchmarkBSWaveform();
+  void BenchmarkZSWaveform();
+  void BenchmarkFindPeaks(Int_t);
+  void BenchmarkFindPeakLimits();
+  void BenchmarkRejectPileup();
+  void BenchmarkIntegratePeaks();
+  void BenchmarkFindPeakHeights();
+  void BenchmarkCalculatePSDIntegrals();
+  void BenchmarkApplyPSDRegion();
+  void BenchmarkCalibrationFit();
+  void BenchmarkCalibrationInterp();
+  void BenchmarkFillPulse(Bool_t);
+  void BenchmarkEnergyConversion();
+  void BenchmarkEnergyConversions();
+
+  // Timing of a single benchmark
+  void Begin();
+  Bool_t Continue();
+  void Report(string, Long64_t, Long64_t, string);
+
+  // Select the peaks of a waveform for the peak-level kernels
+  void SelectWaveform(Int_t);
+
+  Int_t RecordLength, NumWaveforms;
+  Double_t PulseRate, PileupFraction, MinTime;
+  UInt_t Seed;
+
+  AABenchComputation *ComputationMgr;
+  AAInterpolation *InterpolationMgr;
+  AASettings *ADAQSettings;
+
+  const Int_t Channel;
+
+  // The raw waveforms and, for the peak-level kernels, the baseline
+  // subtracted waveforms and the peaks (with limits) found in each
+  vector< vector<Int_t> > RawWaveforms;
+  vector<TH1F *> BSWaveforms;
+  vector< vector<PeakInfoStruct> > Peaks;
+  Long64_t NumPeaks;
+
+  // Pulse values used by the PSD region, calibration, and energy
+  // conversion benchmarks
+  vector<Double_t> Totals, Tails, Areas, Energies;
+
+  chrono::steady_clock::time_point StartTime;
+  Double_t Elapsed;
+
+  // Accumulates kernel results such that no kernel can be optimized out
+  volatile Double_t Sink;
+};
+
+
+AAKernelBenchmark::AAKernelBenchmark(Int_t RL, Double_t PR, Double_t PF,
+				     Int_t NW, Double_t MT, UInt_t S)
+  : RecordLength(RL), NumWaveforms(NW),
+    PulseRate(PR), PileupFraction(PF), MinTime(MT), Seed(S),
+    Channel(0), NumPeaks(0), Elapsed(0.), Sink(0.)
+{
+  ComputationMgr = new AABenchComputation;
+  InterpolationMgr = new AAInterpolation;
+  ADAQSettings = new AASettings;
+
+  CreateSettings();
+  CreateCalibrations();
+  CreatePSDRegion();
+
+  ComputationMgr->SetADAQSettings(ADAQSettings);
+  ComputationMgr->CreateNewPeakFinder(ADAQSettings->MaxPeaks);
+
+  CreateWaveforms();
+}
+
+
+AAKernelBenchmark::~AAKernelBenchmark()
+{
+  for(size_t w=0; w<BSWaveforms.size(); w++)
+    delete BSWaveforms[w];
+
+  delete ADAQSettings;
+  delete InterpolationMgr;
+  delete ComputationMgr;
+}
+
+
+void AAKernelBenchmark::CreateSettings()
+{
+  AASettings *S = ADAQSettings;
+
+  S->WaveformChannel = Channel;
+  S->WaveformPolarity = 1;
+  S->RawWaveform = false;
+  S->BSWaveform = true;
+  S->ZSWaveform = false;
+  S->ZeroSuppressionCeiling = 15;
+  S->ZeroSuppressionBuffer = 20;
+
+  S->BaselineRegionMin = 0;
+  S->BaselineRegionMax = 50;
+  S->AnalysisRegionMin = 0;
+  S->AnalysisRegionMax = RecordLength;
+
+  S->UseMarkovSmoothing = false;
+  S->MaxPeaks = 50;
+  S->Sigma = 5;
+  S->Floor = 50;
+  S->Resolution = 0.005;
+  S->UsePileupRejection = true;
+
+  S->SpectrumNumBins = 1000;
+  S->SpectrumMinBin = 0.;
+  S->SpectrumMaxBin = 50000.;
+  S->SpectrumMinThresh = 0.;
+  S->SpectrumMaxThresh = 1.e9;
+  S->ADAQSpectrumTypePAS = true;
+  S->ADAQSpectrumTypePHS = false;
+
+  S->PSDThreshold = 0.;
+  S->PSDNumTotalBins = 200;
+  S->PSDMinTotalBin = 0.;
+  S->PSDMaxTotalBin = 50000.;
+  S->PSDNumTailBins = 200;
+  S->PSDMinTailBin = 0.;
+  S->PSDMaxTailBin = 10000.;
+  S->PSDXAxisADC = true;
+  S->PSDXAxisEnergy = false;
+  S->PSDYAxisTail = true;
+  S->PSDYAxisTailTotal = false;
+  S->PSDTotalStart = -10;
+  S->PSDTotalStop = 100;
+  S->PSDTailStart = 20;
+  S->PSDTailStop = 100;
+  S->PSDInsideRegion = true;
+  S->PSDOutsideRegion = false;
+
+  S->PulseStorePrecision = zPulseStoreFloat;
+  S->PulseStoreSpillToDisk = false;
+
+  for(Int_t ch=0; ch<MAX_DG_CHANNELS; ch++){
+    S->SpectraCalibrations.push_back(NULL);
+    S->SpectraCalibrationData.push_back(NULL);
+    S->UseSpectraCalibrations.push_back(false);
+    S->PSDRegions.push_back(NULL);
+    S->UsePSDRegions.push_back(false);
+  }
+}
+
+
+// Method to create the synthetic waveforms. Each pulse is the
+// difference of two exponentials (rise and decay) with an amplitude
+// drawn uniformly over the dynamic range. The number of pulses in a
+// waveform is Poisson distributed about the pulse rate, and each
+// pulse is followed within a few samples by a second pulse with the
+// probability given by the pileup fraction
+void AAKernelBenchmark::CreateWaveforms()
+{
+  TRandom3 RNG(Seed);
+
+  const Double_t BaselineLevel = 1000.;
+  const Double_t Noise = 2.;
+  const Double_t RiseTime = 2., DecayTime = 20.;
+  const Int_t PulseStart = ADAQSettings->BaselineRegionMax + 10;
+  const Int_t PulseStop = RecordLength - 5*DecayTime;
+
+  RawWaveforms.assign(NumWaveforms, vector<Int_t>(RecordLength, 0));
+
+  for(Int_t w=0; w<NumWaveforms; w++){
+
+    vector<Double_t> Voltage(RecordLength, BaselineLevel);
+
+    vector<Double_t> Times;
+    Int_t NumPulses = (PulseStop > PulseStart) ? RNG.Poisson(PulseRate) : 0;
+    for(Int_t p=0; p<NumPulses; p++){
+      Times.push_back(RNG.Uniform(PulseStart, PulseStop));
+      if(RNG.Rndm() < PileupFraction)
+	Times.push_back(Times.back() + RNG.Uniform(2., 3*RiseTime));
+    }
+
+    for(size_t p=0; p<Times.size(); p++){
+      Double_t Amplitude = RNG.Uniform(100., 1500.);
+      for(Int_t sample=Int_t(Times[p])+1; sample<RecordLength; sample++){
+	Double_t t = sample - Times[p];
+	Voltage[sample] += Amplitude * (exp(-t/DecayTime) - exp(-t/RiseTime));
+      }
+    }
+
+    for(Int_t sample=0; sample<RecordLength; sample++){
+      Int_t ADC = Int_t(Voltage[sample] + RNG.Gaus(0., Noise));
+      RawWaveforms[w][sample] = min(max(ADC, 0), 16383);
+    }
+  }
+
+  // Prepare the baseline-subtracted waveforms and the peaks and peak
+  // limits of each waveform for the peak-level kernels
+
+  ComputationMgr->InitializePulseStores(Channel, zPulseStoreDouble);
+
+  for(Int_t w=0; w<NumWaveforms; w++){
+    TH1F *Waveform_H = ComputationMgr->FillBSWaveform(Channel, RawWaveforms[w]);
+
+    stringstream SS;
+    SS << "BSWaveform" << w;
+    BSWaveforms.push_back((TH1F *)Waveform_H->Clone(SS.str().c_str()));
+    BSWaveforms.back()->SetDirectory(0);
+
+    ComputationMgr->FindPeaks(BSWaveforms.back(), zPeakFinder);
+    Peaks.push_back(ComputationMgr->GetPeakInfoVec());
+    NumPeaks += Peaks.back().size();
+
+    ComputationMgr->CalculatePSDIntegrals(false);
+
+    vector<PeakInfoStruct> PeakInfoVec = ComputationMgr->GetPeakInfoVec();
+    for(size_t p=0; p<PeakInfoVec.size(); p++){
+      PeakInfoStruct &Peak = PeakInfoVec[p];
+      if(Peak.PeakLimit_Lower < 0)
+	continue;
+      
+      Areas.push_back(BSWaveforms.back()->Integral(Peak.PeakLimit_Lower, Peak.PeakLimit_Upper));
+    }
+  }
+
+  const AAPulseStore &TotalStore = ComputationMgr->GetPSDTotalStore(Channel);
+  const AAPulseStore &TailStore = ComputationMgr->GetPSDTailStore(Channel);
+  for(size_t p=0; p<TotalStore.size(); p++){
+    Totals.push_back(TotalStore[p]);
+    Tails.push_back(TailStore[p]);
+  }
+
+  // Electron equivalent energies [MeVee] spanning the responses
+  for(Int_t e=0; e<10000; e++)
+    Energies.push_back(0.01 + 10. * e / 10000);
+}
+
+
+// Method to create a linear fit calibration and a piecewise-linear
+// interpolation calibration from ADC to MeVee
+void AAKernelBenchmark::CreateCalibrations()
+{
+  TF1 *Calibration = new TF1("BenchCalibration", "pol1", 0., 50000.);
+  Calibration->SetParameters(0.005, 2.e-4);
+  ADAQSettings->SpectraCalibrations[Channel] = Calibration;
+
+  const Int_t NumPoints = 6;
+  Double_t ADC[NumPoints] = {0., 2000., 5000., 12000., 25000., 50000.};
+  Double_t MeVee[NumPoints] = {0., 0.4, 1.0, 2.5, 5.1, 10.2};
+  ADAQSettings->SpectraCalibrationData[Channel] = new TGraph(NumPoints, ADC, MeVee);
+}
+
+
+// Method to create a PSD region enclosing roughly the lower half of
+// the synthetic (total, tail) distribution
+void AAKernelBenchmark::CreatePSDRegion()
+{
+  const Int_t NumPoints = 5;
+  Double_t Total[NumPoints] = {0., 50000., 50000., 0., 0.};
+  Double_t Tail[NumPoints] = {0., 0., 8000., 1500., 0.};
+  ADAQSettings->PSDRegions[Channel] = new TCutG("BenchPSDRegion", NumPoints, Total, Tail);
+}
+
+
+void AAKernelBenchmark::Begin()
+{
+  StartTime = chrono::steady_clock::now();
+  Elapsed = 0.;
+}
+
+
+Bool_t AAKernelBenchmark::Continue()
+{
+  Elapsed = chrono::duration<Double_t>(chrono::steady_clock::now() - StartTime).count();
+  return (Elapsed < MinTime);
+}
+
+
+// Method to print the time per operation and the throughput in
+// operations per second and, if applicable, in items (samples,
+// peaks, values) per second
+void AAKernelBenchmark::Report(string Name, Long64_t Operations, Long64_t Items, string ItemName)
+{
+  if(Operations == 0){
+    cout << "  " << left << setw(34) << Name << right << setw(12) << "n/a" << endl;
+    return;
+  }
+
+  cout << "  " << left << setw(34) << Name << right
+       << fixed << setprecision(1)
+       << setw(12) << Elapsed * 1.e9 / Operations
+       << setw(14) << Operations / Elapsed / 1.e6;
+
+  if(Items > 0)
+    cout << setw(14) << Items / Elapsed / 1.e6 << " M" << ItemName << "/s";
+
+  cout << endl;
+}
+
+
+void AAKernelBenchmark::SelectWaveform(Int_t w)
+{
+  ComputationMgr->SetKernelInput(Channel, BSWaveforms[w], Peaks[w]);
+}
+
+
+void AAKernelBenchmark::BenchmarkBaseline()
+{
+  Long64_t Operations = 0;
+  Begin();
+  do{
+    for(Int_t w=0; w<NumWaveforms; w++)
+      Sink = Sink + ComputationMgr->CalculateBaseline(&RawWaveforms[w]);
+    Operations += NumWaveforms;
+  } while(Continue());
+
+  Int_t BaselineLength = ADAQSettings->BaselineRegionMax - ADAQSettings->BaselineRegionMin;
+  Report("CalculateBaseline", Operations, Operations * BaselineLength, "samples");
+}
+
+
+void AAKernelBenchmark::BenchmarkBSWaveform()
+{
+  Long64_t Operations = 0;
+  Begin();
+  do{
+    for(Int_t w=0; w<NumWaveforms; w++)
+      Sink = Sink + ComputationMgr->FillBSWaveform(Channel, RawWaveforms[w])->GetNbinsX();
+    Operations += NumWaveforms;
+  } while(Continue());
+
+  Report("CalculateBSWaveform (no read)", Operations, Operations * RecordLength, "samples");
+}
+
+
+void AAKernelBenchmark::BenchmarkZSWaveform()
+{
+  Long64_t Operations = 0;
+  Begin();
+  do{
+    for(Int_t w=0; w<NumWaveforms; w++)
+      Sink = Sink + ComputationMgr->FillZSWaveform(Channel, RawWaveforms[w])->GetNbinsX();
+    Operations += NumWaveforms;
+  } while(Continue());
+
+  Report("CalculateZSWaveform (no read)", Operations, Operations * RecordLength, "samples");
+}
+
+
+void AAKernelBenchmark::BenchmarkFindPeaks(Int_t Algorithm)
+{
+  Long64_t Operations = 0;
+  Begin();
+  do{
+    for(Int_t w=0; w<NumWaveforms; w++)
+      Sink = Sink + ComputationMgr->FindPeaks(BSWaveforms[w], Algorithm);
+    Operations += NumWaveforms;
+  } while(Continue());
+
+  if(Algorithm == zPeakFinder)
+    Report("FindPeaks (peak finder)", Operations, Operations * RecordLength, "samples");
+  else
+    Report("FindPeaks (whole waveform)", Operations, Operations * RecordLength, "samples");
+}
+
+
+// The peak-level benchmarks restore the peaks found in each waveform
+// before running the kernel; the cost of copying the (few) peaks is
+// included in the time per operation
+void AAKernelBenchmark::BenchmarkFindPeakLimits()
+{
+  Long64_t Operations = 0;
+  Begin();
+  do{
+    for(Int_t w=0; w<NumWaveforms; w++){
+      SelectWaveform(w);
+      ComputationMgr->FindPeakLimits(BSWaveforms[w]);
+    }
+    Operations += NumWaveforms;
+  } while(Continue());
+
+  Report("FindPeakLimits", Operations, Operations * RecordLength, "samples");
+}
+
+
+void AAKernelBenchmark::BenchmarkRejectPileup()
+{
+  Long64_t Operations = 0;
+  Begin();
+  do{
+    for(Int_t w=0; w<NumWaveforms; w++){
+      SelectWaveform(w);
+      ComputationMgr->RejectPileup(BSWaveforms[w]);
+    }
+    Operations += NumWaveforms;
+  } while(Continue());
+
+  Report("RejectPileup", Operations, Operations * NumPeaks / NumWaveforms, "peaks");
+}
+
+
+void AAKernelBenchmark::BenchmarkIntegratePeaks()
+{
+  Long64_t Operations = 0;
+  Begin();
+  do{
+    ComputationMgr->InitializePulseStores(Channel, zPulseStoreFloat);
+    for(Int_t w=0; w<NumWaveforms; w++){
+      SelectWaveform(w);
+      ComputationMgr->RunIntegratePeaksKernel(Channel);
+    }
+    Operations += NumWaveforms;
+  } while(Continue());
+
+  Report("IntegratePeaks", Operations, Operations * NumPeaks / NumWaveforms, "peaks");
+}
+
+
+void AAKernelBenchmark::BenchmarkFindPeakHeights()
+{
+  Long64_t Operations = 0;
+  Begin();
+  do{
+    ComputationMgr->InitializePulseStores(Channel, zPulseStoreFloat);
+    for(Int_t w=0; w<NumWaveforms; w++){
+      SelectWaveform(w);
+      ComputationMgr->RunFindPeakHeightsKernel(Channel);
+    }
+    Operations += NumWaveforms;
+  } while(Continue());
+
+  Report("FindPeakHeights", Operations, Operations * NumPeaks / NumWaveforms, "peaks");
+}
+
+
+void AAKernelBenchmark::BenchmarkCalculatePSDIntegrals()
+{
+  Long64_t Operations = 0;
+  Begin();
+  do{
+    ComputationMgr->InitializePulseStores(Channel, zPulseStoreFloat);
+    for(Int_t w=0; w<NumWaveforms; w++){
+      SelectWaveform(w);
+      ComputationMgr->RunCalculatePSDIntegralsKernel(Channel);
+    }
+    Operations += NumWaveforms;
+  } while(Continue());
+
+  Report("CalculatePSDIntegrals", Operations, Operations * NumPeaks / NumWaveforms, "peaks");
+}
+
+
+void AAKernelBenchmark::BenchmarkApplyPSDRegion()
+{
+  const Int_t N = Totals.size();
+
+  Long64_t Operations = 0;
+  Begin();
+  do{
+    for(Int_t p=0; p<N; p++)
+      Sink = Sink + ComputationMgr->ApplyPSDRegion(Totals[p], Tails[p]);
+    Operations += N;
+  } while(Continue() and N > 0);
+
+  Report("ApplyPSDRegion", Operations, 0, "");
+}
+
+
+void AAKernelBenchmark::BenchmarkCalibrationFit()
+{
+  TF1 *Calibration = ADAQSettings->SpectraCalibrations[Channel];
+  const Int_t N = Areas.size();
+
+  Long64_t Operations = 0;
+  Begin();
+  do{
+    for(Int_t p=0; p<N; p++)
+      Sink = Sink + Calibration->Eval(Areas[p]);
+    Operations += N;
+  } while(Continue() and N > 0);
+
+  Report("Calibration TF1::Eval (fit)", Operations, 0, "");
+}
+
+
+void AAKernelBenchmark::BenchmarkCalibrationInterp()
+{
+  TGraph *Calibration = ADAQSettings->SpectraCalibrationData[Channel];
+  const Int_t N = Areas.size();
+
+  Long64_t Operations = 0;
+  Begin();
+  do{
+    for(Int_t p=0; p<N; p++)
+      Sink = Sink + Calibration->Eval(Areas[p]);
+    Operations += N;
+  } while(Continue() and N > 0);
+
+  Report("Calibration TGraph::Eval (interp)", Operations, 0, "");
+}
+
+
+// The pulse kernel (add the pulse to the stores, calibrate, and fill
+// the spectrum) as used by the simple maximum/sum algorithm
+void AAKernelBenchmark::BenchmarkFillPulse(Bool_t Calibrated)
+{
+  ADAQSettings->UseSpectraCalibrations[Channel] = Calibrated;
+  ComputationMgr->SelectProcessingKernels(false);
+
+  const Int_t N = Areas.size();
+
+  Long64_t Operations = 0;
+  Begin();
+  do{
+    ComputationMgr->InitializePulseStores(Channel, zPulseStoreFloat);
+    for(Int_t p=0; p<N; p++)
+      ComputationMgr->RunFillPulseKernel(Channel, Areas[p]/20., Areas[p]);
+    Operations += N;
+  } while(Continue() and N > 0);
+
+  ADAQSettings->UseSpectraCalibrations[Channel] = false;
+  ComputationMgr->SelectProcessingKernels(false);
+
+  if(Calibrated)
+    Report("FillPulse (calibrated fit)", Operations, 0, "");
+  else
+    Report("FillPulse (uncalibrated)", Operations, 0, "");
+}
+
+
+void AAKernelBenchmark::BenchmarkEnergyConversion()
+{
+  const Int_t N = Energies.size();
+
+  Long64_t Operations = 0;
+  Begin();
+  do{
+    for(Int_t e=0; e<N; e++)
+      Sink = Sink + InterpolationMgr->GetProtonEnergy(Energies[e]);
+    Operations += N;
+  } while(Continue());
+
+  Report("AAInterpolation::GetProtonEnergy", Operations, 0, "");
+}
+
+
+void AAKernelBenchmark::BenchmarkEnergyConversions()
+{
+  const Int_t N = Energies.size();
+  vector<Double_t> Converted(N, 0.);
+
+  Long64_t Operations = 0;
+  Begin();
+  do{
+    InterpolationMgr->ConvertEnergies(&Energies[0], &Converted[0], N, zProtonEnergy);
+    Sink = Sink + Converted[N-1];
+    Operations += N;
+  } while(Continue());
+
+  Report("AAInterpolation::ConvertEnergies", Operations, 0, "");
+}
+
+
+void AAKernelBenchmark::Run()
+{
+  cout << "\nADAQAnalysisBench : " << NumWaveforms << " waveforms of " << RecordLength << " samples, "
+       << PulseRate << " pulses/waveform, " << PileupFraction*100 << "% pileup, "
+       << NumPeaks << " peaks found\n"
+       << "                    minimum of " << MinTime << " s per kernel (seed " << Seed << ")\n"
+       << endl;
+
+  cout << "  " << left << setw(34) << "Kernel" << right
+       << setw(12) << "ns/op"
+       << setw(14) << "Mop/s"
+       << setw(14) << "Throughput"
+       << "\n  " << string(76, '-')
+       << endl;
+
+  // Waveform-level kernels; the waveform histogram owned by the
+  // computation manager is restored once the peak-level kernels,
+  // which operate on the prepared waveforms, have finished
+
+  BenchmarkBaseline();
+  BenchmarkBSWaveform();
+  BenchmarkZSWaveform();
+  BenchmarkFindPeaks(zPeakFinder);
+  BenchmarkFindPeaks(zWholeWaveform);
+
+  TH1F *Waveform_H = ComputationMgr->GetKernelWaveform(Channel);
+
+  // Peak-level kernels with the spectrum filled with the pulse area
+  // and pileup rejection enabled, as for the peak finder algorithm
+
+  ComputationMgr->InitializeAccumulators();
+
+  ComputationMgr->SelectProcessingKernels(true);
+
+  BenchmarkFindPeakLimits();
+  BenchmarkRejectPileup();
+  BenchmarkIntegratePeaks();
+  BenchmarkFindPeakHeights();
+  BenchmarkCalculatePSDIntegrals();
+
+  ComputationMgr->SetKernelInput(Channel, Waveform_H, ComputationMgr->GetPeakInfoVec());
+
+  // Pulse-level kernels
+
+  BenchmarkApplyPSDRegion();
+  BenchmarkCalibrationFit();
+  BenchmarkCalibrationInterp();
+  BenchmarkFillPulse(false);
+  BenchmarkFillPulse(true);
+
+  // Energy conversions (the responses are constructed on first use)
+
+  InterpolationMgr->ConstructResponses();
+  BenchmarkEnergyConversion();
+  BenchmarkEnergyConversions();
+
+  cout << endl;
+}
+
+
+int main(int argc, char *argv[])
+{
+  Int_t RecordLength = 1024;
+  Double_t PulseRate = 1.;
+  Double_t PileupFraction = 0.1;
+  Int_t NumWaveforms = 1000;
+  Double_t MinTime = 1.;
+  UInt_t Seed = 4357;
+
+  for(Int_t arg=1; arg<argc; arg++){
+    string Option = argv[arg];
+
+    if(Option == "-h" or arg+1 == argc){
+      cout << "\nUsage: ADAQAnalysisBench [options]\n"
+	   <<   "       -l <samples>  : Waveform record length          (default " << RecordLength << ")\n"
+	   <<   "       -r <pulses>   : Mean pulses per waveform        (default " << PulseRate << ")\n"
+	   <<   "       -p <fraction> : Fraction of pulses piled up     (default " << PileupFraction << ")\n"
+	   <<   "       -n <number>   : Number of synthetic waveforms   (default " << NumWaveforms << ")\n"
+	   <<   "       -t <seconds>  : Minimum time per kernel         (default " << MinTime << ")\n"
+	   <<   "       -s <seed>     : Random number seed              (default " << Seed << ")\n"
+	   << endl;
+      return (Option == "-h") ? 0 : -42;
+    }
+
+    string Value = argv[++arg];
+
+    if(Option == "-l")
+      RecordLength = atoi(Value.c_str());
+    else if(Option == "-r")
+      PulseRate = atof(Value.c_str());
+    else if(Option == "-p")
+      PileupFraction = atof(Value.c_str());
+    else if(Option == "-n")
+      NumWaveforms = atoi(Value.c_str());
+    else if(Option == "-t")
+      MinTime = atof(Value.c_str());
+    else if(Option == "-s")
+      Seed = atoi(Value.c_str());
+    else{
+      cout << "\nError! Unspecified command line argument '" << Option << "' passed to ADAQAnalysisBench!\n"
+	   << endl;
+      return -42;
+    }
+  }
+
+  if(RecordLength < 200 or NumWaveforms < 1){
+    cout << "\nError! ADAQAnalysisBench requires a record length of at least 200 samples and at least one waveform!\n"
+	 << endl;
+    return -42;
+  }
+
+  TApplication *TheApplication = new TApplication("ADAQAnalysisBench", NULL, NULL);
+
+  AAKernelBenchmark *TheBenchmark = new AAKernelBenchmark(RecordLength, PulseRate, PileupFraction,
+							  NumWaveforms, MinTime, Seed);
+  TheBenchmark->Run();
+
+  delete TheBenchmark;
+  delete TheApplication;
+
+  return 0;
+}
@@ -54,6 +54,8 @@
 // C++
 #include <string>
 #include <vector>
+#include <fstream>
+#include <atomic>
 using namespace std;
 
 // ADAQ
@@ -66,10 +68,16 @@ using namespace std;
 // ADAQAnalysis
 #include "AASettings.hh"
 #include "AAParallelResults.hh"
+#include "AAPulseStore.hh"
+#include "AAHistogramAccumulator.hh"
+#include "AAProcessingMetrics.hh"
+#include "AASpectrumBackground.hh"
+#include "AASpectrumFitter.hh"
 #include "AATypes.hh"
 
 #ifndef __CINT__
 #include <boost/array.hpp>
+#include <boost/thread.hpp>
 #endif
 
 #define MAX_DG_CHANNELS 16
@@ -94,7 +102,11 @@ public:
   Bool_t LoadADAQFile(string);
   void LoadLegacyADAQFile();
   Bool_t LoadASIMFile(string);
+  Bool_t LoadASIMFiles(vector<string>);
   Bool_t SaveHistogramData(string, string, string);
+  Bool_t SaveASIMSpectraData(string, string);
+  Bool_t SaveSettingsSweepData(string, string);
+  Bool_t SavePSDFOMScanData(string, string);
   void CreateDesplicedFile();
 
   // Waveform creation
@@ -112,12 +124,33 @@ public:
   void RejectPileup(TH1F *);
   Bool_t RejectPSD(Int_t, Int_t);
   void AnalyzeWaveform(TH1F *);
+
+  // Waveform summary index
+  void BuildWaveformIndex();
+  void CancelWaveformIndex();
+  Bool_t GetWaveformIndexValid();
+  Bool_t GetWaveformIndexBuilding();
+  Int_t FindNextPSDWaveform(Int_t);
+  Int_t FindNextWaveformInHeightRange(Int_t, Double_t, Double_t);
+  vector<Int_t> FindWaveformsInHeightRange(Double_t, Double_t);
   
   // Spectrum creation
   void ProcessSpectrumWaveforms();
   void CreateSpectrum();
   void CreateASIMSpectrum();
+  vector<TH1F *> CreateASIMSpectra(vector<string>);
+  Bool_t CreateConvertedSpectrum(Int_t);
   void CalculateSpectrumBackground();
+  Bool_t SweepSpectrumSettings(vector<SettingsVariantStruct>);
+  void ClearSettingsSweep();
+
+  // The variants swept by the zSettingsSweepJob background job
+  void SetSettingsSweep(vector<SettingsVariantStruct> V) {SettingsSweep = V;}
+
+  // Recompute a spectrum analysis product (see SpectrumProductType)
+  // only if the settings or products on which it depends have changed
+  // since it was last computed. Returns true if it was recomputed
+  Bool_t UpdateSpectrumProduct(Int_t);
 
   // Spectrum processing
   void FindSpectrumPeaks();
@@ -125,8 +158,11 @@ public:
   void FitSpectrum();
   TGraph *CalculateSpectrumDerivative();
   Bool_t WriteSpectrumFitResultsFile(string);
+  Bool_t BatchFitSpectra(vector<TH1F *>, vector<string>, vector<SpectrumFitWindowStruct>, string);
+  vector<SpectrumFitWindowStruct> ReadSpectrumFitWindowsFile(string);
 
   // Spectrum calibration
+  CalibrationLookupStruct CreateCalibrationLookup(Int_t);
   Bool_t SetCalibrationPoint(Int_t, Int_t, Double_t, Double_t);
   Bool_t SetCalibration(Int_t);
   Bool_t ClearCalibration(Int_t);
@@ -137,6 +173,11 @@ public:
   Bool_t FindCalibrationPeak();
   Bool_t FindCalibrationEdge();
 
+  // Gain drift correction
+  Bool_t CreateGainDriftCorrection(vector<GainReferenceStruct>, Int_t);
+  void ClearGainDriftCorrection();
+  Bool_t WriteGainDriftCorrectionFile(string);
+
   // Pulse shape discrimination processing
   TH2F *ProcessPSDHistogramWaveforms();
   TH2F *CreatePSDHistogram();
@@ -147,12 +188,45 @@ public:
   void AddPSDRegionPoint(Int_t, Int_t);
   void CreatePSDRegion();
   void ClearPSDRegion();
-  void CreatePSDHistogramSlice(Int_t, Int_t);
+  Bool_t CreatePSDHistogramSlice(Int_t, Int_t);
+  Bool_t CreatePSDFOMScan(Int_t, Double_t, Double_t);
+  Bool_t OptimizePSDWindows(PSDWindowScanStruct);
+
+  // The scan run by the zPSDWindowOptimizationJob background job
+  void SetPSDWindowScan(PSDWindowScanStruct S) {PSDWindowScan = S;}
+
+  // The FOM of the present PSD histogram slice is computed in a
+  // background thread. Only the most recent request is kept while a
+  // fit runs; UpdatePSDSliceFit() collects the finished fit on the
+  // GUI thread and returns true if it belongs to the latest request
+  void RequestPSDSliceFit();
+  Bool_t UpdatePSDSliceFit();
+  Bool_t GetPSDSliceFitPending() {return (PSDSliceFitThread != NULL);}
   
   // Processing methods
   void UpdateProcessingProgress(Int_t);
   void ProcessWaveformsInParallel(string);
 
+  // Background processing of the waveform processing jobs started
+  // from the GUI (see ProcessingJobType)
+  Bool_t StartProcessingThread(Int_t);
+  Bool_t FinishProcessingThread();
+  void CancelProcessing();
+  Bool_t GetProcessingActive();
+  Bool_t GetProcessingCancelled();
+  Int_t GetProcessingJob();
+  Double_t GetProcessingFraction();
+  Long64_t GetProcessingDone();
+
+  // Copy the counts accumulated so far by the background processing
+  // thread into a histogram for display while processing continues
+  Bool_t UpdateProcessingSnapshot();
+  TH1 *GetProcessingSnapshot() {return ProcessingSnapshot_H;}
+
+  // Stage times and rates of the present (or the last) spectrum or
+  // PSD histogram processing loop
+  const AAProcessingMetrics *GetProcessingMetrics() {return &ProcessingMetrics;}
+
 
   ////////////////////////////////////////
   // Public access methods for member data
@@ -169,11 +243,24 @@ public:
   {
     Spectrum_H = H;
     SpectrumExists = true;
+    SpectrumVersion++;
+
+    // The exact counts of the previous spectrum must not be exported
+    // in place of those of the new spectrum
+    SpectrumCounts.Initialize(H);
   }
   
-  TH1F *GetSpectrum() {return (TH1F *)Spectrum_H->Clone();}
-  TH1F *GetSpectrumBackground() {return (TH1F *)SpectrumBackground_H->Clone();}
-  TH1F *GetSpectrumWithoutBackground() {return (TH1F *)SpectrumDeconvolved_H->Clone();}
+  // Read-only access to the computed spectra, which remain owned by
+  // the computation manager; callers that must modify a spectrum
+  // (e.g. to restyle it for plotting) are responsible for copying it
+  const TH1F *GetSpectrum() {return Spectrum_H;}
+  const TH1F *GetSpectrumBackground() {return SpectrumBackground_H;}
+  const TH1F *GetSpectrumWithoutBackground() {return SpectrumDeconvolved_H;}
+  vector<TH1F *> GetASIMSpectra() {return ASIMSpectra_H;}
+  vector<TH1F *> GetSettingsSweepSpectra() {return SettingsSweepSpectra_H;}
+  vector<SettingsVariantStruct> GetSettingsSweepVariants() {return SettingsSweepVariants;}
+  vector<Double_t> GetSettingsSweepTimes() {return SettingsSweepTimes;}
+  TH1F *GetConvertedSpectrum() {return ConvertedSpectrum_H;}
   
   // Spectra calibrations
   vector<TGraph *> GetSpectraCalibrationData() { return SpectraCalibrationData; }
@@ -187,16 +274,28 @@ public:
   Double_t GetCalibrationX() {return CalibrationX;}
   Double_t GetCalibrationY() {return CalibrationY;}
   Bool_t GetCalibrationFound() {return CalibrationFound;}
+
+  vector<Double_t> GetGainDriftCorrections() {return GainDriftCorrections;}
+  Bool_t GetGainDriftCorrectionExists() {return GainDriftCorrectionExists;}
+  Bool_t GetSpectrumPreviewOrder() {return SpectrumPreviewOrder;}
   
   // Spectra analysis
   TH1F *GetSpectrumIntegral() { return SpectrumIntegral_H; }
   TF1 *GetSpectrumFit() { return SpectrumFit_F; }
+  TGraph *GetSpectrumDerivative() { return SpectrumDerivative_G; }
   Double_t GetSpectrumIntegralValue() { return SpectrumIntegralValue; }
   Double_t GetSpectrumIntegralError() { return SpectrumIntegralError; }
 
   // Pulse shape discrimination histograms
   TH2F *GetPSDHistogram() { return PSDHistogram_H; }
   TH1D *GetPSDHistogramSlice() { return PSDHistogramSlice_H; }
+  TGraphErrors *GetPSDFOMScan() { return PSDFOMScan_GE; }
+
+  // Results of the latest PSD histogram slice FOM fit
+  Bool_t GetPSDSliceFitValid() { return PSDSliceFit.Valid; }
+  const SpectrumFitResultStruct &GetPSDSliceLowerFit() { return PSDSliceFit.Lower; }
+  const SpectrumFitResultStruct &GetPSDSliceUpperFit() { return PSDSliceFit.Upper; }
+  Double_t GetPSDSliceFOM() { return PSDSliceFit.FOM; }
   
   // Pulse shape discrimination regions
   vector<TCutG *> GetPSDRegions() { return PSDRegions; }
@@ -214,16 +313,22 @@ public:
   
   // ASIM file data
   string GetASIMFileName() { return ASIMFileName; }
-  TList *GetASIMEventTreeList() { return ASIMEventTreeList; }
+  vector<string> GetASIMEventTreeNames();
+  TTree *GetASIMEventTree(string);
   
   // Bool_Teans
   Bool_t GetADAQFileLoaded() { return ADAQFileLoaded; }
   Bool_t GetASIMFileLoaded() { return ASIMFileLoaded; }
   Bool_t GetSpectrumExists() { return SpectrumExists; }
+  Bool_t GetASIMSpectraExist() { return ASIMSpectraExist; }
+  Bool_t GetSettingsSweepExists() { return SettingsSweepExists; }
+  Bool_t GetConvertedSpectrumExists() { return ConvertedSpectrumExists; }
   Bool_t GetSpectrumBackgroundExists() { return SpectrumBackgroundExists; }
   Bool_t GetSpectrumDerivativeExists() { return SpectrumDerivativeExists; }
   Bool_t GetPSDHistogramExists() { return PSDHistogramExists; }
   Bool_t GetPSDHistogramSliceExists() { return PSDHistogramSliceExists; }
+  Bool_t GetPSDFOMScanExists() { return PSDFOMScanExists; }
+  vector<PSDWindowCandidateStruct> GetPSDWindowCandidates() { return PSDWindowCandidates; }
 
 
   ////////////////
@@ -235,6 +340,34 @@ public:
   }
   
   
+protected:
+
+  // Interface to the waveform processing kernels for the kernel
+  // microbenchmark (bench/ADAQAnalysisBench.cc), which runs them from
+  // a subclass on synthetic waveforms held in memory
+
+  // Create the waveform from raw samples without a waveform tree read
+  TH1F *FillBSWaveform(Int_t, vector<Int_t> &);
+  TH1F *FillZSWaveform(Int_t, vector<Int_t> &);
+
+  // Set the waveform and peaks on which the peak kernels operate
+  void SetKernelInput(Int_t, TH1F *, const vector<PeakInfoStruct> &);
+  TH1F *GetKernelWaveform(Int_t);
+
+  // Initialize the pulse stores of a channel with the specified
+  // precision and the accumulators with the binning of the settings
+  void InitializePulseStores(Int_t, Int_t);
+  void InitializeAccumulators();
+  
+  const AAPulseStore &GetPSDTotalStore(Int_t);
+  const AAPulseStore &GetPSDTailStore(Int_t);
+
+  void SelectProcessingKernels(Bool_t);
+  void RunIntegratePeaksKernel(Int_t);
+  void RunFindPeakHeightsKernel(Int_t);
+  void RunCalculatePSDIntegralsKernel(Int_t);
+  void RunFillPulseKernel(Int_t, Double_t, Double_t);
+  
 private:
 
   static AAComputation *TheComputationManager;
@@ -262,13 +395,89 @@ private:
   
   ADAQRootMeasParams *ADAQMeasParams;
 
-  TFile *ASIMFile;
+  vector<TFile *> ASIMFiles;
   string ASIMFileName;
   Bool_t ASIMFileLoaded;
 
-  TList *ASIMEventTreeList;
+  vector<ASIMEventTreeInfo> ASIMEventTreeCatalog;
   ASIMEvent *ASIMEvt;
 
+#ifndef __CINT__
+  // A contiguous range of ASIM event tree entries to be histogrammed
+  // by a single thread into its own array of bin contents
+  struct ASIMSpectrumJob{
+    string FileName, KeyName, Member;
+    Long64_t First, Last;
+    Double_t MinThresh, MaxThresh;
+    CalibrationLookupStruct Calibration;
+    const TAxis *Axis;
+    vector<Double_t> Counts;
+    Long64_t Fills;
+  };
+
+  void ProcessASIMSpectrumJob(ASIMSpectrumJob *);
+  void ProcessASIMSpectrumJobs(vector<ASIMSpectrumJob> *, Int_t, Int_t);
+
+  // A contiguous range of source spectrum bins to be remapped onto
+  // the converted energy axis by a single thread
+  struct SpectrumConversionJob{
+    Int_t FirstBin, LastBin;
+    const TH1F *Source;
+    const vector<Double_t> *Edges;
+    const TAxis *Axis;
+    vector<Double_t> Counts;
+  };
+
+  void ProcessSpectrumConversionJob(SpectrumConversionJob *);
+
+  // A single spectrum and fit window to be fit during batch fitting
+  struct SpectrumFitJob{
+    string Name;
+    vector<Double_t> Centers, Contents;
+    Double_t BinWidth, Min, Max;
+    Int_t Bins;
+    SpectrumFitWindowStruct Window;
+    vector<SpectrumFitResultStruct> Results;
+  };
+
+  void ProcessSpectrumFitJobs(vector<SpectrumFitJob> *, Int_t, Int_t);
+  void WriteSpectrumFitResultsHeader(ofstream &, string);
+  void WriteSpectrumFitResult(ofstream &, SpectrumFitResultStruct &);
+
+  // The Y projection of a band of the PSD histogram X axis to be fit
+  // by a single thread during the figure-of-merit scan
+  struct PSDFOMJob{
+    Double_t Low, High;
+    vector<Double_t> Centers, Contents;
+    Double_t BinWidth;
+    Double_t FOM, FOMError;
+    Bool_t Valid;
+  };
+
+  void ProcessPSDFOMJobs(vector<PSDFOMJob> *, Int_t, Int_t);
+
+  // A single PSD histogram slice to be fit with the lower and upper
+  // Gaussians of the interactive figure-of-merit calculation
+  struct PSDSliceFitJob{
+    Int_t Request;
+    Int_t Axis, Bin;
+    vector<Double_t> Centers, Contents;
+    Double_t BinWidth;
+    SpectrumFitWindowStruct LowerWindow, UpperWindow;
+    SpectrumFitResultStruct Lower, Upper;
+    Double_t FOM;
+    Bool_t Valid;
+  };
+
+  void ProcessPSDSliceFitJob();
+  void StartPSDSliceFitThread();
+  static Bool_t ComparePSDWindowCandidates(const PSDWindowCandidateStruct &,
+					   const PSDWindowCandidateStruct &);
+
+  Double_t LocateGainReference(const vector<Double_t> &, const GainReferenceStruct &);
+  Bool_t GainDriftCorrectionValid(Int_t, AAPulseStore *);
+#endif
+
   AAParallelResults *ADAQParResults;
   Bool_t ADAQParResultsLoaded;
 
@@ -298,22 +507,83 @@ private:
   // Waveform analysis results
   Double_t WaveformAnalysisHeight, WaveformAnalysisArea;
 
+  // Waveform summary index, which holds one summary per TTree entry
+  // and is built once in a background thread with its own file handle
+  vector<WaveformSummaryStruct> WaveformIndex;
+  Bool_t WaveformIndexReady, WaveformIndexBuilding;
+
+#ifndef __CINT__
+  // The settings that the index values depend upon; the index is
+  // only used when these match the present settings
+  struct WaveformIndexKey{
+    string FileName;
+    Int_t Channel, Polarity, Floor;
+    Int_t BaselineRegionMin, BaselineRegionMax;
+    Int_t AnalysisRegionMin, AnalysisRegionMax;
+    Int_t PSDTotalStart, PSDTotalStop, PSDTailStart, PSDTailStop;
+  };
+
+  WaveformIndexKey CreateWaveformIndexKey();
+  Bool_t WaveformIndexKeyMatches(WaveformIndexKey &);
+  void BuildWaveformIndexWorker(WaveformIndexKey, vector<Int_t>, Bool_t);
+  Bool_t IndexedWaveformPassesPSD(WaveformSummaryStruct &);
+  
+  WaveformIndexKey WaveformIndexSettings;
+  boost::thread *WaveformIndexThread;
+  boost::mutex WaveformIndexMutex;
+  atomic<Bool_t> WaveformIndexCancelled;
+#endif
+  
   
   /////////////////////
   // Spectrum variables
 
   TH1F *Spectrum_H;
   TH1F *SpectrumDerivative_H;
+
+  // The exact spectrum counts; all spectrum fills are made into the
+  // accumulator, which is then copied into Spectrum_H for display
+  AAHistogramAccumulator SpectrumCounts; //!
   TGraph *SpectrumDerivative_G;
 
   TH1F *SpectrumBackground_H, *SpectrumDeconvolved_H;
+  AASpectrumBackground BackgroundEngine; //!
   TH1F *SpectrumIntegral_H;
   TF1 *SpectrumFit_F;
+
+  // The spectrum analysis products are tracked against a version of
+  // the spectrum that is incremented each time it is (re)created
+  vector<Double_t> GetSpectrumProductDependencies(Int_t);
+  SpectrumProductStruct SpectrumProducts[zNumSpectrumProducts]; //!
+  Int_t SpectrumVersion;
+
+  // The number of waveforms processed by the last spectrum run, which
+  // limits the values histogrammed for the SMS and WD algorithms, and
+  // whether the run was a preview, in which case the pulse stores
+  // hold the values in random cluster order rather than time order
+  Int_t ProcessedWaveforms;
+  Bool_t SpectrumPreviewOrder;
+
+  // Spectra created concurrently from multiple ASIM event trees
+  vector<TH1F *> ASIMSpectra_H;
+
+  // Spectra created from a single pass over the waveforms with each
+  // of a set of waveform extraction parameter variants, along with
+  // the processing time [s] attributed to each variant
+  vector<TH1F *> SettingsSweepSpectra_H;
+  vector<AAHistogramAccumulator *> SettingsSweepCounts; //!
+  vector<SettingsVariantStruct> SettingsSweep, SettingsSweepVariants;
+  vector<Double_t> SettingsSweepTimes;
+
+  // Spectrum converted from electron equivalent energy into the
+  // energy of the incident particle (proton, alpha, carbon)
+  TH1F *ConvertedSpectrum_H;
   TFitResultPtr SpectrumFit_FR;
   Double_t SpectrumIntegralValue, SpectrumIntegralError;
 
-  // Vectors used to store processed waveform values
-  vector<Double_t> SpectrumPHVec[MAX_DG_CHANNELS], SpectrumPAVec[MAX_DG_CHANNELS];
+  // Stores used to hold processed waveform values. See AAPulseStore
+  // for the available precision and spill-to-disk options
+  AAPulseStore SpectrumPHVec[MAX_DG_CHANNELS], SpectrumPAVec[MAX_DG_CHANNELS]; //!
 
   // Objects that are used in energy calibration of the pulse spectra
   vector<TGraph *>SpectraCalibrationData;
@@ -329,10 +599,21 @@ private:
   // PSD variables
 
   // Variables for PSD histograms and filter
-  TH2F *PSDHistogram_H, *MasterPSDHistogram_H;
+  TH2F *PSDHistogram_H;
+  TH2D *MasterPSDHistogram_H;
   TH1D *PSDHistogramSlice_H;
+
+  // The exact PSD histogram counts (see SpectrumCounts)
+  AAHistogramAccumulator PSDHistogramCounts; //!
+
+  // Figure-of-merit versus PSD histogram X axis (total or energy)
+  TGraphErrors *PSDFOMScan_GE;
+
+  // PSD integration windows ranked by figure-of-merit
+  PSDWindowScanStruct PSDWindowScan;
+  vector<PSDWindowCandidateStruct> PSDWindowCandidates;
   
-  vector<Double_t> PSDHistogramTotalVec[MAX_DG_CHANNELS], PSDHistogramTailVec[MAX_DG_CHANNELS];
+  AAPulseStore PSDHistogramTotalVec[MAX_DG_CHANNELS], PSDHistogramTailVec[MAX_DG_CHANNELS]; //!
   
   Double_t PSDRegionPolarity;
   vector<TCutG *> PSDRegions;
@@ -343,8 +624,9 @@ private:
   ///////////
   // Bool_Teans
   Bool_t SpectrumExists, SpectrumBackgroundExists, SpectrumDerivativeExists;
+  Bool_t ASIMSpectraExist, ConvertedSpectrumExists, SettingsSweepExists;
   Bool_t SpectrumFitExists;
-  Bool_t PSDHistogramExists, PSDHistogramSliceExists;
+  Bool_t PSDHistogramExists, PSDHistogramSliceExists, PSDFOMScanExists;
 
 
   ///////////
@@ -359,8 +641,8 @@ private:
   // Variables used to specify whether to print to stdout
   Bool_t Verbose;
 
-  // ROOT TH1F to hold aggregated spectra from parallel processing
-  TH1F *MasterHistogram_H;
+  // ROOT TH1D to hold aggregated spectra from parallel processing
+  TH1D *MasterHistogram_H;
 
   // Number of data channels in the ADAQ ROOT files
   Int_t NumDataChannels;
@@ -380,6 +662,120 @@ private:
   Bool_t CalibrationFound;
   Double_t CalibrationX, CalibrationY;
 
+  // Per-slice gain correction factors for the pulse store of a single
+  // channel and spectrum type, with each slice comprising a fixed
+  // number of consecutive pulse values in processing order
+  vector<Double_t> GainDriftCorrections;
+  vector<GainReferenceStruct> GainDriftReferences;
+  Int_t GainDriftSliceSize, GainDriftChannel, GainDriftNumValues;
+  Bool_t GainDriftPAS, GainDriftCorrectionExists;
+
+#ifndef __CINT__
+  // Processing kernels. The per-waveform processing methods are
+  // templated on a set of option bits that are constant for the
+  // duration of a processing job (calibration type, PSD and pileup
+  // filtering, spectrum type, etc) such that the compiler generates
+  // a separate, branch-free loop body for each combination. A kernel
+  // instantiation is selected once per job from the present settings
+  // and called through a member function pointer. Note that bits
+  // shared between kernels carry a kernel-specific meaning
+  enum{
+    zKernelFill = 1<<0,              // Fill spectrum or PSD histogram
+    zKernelCalibrationFit = 1<<1,    // Calibrate with the fit
+    zKernelCalibrationInterp = 1<<2, // Calibrate with the interpolation
+    zKernelPSDRegion = 1<<3,         // Apply the PSD filter
+    zKernelPileup = 1<<4,            // Peaks : apply pileup rejection
+    zKernelTailTotal = 1<<4,         // PSD : Y axis is tail/total
+    zKernelPAS = 1<<4,               // Pulse : spectrum is pulse area
+    zNumKernelOptions = 1<<5
+  };
+
+  typedef void (AAComputation::*PeakKernel)(Int_t);
+  typedef void (AAComputation::*PulseKernel)(Int_t, Double_t, Double_t);
+
+  template<Int_t> void IntegratePeaksKernel(Int_t);
+  template<Int_t> void FindPeakHeightsKernel(Int_t);
+  template<Int_t> void CalculatePSDIntegralsKernel(Int_t);
+  template<Int_t> void FillPulseKernel(Int_t, Double_t, Double_t);
+  template<Int_t> Double_t CalibrateKernel(Int_t, Double_t);
+
+  // Equivalent to TH1::Integral(First, Last) on the bin content array
+  static Double_t IntegrateBins(const Float_t *, Int_t, Int_t, Int_t);
+
+  // Each kernel family provides the instantiation for a set of options
+  struct IntegratePeaksKernels{
+    typedef PeakKernel Type;
+    template<Int_t O> static Type Get() {return &AAComputation::IntegratePeaksKernel<O>;}
+  };
+
+  struct FindPeakHeightsKernels{
+    typedef PeakKernel Type;
+    template<Int_t O> static Type Get() {return &AAComputation::FindPeakHeightsKernel<O>;}
+  };
+
+  struct CalculatePSDIntegralsKernels{
+    typedef PeakKernel Type;
+    template<Int_t O> static Type Get() {return &AAComputation::CalculatePSDIntegralsKernel<O>;}
+  };
+
+  struct FillPulseKernels{
+    typedef PulseKernel Type;
+    template<Int_t O> static Type Get() {return &AAComputation::FillPulseKernel<O>;}
+  };
+
+  // Maps run-time options onto the matching compile-time instantiation
+  template<class, Int_t> struct KernelSelector;
+  template<class Family> static typename Family::Type SelectKernel(Int_t);
+
+  Int_t GetCalibrationKernelOptions(Int_t);
+  Int_t GetPeakKernelOptions(Int_t, Bool_t);
+  Int_t GetPSDKernelOptions(Int_t, Bool_t);
+  Int_t GetPulseKernelOptions(Int_t);
+
+  PeakKernel IntegratePeaks_K, FindPeakHeights_K, CalculatePSDIntegrals_K; //!
+  PulseKernel FillPulse_K; //!
+
+  // Background processing thread. The job type, progress, and
+  // cancellation request are shared with the GUI thread via atomics;
+  // ProcessingInThread is only read by the worker during a job
+  void ProcessingThreadWorker(Int_t);
+  Bool_t ContinueProcessing(Long64_t);
+  
+  boost::thread *ProcessingThread; //!
+  atomic<Int_t> ProcessingJob; //!
+  atomic<Bool_t> ProcessingActive, ProcessingCancelled; //!
+  atomic<Long64_t> ProcessingDone, ProcessingTotal; //!
+  Bool_t ProcessingInThread;
+
+  // Set by the worker once the accumulators for the present job have
+  // been initialized and may be read by the GUI thread
+  atomic<Bool_t> ProcessingSnapshotReady; //!
+  TH1 *ProcessingSnapshot_H; //!
+
+  AAProcessingMetrics ProcessingMetrics; //!
+
+  // The contents (including underflow and overflow) of every X and Y
+  // slice of the PSD histogram, stored contiguously by slice bin
+  void CreatePSDSliceCache();
+  vector<Double_t> PSDXSliceCache, PSDYSliceCache;
+  Int_t PSDSliceAxis, PSDSliceBin;
+
+  // The slice fit being run by the thread, the latest request waiting
+  // for the thread, and the collected result of the latest request
+  boost::thread *PSDSliceFitThread; //!
+  atomic<Bool_t> PSDSliceFitDone; //!
+  PSDSliceFitJob ActivePSDSliceFit, QueuedPSDSliceFit, PSDSliceFit;
+  Bool_t PSDSliceFitQueued;
+  Int_t PSDSliceFitRequests;
+  
+  // Number of waveforms between checks for a cancellation request
+  static const Int_t ProcessingChunkSize = 1000;
+
+  // Order of the waveform tree entries for preview mode spectra
+  vector<Int_t> CreatePreviewOrder(Long64_t);
+  static const UInt_t PreviewSeed = 4357;
+#endif
+
   // Define the class to ROOT
   ClassDef(AAComputation, 1)
 };
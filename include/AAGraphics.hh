@@ -42,6 +42,8 @@
 #include <TBox.h>
 #include <TLine.h>
 #include <TColorWheel.h>
+#include <TF1.h>
+#include <TLegend.h>
 
 // AA
 #include "AAComputation.hh"
@@ -93,6 +95,10 @@ public:
   
   void PlotSpectrum();
   void PlotSpectrumDerivative();
+  void PlotASIMSpectra();
+  void PlotSettingsSweepSpectra();
+  void PlotSpectrumOverlay(vector<TH1F *>, string, string);
+  void PlotConvertedSpectrum();
 
   
   //////////////////////////////////////////////
@@ -100,11 +106,12 @@ public:
 
   void PlotPSDHistogram();
   void PlotPSDHistogramSlice(int, int);
+  void PlotPSDHistogramSliceFits();
+  void PlotPSDFOMScan();
+  void PlotProcessingSnapshot();
   void PlotPSDRegionProgress();
   void PlotPSDRegion();
   void ClosePSDSliceWindow();
- 
-  Double_t GetPSDFigureOfMerit() {return PSDFigureOfMerit;}
 
 
   ///////////////////////////////////////////
@@ -127,7 +134,14 @@ private:
   TCanvas *TheCanvas;
   AAInterface *TheInterface;
 
-  TH1F *Spectrum_H;
+  // Display copies of the computed spectra (see CopyForDisplay)
+  TH1F *Spectrum_H, *SpectrumBackground_H, *SpectrumOverplot_H;
+  void CopyForDisplay(const TH1F *, TH1F *&);
+
+  // The frame and legend of the spectrum overlay plots, which are
+  // replaced each time an overlay is drawn
+  TH1F *SpectrumOverlayFrame_H;
+  TLegend *SpectrumOverlay_L;
 
   // Objects for waveform analysis
 
@@ -148,6 +162,20 @@ private:
 
   // Objects for PSD analysis
   TGraph *PSDRegionProgress_G;
+
+  // Level-of-detail objects for drawing long waveforms and finely
+  // binned PSD histograms at the resolution of the canvas
+  Int_t GetCanvasPixelsX();
+  Int_t GetCanvasPixelsY();
+  void DecimateWaveform(TH1F *, Int_t, Int_t, Int_t);
+  TH2F *RebinForDisplay(TH2F *);
+  
+  TGraph *WaveformLOD_G;
+  TH2F *PSDHistogramLOD_H;
+
+  // Waveforms are decimated when the visible samples exceed this
+  // multiple of the canvas width in pixels
+  static const Int_t WaveformDecimationFactor = 2;
   
   AAComputation *ComputationMgr;
   
@@ -162,7 +190,8 @@ private:
 
   enum{zWaveformColor, zSpectrumLineColor, zSpectrumFillColor};
 
-  Double_t PSDFigureOfMerit;
+  // The Gaussians of the PSD histogram slice figure-of-merit fit
+  TF1 *PSDLowerFOMFit_F, *PSDUpperFOMFit_F;
 
   ClassDef(AAGraphics, 1)
 };
@@ -0,0 +1,140 @@
+/////////////////////////////////////////////////////////////////////////////////
+//                                                                             //
+//                            Copyright (C) 2012-2023                          //
+//                  Zachary Seth Hartwig : All rights reserved                 //
+//                                                                             //
+//      The ADAQAnalysis source code is licensed under the GNU GPL v3.0.       //
+//      You have the right to modify and/or redistribute this source code      //
+//      under the terms specified in the license, which is found online        //
+//      at http://www.gnu.org/licenses or at $ADAQANALYSIS/License.txt.        //
+//                                                                             //
+/////////////////////////////////////////////////////////////////////////////////
+
+/////////////////////////////////////////////////////////////////////////////////
+//
+// name: AAHistogramAccumulator.hh
+// date: 18 Oct 26
+// auth: Zach Hartwig
+// mail: hartwig@psfc.mit.edu
+//
+// desc: The AAHistogramAccumulator class accumulates counts into a
+//       1D or 2D histogram with fixed-width bins. Unlike the bins of
+//       a TH1F/TH2F, which silently stop incrementing once a bin
+//       exceeds 2^24 counts, the bins are 64-bit integers such that
+//       counts remain exact at any scale. Fills are lock-free atomic
+//       increments, so that a single accumulator may be filled
+//       concurrently from any number of threads. The bin layout
+//       (including underflow and overflow bins) and the bin lookup
+//       are identical to those of the ROOT histograms. The counts
+//       are converted into TH1D/TH2D objects for export or copied
+//       into existing histograms for display.
+//
+/////////////////////////////////////////////////////////////////////////////////
+
+#ifndef __AAHistogramAccumulator_hh__
+#define __AAHistogramAccumulator_hh__ 1
+
+// ROOT
+#include <Rtypes.h>
+#include <TH1.h>
+#include <TH1D.h>
+#include <TH2D.h>
+
+// C++
+#include <atomic>
+#include <string>
+using namespace std;
+
+class AAHistogramAccumulator
+{
+public:
+  AAHistogramAccumulator();
+  ~AAHistogramAccumulator();
+
+  // The bins are owned by the accumulator, which is not copyable
+  AAHistogramAccumulator(const AAHistogramAccumulator &) = delete;
+  AAHistogramAccumulator &operator=(const AAHistogramAccumulator &) = delete;
+
+  // Set the binning of a 1D (bins, min, max) or 2D (X bins, min,
+  // max, Y bins, min, max) histogram and zero all bins
+  void Initialize(Int_t, Double_t, Double_t);
+  void Initialize(Int_t, Double_t, Double_t, Int_t, Double_t, Double_t);
+
+  // Set the binning and counts from an existing TH1 or TH2
+  void Initialize(const TH1 *);
+
+  void Reset();
+
+  // Thread-safe fills with unit weight
+  void Fill(Double_t X)
+  { Increment(FindBin(X, NumBinsX, MinX, MaxX)); }
+
+  void Fill(Double_t X, Double_t Y)
+  { Increment(FindBin(X, NumBinsX, MinX, MaxX) +
+	      FindBin(Y, NumBinsY, MinY, MaxY) * (NumBinsX+2)); }
+
+  // Add counts to a global bin (e.g. when merging results); the
+  // number of entries is not modified
+  void AddBinContent(Int_t Bin, Long64_t Counts)
+  { Bins[Bin].fetch_add(Counts, memory_order_relaxed); }
+
+  void AddEntries(Long64_t E)
+  { Entries.fetch_add(E, memory_order_relaxed); }
+
+  // Add the counts and entries of an identically binned accumulator
+  void Add(const AAHistogramAccumulator &);
+
+  Long64_t GetBinContent(Int_t Bin) const
+  { return Bins[Bin].load(memory_order_relaxed); }
+
+  Long64_t GetBinContent(Int_t BinX, Int_t BinY) const
+  { return GetBinContent(BinX + BinY * (NumBinsX+2)); }
+
+  // The number of fills, matching TH1::GetEntries()
+  Long64_t GetEntries() const { return Entries.load(memory_order_relaxed); }
+
+  // Total number of bins including underflow and overflow bins
+  Int_t GetNcells() const { return NumCells; }
+  Int_t GetDimension() const { return Dimension; }
+
+  // Copy all bin contents (including underflow and overflow) into
+  // an array of GetNcells() values
+  void CopyTo(Double_t *) const;
+
+  // Create new TH1D/TH2D objects from the accumulated counts
+  TH1D *CreateTH1D(string, string) const;
+  TH2D *CreateTH2D(string, string) const;
+
+  // Set the bin contents and entries of an existing, identically
+  // binned histogram (e.g. a TH1F for display) from the counts
+  void CopyToHistogram(TH1 *) const;
+
+private:
+  // Identical to TAxis::FindBin() for fixed-width bins
+  static Int_t FindBin(Double_t V, Int_t N, Double_t Min, Double_t Max)
+  {
+    if(V < Min)
+      return 0;
+    else if(!(V < Max))
+      return N+1;
+    else
+      return 1 + Int_t(N * (V-Min) / (Max-Min));
+  }
+
+  void Increment(Int_t Bin)
+  {
+    Bins[Bin].fetch_add(1, memory_order_relaxed);
+    Entries.fetch_add(1, memory_order_relaxed);
+  }
+
+  void Allocate();
+
+  Int_t Dimension;
+  Int_t NumBinsX, NumBinsY, NumCells;
+  Double_t MinX, MaxX, MinY, MaxY;
+
+  atomic<Long64_t> *Bins;
+  atomic<Long64_t> Entries;
+};
+
+#endif
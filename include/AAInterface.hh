@@ -49,6 +49,8 @@
 #include <TRandom3.h>
 #include <TGMsgBox.h>
 #include <TGTab.h>
+#include <TGListBox.h>
+#include <TTimer.h>
 
 // C++
 #include <string>
@@ -107,6 +109,19 @@ public:
   void FillProcessingFrame();
   void FillCanvasFrame();
 
+  // Only the initially displayed options tab is filled with widgets
+  // at startup. The remaining tabs are filled when first selected or,
+  // since the slots and settings read widgets across all tabs, before
+  // a file is loaded or the widget values are saved
+  void FillOptionsTab(int);
+  void FillOptionsTabs();
+
+  // Record the time [ms] since program start at which a stage of the
+  // startup completed; the stages are printed by ReportStartupTimes()
+  // if the ADAQANALYSIS_TIMING environment variable is set
+  static void AddStartupTime(string);
+  void ReportStartupTimes();
+
   // Method to save all widget values in a storage class
   void SaveSettings(bool SaveToFile=false);
   
@@ -115,8 +130,18 @@ public:
   void UpdateForASIMFile();
   void UpdateForSpectrumCreation();
   void UpdateForPSDHistogramCreation();
+  void UpdateForPSDWindowOptimization();
+  void UpdateForSettingsSweep();
   void UpdateForPSDHistogramSlicingFinished();
 
+  // Methods to run a waveform processing job in the background
+  // thread and to update the interface once the job has finished
+  void StartProcessing(int);
+  void FinishProcessing();
+
+  // Method to show the rates and stage times of the processing loop
+  void UpdateProcessingMetrics();
+
   // Method to alert the user via a ROOT message box
   void CreateMessageBox(string, string);
 
@@ -209,6 +234,7 @@ private:
   ///////////////////////////////////////////
 
   ADAQNumberEntryWithLabel *WaveformsToHistogram_NEL;
+  TGCheckButton *SpectrumPreview_CB;
 
   ADAQNumberEntryWithLabel *SpectrumNumBins_NEL;
   ADAQNumberEntryWithLabel *SpectrumMinBin_NEL;
@@ -230,6 +256,8 @@ private:
   TGRadioButton *ASIMSpectrumTypePhotonsDetected_RB;
 
   TGComboBox *ASIMEventTree_CB;
+  TGListBox *ASIMEventTrees_LB;
+  TGTextButton *CreateASIMSpectra_TB;
   
   TGCheckButton *SpectrumCalibration_CB;
   TGRadioButton *SpectrumCalibrationManualSlider_RB;
@@ -249,6 +277,17 @@ private:
   TGTextButton *SpectrumCalibrationReset_TB;
   TGTextButton *SpectrumCalibrationLoad_TB;
 
+  static const Int_t NumGainDriftRefs = 2;
+  ADAQNumberEntryWithLabel *GainDriftSlices_NEL;
+  ADAQComboBoxWithLabel *GainDriftRefType_CBL[NumGainDriftRefs];
+  ADAQNumberEntryWithLabel *GainDriftRefMin_NEL[NumGainDriftRefs], *GainDriftRefMax_NEL[NumGainDriftRefs];
+  TGCheckButton *GainDriftApply_CB;
+  TGTextButton *GainDriftCompute_TB, *GainDriftSave_TB;
+
+  ADAQComboBoxWithLabel *SettingsSweepParameter_CBL;
+  ADAQNumberEntryWithLabel *SettingsSweepMin_NEL, *SettingsSweepMax_NEL, *SettingsSweepSteps_NEL;
+  TGTextButton *SettingsSweep_TB;
+
   TGTextButton *ProcessSpectrum_TB, *CreateSpectrum_TB;
 
 
@@ -301,6 +340,8 @@ private:
   ADAQNumberEntryWithLabel *EAErrorWidth_NEL;
   ADAQNumberEntryWithLabel *EAElectronEnergy_NEL, *EAGammaEnergy_NEL;
   ADAQNumberEntryWithLabel *EAProtonEnergy_NEL, *EAAlphaEnergy_NEL, *EACarbonEnergy_NEL;
+  ADAQComboBoxWithLabel *EAConvertType_CBL;
+  TGTextButton *EAConvertSpectrum_TB;
 
 
   //////////////////////////////////////
@@ -334,6 +375,15 @@ private:
   ADAQNumberEntryWithLabel *PSDLowerFOMFitMin_NEL, *PSDLowerFOMFitMax_NEL;
   ADAQNumberEntryWithLabel *PSDUpperFOMFitMin_NEL, *PSDUpperFOMFitMax_NEL;
   ADAQNumberEntryFieldWithLabel *PSDFigureOfMerit_NEFL;
+
+  ADAQNumberEntryWithLabel *PSDFOMScanBands_NEL;
+  ADAQNumberEntryWithLabel *PSDFOMScanMin_NEL, *PSDFOMScanMax_NEL;
+  TGTextButton *PSDFOMScan_TB;
+
+  ADAQNumberEntryWithLabel *PSDOptimizeTotalStopMin_NEL, *PSDOptimizeTotalStopMax_NEL, *PSDOptimizeTotalStopSteps_NEL;
+  ADAQNumberEntryWithLabel *PSDOptimizeTailStartMin_NEL, *PSDOptimizeTailStartMax_NEL, *PSDOptimizeTailStartSteps_NEL;
+  ADAQNumberEntryWithLabel *PSDOptimizeBandMin_NEL, *PSDOptimizeBandMax_NEL;
+  TGTextButton *PSDOptimizeWindows_TB;
   
   
   ///////////////////////////////////////////
@@ -386,6 +436,15 @@ private:
   TGRadioButton *ProcessingSeq_RB, *ProcessingPar_RB;
   ADAQNumberEntryWithLabel *NumProcessors_NEL;
   ADAQNumberEntryWithLabel *UpdateFreq_NEL;
+  ADAQComboBoxWithLabel *PulseStorePrecision_CBL;
+  TGCheckButton *PulseStoreSpillToDisk_CB;
+  ADAQComboBoxWithLabel *ProgressiveDisplay_CBL;
+  ADAQNumberEntryWithLabel *ProgressiveDisplayInterval_NEL;
+
+  ADAQNumberEntryFieldWithLabel *ProcessingWaveformRate_NEFL;
+  ADAQNumberEntryFieldWithLabel *ProcessingPulseRate_NEFL;
+  ADAQNumberEntryFieldWithLabel *ProcessingDataRead_NEFL;
+  ADAQNumberEntryFieldWithLabel *ProcessingStageShare_NEFL[zNumProcessingStages];
 
   TGTextButton *DesplicedFileSelection_TB;
   TGTextEntry *DesplicedFileName_TE;
@@ -421,6 +480,15 @@ private:
   // A progress bar! Hot stuff.
   TGHProgressBar *ProcessingProgress_PB;
 
+  // Widget to cancel background waveform processing
+  TGTextButton *CancelProcessing_TB;
+
+  // Timer to poll the background processing thread
+  TTimer *ProcessingTimer;
+
+  // Timer to poll the PSD histogram slice fitting thread
+  TTimer *PSDSliceFitTimer;
+
   // Widget for quiting the GUI
   TGTextButton *Quit_TB;
 
@@ -450,6 +518,13 @@ private:
 
   Bool_t EnableInterface;
 
+  Bool_t OptionsTabFilled[zNumOptionsTabs];
+  Bool_t StartupReported;
+
+  // Waveforms processed and time [ms] at the last drawing of the
+  // partially accumulated spectrum or PSD histogram
+  Long64_t SnapshotWaveforms, SnapshotTime;
+
   // The class which holds all ROOT widget settings
   AASettings *ADAQSettings;
   string ADAQSettingsFileName;
@@ -24,7 +24,11 @@
 //       response functions for EJ301/BC501A/NE213 is implemented;
 //       future work will incorporate multiple response functions and
 //       multiple scintillators for a more thorough set of analysis
-//       tools.
+//       tools. The response and inverse response functions are
+//       stored as precomputed monotone cubic lookup tables that are
+//       rebuilt only when the light conversion factor changes such
+//       that single and batch (array, histogram bin edge)
+//       conversions are fast.
 //
 /////////////////////////////////////////////////////////////////////////////////
 
@@ -35,9 +39,14 @@
 #include <TROOT.h>
 #include <TObject.h>
 #include <TGraph.h>
+#include <TH1.h>
 
 // C++
 #include <vector>
+using namespace std;
+
+// ADAQAnalysis
+#include "AATypes.hh"
 
 class AAInterpolation : public TObject
 {
@@ -47,12 +56,15 @@ public:
 
   static AAInterpolation *GetInstance();
 
-  // Method to construct particle-dependent light responses
+  // Method to construct particle-dependent light responses. The
+  // responses are constructed upon the first conversion rather than
+  // at startup since most sessions never convert energies
   void ConstructResponses();
   
   // Set/get methods for member data
 
-  void SetConversionFactor(double CF) {ConversionFactor = CF;}
+  // Setting a new conversion factor rebuilds the responses
+  void SetConversionFactor(double);
   double GetConversionFactor() {return ConversionFactor;}
 
   double GetElectronEnergy(double, int);
@@ -60,11 +72,17 @@ public:
   double GetProtonEnergy(double);
   double GetAlphaEnergy(double);
   double GetCarbonEnergy(double);
+
+  // Batch methods to convert electron equivalent energies into the
+  // energy type specified by the EnergyConversionType enumerator
+  void ConvertEnergies(const double *, double *, int, int);
+  vector<double> ConvertEnergies(const vector<double> &, int);
+  vector<double> ConvertBinEdges(TH1 *, int);
   
-  TGraph *GetElectronResponse() {return Response[ELECTRON];}
-  TGraph *GetProtonResponse() {return Response[PROTON];}
-  TGraph *GetAlphaResponse() {return Response[ALPHA];}
-  TGraph *GetCarbonResponse() {return Response[CARBON];}
+  TGraph *GetElectronResponse() {CheckResponses(); return Response[ELECTRON];}
+  TGraph *GetProtonResponse() {CheckResponses(); return Response[PROTON];}
+  TGraph *GetAlphaResponse() {CheckResponses(); return Response[ALPHA];}
+  TGraph *GetCarbonResponse() {CheckResponses(); return Response[CARBON];}
   
 private:
   const double m_e, MeV2GeV;
@@ -74,10 +92,26 @@ private:
 
   double ConversionFactor;
 
+  bool ResponsesConstructed;
+  void CheckResponses() {if(!ResponsesConstructed) ConstructResponses();}
+
   vector<const double *> Data;
   vector< vector<double> > Light;
   vector<TGraph *> Response, Inverse;
 
+  // A monotone piecewise cubic (Fritsch-Carlson) lookup table. The
+  // slopes at each knot are computed once at construction such that
+  // each evaluation requires only a (hinted) search and a cubic
+  struct ResponseTable{
+    vector<double> X, Y, M;
+    void Construct(int, const double *, const double *);
+    double Eval(double, int &) const;
+  };
+
+  vector<ResponseTable> ResponseTables, InverseTables;
+
+  double ConvertEnergy(double, int, int &, int &);
+
   static AAInterpolation *TheInterpolationManager;
 };
   
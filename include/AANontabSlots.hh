@@ -42,10 +42,15 @@ public:
   ~AANontabSlots();
 
   // "Slot" methods to recieve and act upon ROOT widget "signals"
+  void HandleCancelProcessing();
   void HandleCanvas(int, int, int, TObject *);
   void HandleDoubleSliders();
   void HandleMenu(int);
+  void HandleOptionsTabs(int);
+  void HandleProcessingTimer();
+  void HandlePSDSliceFitTimer();
   void HandleSliders(int);
+  void HandleStartupTimer();
   void HandleTerminate();
   void HandleTripleSliderPointer();
 
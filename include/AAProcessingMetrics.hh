@@ -0,0 +1,137 @@
+/////////////////////////////////////////////////////////////////////////////////
+//                                                                             //
+//                            Copyright (C) 2012-2023                          //
+//                  Zachary Seth Hartwig : All rights reserved                 //
+//                                                                             //
+//      The ADAQAnalysis source code is licensed under the GNU GPL v3.0.       //
+//      You have the right to modify and/or redistribute this source code      //
+//      under the terms specified in the license, which is found online        //
+//      at http://www.gnu.org/licenses or at $ADAQANALYSIS/License.txt.        //
+//                                                                             //
+/////////////////////////////////////////////////////////////////////////////////
+
+/////////////////////////////////////////////////////////////////////////////////
+//
+// name: AAProcessingMetrics.hh
+// date: 18 Oct 26
+// auth: Zach Hartwig
+// mail: hartwig@psfc.mit.edu
+//
+// desc: The AAProcessingMetrics class measures where the time of the
+//       waveform processing loop is spent. The loop marks each
+//       transition between stages (see ProcessingStageType) and the
+//       time elapsed since the previous transition is charged to the
+//       stage that was running, such that the stage times are
+//       exclusive and sum to the total processing time. Nested
+//       stages (e.g. the calibration within a histogram fill) are
+//       handled by restoring the stage returned by Switch(). The
+//       number of waveforms, pulses, and bytes read are counted
+//       alongside. All values are written by the single processing
+//       thread and may be read at any time from the GUI thread. When
+//       no processing is active every call returns immediately.
+//
+/////////////////////////////////////////////////////////////////////////////////
+
+#ifndef __AAProcessingMetrics_hh__
+#define __AAProcessingMetrics_hh__ 1
+
+// ROOT
+#include <Rtypes.h>
+
+// C++
+#include <atomic>
+#include <chrono>
+#include <string>
+using namespace std;
+
+// ADAQAnalysis
+#include "AATypes.hh"
+
+class AAProcessingMetrics
+{
+public:
+  AAProcessingMetrics();
+  ~AAProcessingMetrics();
+
+  // Zero all values and begin (or end) timing a processing job
+  void Start();
+  void Stop();
+
+  Bool_t GetActive() const {return Active.load(memory_order_relaxed);}
+
+  // Charge the time since the last transition to the running stage
+  // and begin the specified stage. The previously running stage is
+  // returned such that nested stages may restore it when finished
+  Int_t Switch(Int_t Stage)
+  {
+    if(!Active.load(memory_order_relaxed))
+      return Stage;
+
+    Long64_t Now = GetTime();
+    Add(StageTimes[Current], Now - LastTime);
+    LastTime = Now;
+
+    Int_t Previous = Current;
+    Current = Stage;
+    return Previous;
+  }
+
+  void AddWaveform(Long64_t B)
+  {
+    if(!Active.load(memory_order_relaxed))
+      return;
+    Add(Waveforms, 1);
+    Add(Bytes, B);
+  }
+
+  void AddPulses(Long64_t P)
+  {
+    if(!Active.load(memory_order_relaxed))
+      return;
+    Add(Pulses, P);
+  }
+
+  Long64_t GetWaveforms() const {return Waveforms.load(memory_order_relaxed);}
+  Long64_t GetPulses() const {return Pulses.load(memory_order_relaxed);}
+  Long64_t GetBytes() const {return Bytes.load(memory_order_relaxed);}
+
+  // Elapsed time [s] of the present (or the last) processing job
+  Double_t GetElapsed() const;
+
+  Double_t GetWaveformRate() const;
+  Double_t GetPulseRate() const;
+
+  // The time [s] and fractional share of the total time spent in
+  // the stages that have been charged so far
+  Double_t GetStageTime(Int_t) const;
+  Double_t GetStageShare(Int_t) const;
+
+  static string GetStageName(Int_t);
+
+  // A multi-line summary of the rates and stage times for printing
+  string GetSummary() const;
+
+private:
+  // Steady clock time in nanoseconds
+  static Long64_t GetTime()
+  {
+    return chrono::duration_cast<chrono::nanoseconds>
+      (chrono::steady_clock::now().time_since_epoch()).count();
+  }
+
+  // Values have a single writer so that a relaxed load and store
+  // avoids the cost of an atomic read-modify-write
+  static void Add(atomic<Long64_t> &Value, Long64_t Increment)
+  { Value.store(Value.load(memory_order_relaxed) + Increment, memory_order_relaxed); }
+
+  atomic<Bool_t> Active;
+  atomic<Long64_t> StartTime, StopTime;
+  atomic<Long64_t> StageTimes[zNumProcessingStages];
+  atomic<Long64_t> Waveforms, Pulses, Bytes;
+
+  // Only accessed by the processing thread
+  Long64_t LastTime;
+  Int_t Current;
+};
+
+#endif
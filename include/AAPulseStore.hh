@@ -0,0 +1,118 @@
+/////////////////////////////////////////////////////////////////////////////////
+//                                                                             //
+//                            Copyright (C) 2012-2023                          //
+//                  Zachary Seth Hartwig : All rights reserved                 //
+//                                                                             //
+//      The ADAQAnalysis source code is licensed under the GNU GPL v3.0.       //
+//      You have the right to modify and/or redistribute this source code      //
+//      under the terms specified in the license, which is found online        //
+//      at http://www.gnu.org/licenses or at $ADAQANALYSIS/License.txt.        //
+//                                                                             //
+/////////////////////////////////////////////////////////////////////////////////
+
+/////////////////////////////////////////////////////////////////////////////////
+//
+// name: AAPulseStore.hh
+// date: 18 Oct 26
+// auth: Zach Hartwig
+// mail: hartwig@psfc.mit.edu
+//
+// desc: The AAPulseStore class provides bounded-memory storage for
+//       the per-pulse values (pulse heights, areas, PSD integrals)
+//       that are computed during waveform processing and later
+//       histogrammed. Values are stored in fixed-size chunks (rather
+//       than a single vector that doubles its allocation as it
+//       grows) at a selectable precision: double (64-bit, the
+//       default, which reproduces the values exactly), or the lossy
+//       opt-in float (32-bit) or quantized (16-bit with a per-chunk
+//       range) precisions that reduce the memory footprint. Full
+//       chunks may optionally be spilled to a temporary backing file
+//       on disk such that only the chunk being filled and a single
+//       cached chunk for reading are held in memory.
+//
+/////////////////////////////////////////////////////////////////////////////////
+
+#ifndef __AAPulseStore_hh__
+#define __AAPulseStore_hh__ 1
+
+// ROOT
+#include <Rtypes.h>
+
+// C++
+#include <vector>
+#include <cstdio>
+#include <mutex>
+using namespace std;
+
+// ADAQAnalysis
+#include "AATypes.hh"
+
+class AAPulseStore
+{
+public:
+  AAPulseStore();
+  ~AAPulseStore();
+
+  // Clear the store and set the storage options; the options may
+  // only be changed when the store is (re)initialized
+  void Initialize(Int_t, Bool_t);
+
+  void clear();
+  void push_back(Double_t);
+
+  size_t size() const { return NumValues; }
+  Bool_t empty() const { return (NumValues == 0); }
+
+  // Access to stored values. Sequential access is efficient since a
+  // full chunk is decoded into a cache upon first access. The cache
+  // is guarded such that several threads (e.g. the GUI and the
+  // background processing thread) may read the store concurrently
+  Double_t At(size_t) const;
+  Double_t operator[](size_t Index) const { return At(Index); }
+  void CopyTo(Double_t *) const;
+
+  Int_t GetPrecision() { return Precision; }
+  Bool_t GetSpillToDisk() { return SpillToDisk; }
+
+  // Number of bytes presently held in memory
+  size_t GetMemoryUsage();
+
+private:
+  // Each chunk stores a fixed number of values in encoded form
+  struct PulseChunk{
+    size_t Size;
+    Double_t Minimum, Step;
+    vector<char> Data;
+    Bool_t Spilled;
+    long Offset;
+  };
+
+  void SealChunk();
+
+  // Must be called with the cache mutex locked
+  void LoadChunk(size_t) const;
+  Double_t AtLocked(size_t) const;
+
+  Int_t Precision;
+  Bool_t SpillToDisk;
+
+  size_t NumValues;
+  const size_t ChunkSize;
+
+  // The values of the chunk being filled are held at full precision
+  // until the chunk is full, at which point it is encoded ("sealed")
+  vector<Double_t> OpenChunk;
+  vector<PulseChunk> Chunks;
+
+  // Decoded values of the most recently accessed sealed chunk
+  mutable vector<Double_t> Cache;
+  mutable Int_t CacheChunk;
+
+  // Temporary backing file used when spilling to disk; reads from
+  // the file share the file position and are guarded by the mutex
+  FILE *SpillFile;
+
+  mutable mutex CacheMutex;
+};
+
+#endif
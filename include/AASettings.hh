@@ -60,6 +60,7 @@ public:
   ////////////////////
 
   Int_t WaveformsToHistogram;
+  Bool_t SpectrumPreview;
   Int_t SpectrumNumBins;
   Double_t SpectrumMinBin, SpectrumMaxBin;
   Double_t SpectrumMinThresh, SpectrumMaxThresh;
@@ -78,6 +79,9 @@ public:
   vector<TGraph *> SpectraCalibrationData;
   vector<TF1 *> SpectraCalibrations;
   vector<bool> UseSpectraCalibrations;
+
+  Bool_t UseGainDriftCorrection;
+  Int_t GainDriftSlices;
   
   
   ////////////////////
@@ -155,6 +159,10 @@ public:
 
   Bool_t SeqProcessing, ParProcessing;
   Int_t NumProcessors, UpdateFreq;
+  Int_t PulseStorePrecision;
+  Bool_t PulseStoreSpillToDisk;
+  Int_t ProgressiveDisplayMode;
+  Double_t ProgressiveDisplayInterval;
   
   Int_t WaveformsToDesplice, DesplicedWaveformBuffer, DesplicedWaveformLength;
   string DesplicedFileName;
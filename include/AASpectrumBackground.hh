@@ -0,0 +1,92 @@
+/////////////////////////////////////////////////////////////////////////////////
+//                                                                             //
+//                            Copyright (C) 2012-2023                          //
+//                  Zachary Seth Hartwig : All rights reserved                 //
+//                                                                             //
+//      The ADAQAnalysis source code is licensed under the GNU GPL v3.0.       //
+//      You have the right to modify and/or redistribute this source code      //
+//      under the terms specified in the license, which is found online        //
+//      at http://www.gnu.org/licenses or at $ADAQANALYSIS/License.txt.        //
+//                                                                             //
+/////////////////////////////////////////////////////////////////////////////////
+
+/////////////////////////////////////////////////////////////////////////////////
+//
+// name: AASpectrumBackground.hh
+// date: 18 Oct 26
+// auth: Zach Hartwig
+// mail: hartwig@psfc.mit.edu
+//
+// desc: The AASpectrumBackground class is a native implementation of
+//       the Sensitive Nonlinear Iterative Peak (SNIP) clipping
+//       algorithm used to estimate spectrum backgrounds. It provides
+//       the same options as TSpectrum::Background (iterations,
+//       window direction, filter order, smoothing, smoothing width,
+//       and Compton edge estimation) and produces the same result,
+//       but operates on a plain array of bin contents. The clipping
+//       passes are cached such that changing only the iteration count
+//       or Compton estimation reuses prior work rather than
+//       recomputing the background from scratch, and window averages
+//       required for smoothing are computed from running sums such
+//       that each pass scales linearly with the number of bins.
+//
+/////////////////////////////////////////////////////////////////////////////////
+
+#ifndef __AASpectrumBackground_hh__
+#define __AASpectrumBackground_hh__ 1
+
+// ROOT
+#include <Rtypes.h>
+
+// C++
+#include <vector>
+using namespace std;
+
+class AASpectrumBackground
+{
+public:
+  AASpectrumBackground();
+  ~AASpectrumBackground();
+
+  // Set the bin contents of the spectrum; the cached clipping passes
+  // are only discarded if the contents have actually changed
+  void SetSpectrum(const Double_t *, Int_t);
+
+  // Set the direction (0 = increasing window, 1 = decreasing
+  // window), filter order (2, 4, 6, 8), smoothing, and smoothing
+  // width (3, 5, ... 15). Cached passes are discarded upon change
+  void SetOptions(Int_t, Int_t, Bool_t, Int_t);
+
+  // Calculate the background for the specified number of iterations,
+  // optionally with Compton edge estimation. The returned background
+  // has the same number of bins as the spectrum
+  const vector<Double_t> &Calculate(Int_t, Bool_t);
+
+  void Reset();
+
+private:
+  void ClipPass(const vector<Double_t> &, vector<Double_t> &, Int_t);
+  void ComputeAverages(const vector<Double_t> &);
+  void EstimateCompton(vector<Double_t> &);
+
+  vector<Double_t> Source;
+  Int_t Direction, FilterOrder, SmoothingWidth;
+  Bool_t Smoothing;
+
+  // For the increasing window direction the clipped spectrum after
+  // any number of passes is independent of the total iterations.
+  // The most recent state and periodic checkpoints are retained
+  vector<Double_t> Clipped;
+  Int_t Passes;
+  vector< vector<Double_t> > Checkpoints;
+  const Int_t CheckpointInterval;
+
+  // For the decreasing window direction each iteration count yields
+  // a distinct sequence of passes so only the last result is cached
+  vector<Double_t> DecreasingResult;
+  Int_t DecreasingIterations;
+
+  vector<Double_t> Work, Average, RunningSum, Result;
+};
+
+#endif
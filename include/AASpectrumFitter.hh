@@ -0,0 +1,93 @@
+/////////////////////////////////////////////////////////////////////////////////
+//                                                                             //
+//                            Copyright (C) 2012-2023                          //
+//                  Zachary Seth Hartwig : All rights reserved                 //
+//                                                                             //
+//      The ADAQAnalysis source code is licensed under the GNU GPL v3.0.       //
+//      You have the right to modify and/or redistribute this source code      //
+//      under the terms specified in the license, which is found online        //
+//      at http://www.gnu.org/licenses or at $ADAQANALYSIS/License.txt.        //
+//                                                                             //
+/////////////////////////////////////////////////////////////////////////////////
+
+/////////////////////////////////////////////////////////////////////////////////
+//
+// name: AASpectrumFitter.hh
+// date: 18 Oct 26
+// auth: Zach Hartwig
+// mail: hartwig@psfc.mit.edu
+//
+// desc: The AASpectrumFitter class performs least-squares fits of one
+//       or more Gaussian peaks plus an optional linear or step
+//       background to a region of a spectrum. The fit is a
+//       Levenberg-Marquardt minimization of the chi-square (with
+//       Neyman weights and empty bins excluded as in TH1::Fit) using
+//       analytic derivatives of the model. The class operates only on
+//       plain arrays and holds no ROOT objects such that independent
+//       instances may be safely used concurrently from multiple
+//       threads during batch fitting.
+//
+/////////////////////////////////////////////////////////////////////////////////
+
+#ifndef __AASpectrumFitter_hh__
+#define __AASpectrumFitter_hh__ 1
+
+// ROOT
+#include <Rtypes.h>
+
+// C++
+#include <vector>
+using namespace std;
+
+// ADAQAnalysis
+#include "AATypes.hh"
+
+class AASpectrumFitter
+{
+public:
+  AASpectrumFitter();
+  ~AASpectrumFitter();
+
+  // Fit the specified window of a spectrum given its bin centers
+  // and contents. One result is returned for each Gaussian peak
+  vector<SpectrumFitResultStruct> Fit(const vector<Double_t> &,
+				      const vector<Double_t> &,
+				      Double_t,
+				      const SpectrumFitWindowStruct &);
+
+  void SetMaxIterations(Int_t MI) {MaxIterations = MI;}
+
+  // Set whether the peak integrals are in counts (default) or are
+  // multiplied by the bin width as with the TH1::Integral() "width"
+  // option used by AAComputation::FitSpectrum()
+  void SetIntegralInCounts(Bool_t IIC) {IntegralInCounts = IIC;}
+
+  // Set the initial mean and sigma of each peak; if the number of
+  // seeds does not match the number of peaks in the fit window, the
+  // peaks are seeded from the maximum of equal subranges of the window
+  void SetSeeds(const vector<Double_t> &M, const vector<Double_t> &S)
+  {SeedMeans = M; SeedSigmas = S;}
+  void ClearSeeds() {SeedMeans.clear(); SeedSigmas.clear();}
+
+private:
+  void Initialize(const SpectrumFitWindowStruct &);
+  Double_t Evaluate(Double_t, const vector<Double_t> &, vector<Double_t> *);
+  Double_t ChiSquare(const vector<Double_t> &);
+  Bool_t Solve(vector<Double_t> &, vector<Double_t> &, Int_t);
+  Bool_t Invert(vector<Double_t> &, Int_t);
+
+  Int_t MaxIterations;
+  Bool_t IntegralInCounts;
+
+  // The bins within the fit window with nonzero content
+  vector<Double_t> X, Y, W;
+  Double_t XCenter;
+
+  Int_t NumPeaks, Background;
+  Int_t NumBackgroundPars, NumPeakPars, NumPars;
+  vector<Double_t> Pars;
+
+  vector<Double_t> SeedMeans, SeedSigmas;
+};
+
+#endif
@@ -29,9 +29,11 @@
 #define __AATypes_hh__ 1
 
 #include <TGraph.h>
+#include <TTree.h>
 
 #include <vector>
 #include <string>
+#include <algorithm>
 using namespace std;
 
 
@@ -66,6 +68,100 @@ struct PeakInfoStruct{
 };
 
 
+// Structure that contains the summary information for a single
+// waveform (i.e. a single TTree entry) on the analysis channel. One
+// structure is created per entry when the waveform index is built
+// and is used to quickly locate waveforms that satisfy a selection
+// criterion without recomputing each waveform. Values are stored as
+// floats to keep the index compact for files with many entries
+struct WaveformSummaryStruct{
+  float MaxHeight; // Maximum baseline-subtracted height [ADC]
+  float Area; // Sum of the baseline-subtracted waveform [ADC]
+  float PSDTotal; // PSD total integral about the peak [ADC]
+  float PSDTail; // PSD tail integral about the peak [ADC]
+  unsigned short NumPeaks; // Number of low-2-high floor crossings
+  unsigned short TriggeredChannels; // Bit mask of channels that crossed their trigger
+  bool InAnalysisRegion; // Flag to indicate the peak lies within the analysis region
+
+  // Initialization for the variables
+  WaveformSummaryStruct() : MaxHeight(0.),
+			    Area(0.),
+			    PSDTotal(0.),
+			    PSDTail(0.),
+			    NumPeaks(0),
+			    TriggeredChannels(0),
+			    InAnalysisRegion(false)
+  {}
+};
+
+
+// Structure that contains the catalog information for a single ASIM
+// event tree. The catalog is built from the TKeys of the ASIM files
+// without reading the TTree objects themselves; the TTree is only
+// read from file (and its pointer stored) when it is first needed
+struct ASIMEventTreeInfo{
+  string Name; // Name of the event tree presented to the user
+  string KeyName; // Name of the TKey within the ASIM file
+  int FileIndex; // Index of the ASIM file containing the event tree
+  TTree *Tree; // Pointer to the event tree once it has been read
+
+  // Initialization for the variables
+  ASIMEventTreeInfo() : Name(""),
+			KeyName(""),
+			FileIndex(-1),
+			Tree(NULL)
+  {}
+};
+
+
+// Structure that contains a copy of a single channel's energy
+// calibration, i.e. either the polynomial coefficients of the
+// calibration fit or the sorted points of the linear interpolation,
+// that can be evaluated without the TF1/TGraph objects. This avoids
+// the overhead of TF1::Eval() per pulse and enables evaluation of
+// the calibration from multiple threads
+struct CalibrationLookupStruct{
+  bool Active; // Flag to indicate whether the calibration should be applied
+  bool Interpolate; // Flag to indicate linear interpolation rather than polynomial
+  vector<double> Coefficients; // Polynomial coefficients in increasing order
+  vector<double> X, Y; // Interpolation points sorted in increasing X
+
+  // Initialization for the variables
+  CalibrationLookupStruct() : Active(false),
+			      Interpolate(false)
+  {}
+
+  // Evaluate the calibration in the same manner as TF1::Eval() for
+  // "polN" functions and TGraph::Eval() for linear interpolation
+  // (including linear extrapolation beyond the outermost points)
+  double Eval(double Value) const {
+    if(!Active)
+      return Value;
+    
+    if(!Interpolate){
+      double Result = 0.;
+      for(int i=Coefficients.size()-1; i>=0; i--)
+	Result = Result*Value + Coefficients[i];
+      return Result;
+    }
+
+    int N = X.size();
+    if(N == 0)
+      return 0.;
+    else if(N == 1)
+      return Y[0];
+
+    int Low = upper_bound(X.begin(), X.end(), Value) - X.begin() - 1;
+    if(Low < 0)
+      Low = 0;
+    else if(Low > N-2)
+      Low = N-2;
+
+    return Y[Low] + (Value-X[Low]) * (Y[Low+1]-Y[Low]) / (X[Low+1]-X[Low]);
+  }
+};
+
+
 // Structure that contains information on a single calibration point
 // for a single channel. For each calibration point, a structure is
 // filled with the relevant information and pushed back into a vector
@@ -77,6 +173,94 @@ struct ADAQChannelCalibrationData{
 };
 
 
+// The grid of PSD integration windows (in samples relative to the
+// peak position) evaluated during PSD window optimization. The total
+// window start is fixed and the tail window stop is tied to the total
+// window stop while the total window stop and the tail window start
+// are each scanned over evenly spaced values. The figure-of-merit is
+// evaluated within the specified band of the PSD total integral
+struct PSDWindowScanStruct{
+  int TotalStart;
+  int TotalStopMin, TotalStopMax, TotalStopSteps;
+  int TailStartMin, TailStartMax, TailStartSteps;
+  double BandMin, BandMax;
+};
+
+
+// A single candidate set of PSD integration windows and its
+// figure-of-merit resulting from PSD window optimization
+struct PSDWindowCandidateStruct{
+  int TotalStart, TotalStop, TailStart, TailStop;
+  double FOM, FOMError;
+  bool Valid;
+};
+
+
+// A spectrum feature (full-energy peak or Compton edge) within a
+// window of uncalibrated pulse units [ADC] that is tracked across
+// slices of a run in order to correct for detector gain drift
+struct GainReferenceStruct{
+  double Min, Max;
+  bool Edge;
+};
+
+
+// A set of waveform extraction parameters evaluated during a settings
+// sweep. Each variant produces its own spectrum while all remaining
+// settings are taken from the present analysis settings
+struct SettingsVariantStruct{
+  int Floor, Sigma;
+  double Resolution;
+  int BaselineRegionMin, BaselineRegionMax;
+  int AnalysisRegionMin, AnalysisRegionMax;
+};
+
+
+// The state of a lazily computed spectrum analysis product: the
+// values of the settings (and the versions of the spectrum and any
+// upstream products) from which it was last computed, and a version
+// that is incremented each time the product is recomputed
+struct SpectrumProductStruct{
+  vector<double> Dependencies;
+  int Version;
+  bool Valid;
+};
+
+
+// A spectrum region to be fit during batch spectrum fitting with a
+// specified number of Gaussian peaks and background model
+struct SpectrumFitWindowStruct{
+  double Min, Max;
+  int NumPeaks;
+  int Background;
+};
+
+
+// The result of fitting a single Gaussian peak in a spectrum. The
+// covariance and correlation matrices are for the (constant, mean,
+// sigma) parameters of the peak
+struct SpectrumFitResultStruct{
+  string SpectrumName;
+  double SpectrumMin, SpectrumMax, BinWidth;
+  int SpectrumBins;
+
+  double WindowMin, WindowMax;
+  int Peak, NumPeaks;
+
+  double Const, ConstErr;
+  double Mean, MeanErr;
+  double Sigma, SigmaErr;
+  double Res, ResErr;
+  double CovConstSigma;
+  double Cov[3][3], Cor[3][3];
+  
+  double Integral, IntegralErr;
+  double ChiSquare;
+  int NDF;
+  bool Converged;
+};
+
+
 /////////////////
 // Enumerators //
 /////////////////
@@ -87,6 +271,48 @@ enum CanvasContentTypes{zEmpty, zWaveform, zSpectrum, zSpectrumDerivative, zPSDH
 
 enum PeakFindingAlgorithm{zPeakFinder, zWholeWaveform};
 
+// An enumerator that specifies the precision at which per-pulse
+// values are stored during waveform processing
+enum PulseStorePrecision{zPulseStoreDouble, zPulseStoreFloat, zPulseStoreQuantized};
+
+// An enumerator that specifies the background model used for
+// batch spectrum fitting
+enum SpectrumFitBackground{zNoFitBackground, zLinearFitBackground, zStepFitBackground};
+
+// An enumerator that specifies the particle energy into which
+// electron equivalent energies are converted by AAInterpolation
+enum EnergyConversionType{zGammaEnergy, zProtonEnergy, zAlphaEnergy, zCarbonEnergy};
+
+// An enumerator that specifies the waveform processing job run by
+// the background processing thread
+enum ProcessingJobType{zNoProcessingJob, zSpectrumProcessingJob,
+		       zPSDHistogramProcessingJob, zDesplicingProcessingJob,
+		       zPSDWindowOptimizationJob, zSettingsSweepJob};
+
+// An enumerator that specifies the spectrum analysis products that
+// are computed on demand from the spectrum (see SpectrumProductStruct)
+enum SpectrumProductType{zSpectrumBackgroundProduct, zSpectrumIntegralProduct,
+			 zSpectrumDerivativeProduct, zNumSpectrumProducts};
+
+// An enumerator that specifies the interval at which the partially
+// accumulated spectrum or PSD histogram is drawn during processing
+enum ProgressiveDisplayMode{zProgressiveDisplayOff, zProgressiveDisplayWaveforms,
+			    zProgressiveDisplaySeconds};
+
+// An enumerator that specifies the options tabs in the order in which
+// they appear in the interface
+enum OptionsTabType{zWaveformTab, zSpectrumTab, zAnalysisTab, zPSDTab,
+		    zGraphicsTab, zProcessingTab, zNumOptionsTabs};
+
+// An enumerator that specifies the stages of the waveform processing
+// loop that are timed by AAProcessingMetrics. Time spent outside the
+// instrumented stages (progress updates, event handling, etc) is
+// charged to the "other" stage
+enum ProcessingStageType{zReadStage, zWaveformStage, zBaselineStage,
+			 zPeakFindingStage, zLimitFindingStage, zIntegrationStage,
+			 zCalibrationStage, zPSDRegionStage, zFillStage,
+			 zOtherStage, zNumProcessingStages};
+
 // The following enumerator is used to create unique integers that
 // will be assigned as the "widget ID" to the ROOT widgets that make
 // up the ADAQ analysis graphical interface. The widget IDs are used
@@ -104,12 +330,17 @@ enum{
   MenuFileOpenASIM_ID,
   MenuFileLoadSpectrum_ID,
   MenuFileLoadPSDHistogram_ID,
+  MenuFileBatchFitSpectra_ID,
   MenuFileSaveWaveform_ID,
   MenuFileSaveSpectrum_ID,
   MenuFileSaveSpectrumBackground_ID,
   MenuFileSaveSpectrumDerivative_ID,
+  MenuFileSaveASIMSpectra_ID,
+  MenuFileSaveSettingsSweep_ID,
+  MenuFileSaveConvertedSpectrum_ID,
   MenuFileSavePSDHistogram_ID,
   MenuFileSavePSDHistogramSlice_ID,
+  MenuFileSavePSDFOMScan_ID,
   MenuFileSaveSpectrumCalibration_ID,
   MenuFileSaveSpectrumAnalysisResults_ID,
   MenuFilePrint_ID,
@@ -178,6 +409,8 @@ enum{
   ASIMSpectrumTypePhotonsCreated_RB_ID,
   ASIMSpectrumTypePhotonsDetected_RB_ID,
   ASIMEventTree_CB_ID,
+  ASIMEventTrees_LB_ID,
+  CreateASIMSpectra_TB_ID,
 
   SpectrumCalibration_CB_ID,
   SpectrumCalibrationManualSlider_RB_ID,
@@ -194,6 +427,9 @@ enum{
   SpectrumCalibrationReset_TB_ID,
   SpectrumCalibrationPlot_TB_ID,
   SpectrumCalibrationLoad_TB_ID,
+  GainDriftCompute_TB_ID,
+  GainDriftSave_TB_ID,
+  SettingsSweep_TB_ID,
   
   ProcessSpectrum_TB_ID,
   CreateSpectrum_TB_ID,
@@ -240,6 +476,7 @@ enum{
   EAProtonEnergy_NEL_ID,
   EAAlphaEnergy_NEL_ID,
   EACarbonEnergy_NEL_ID,
+  EAConvertSpectrum_TB_ID,
 
   ///////////////////////////
   // Values for the PSD frame
@@ -284,6 +521,8 @@ enum{
   PSDLowerFOMFitMax_NEL_ID,
   PSDUpperFOMFitMin_NEL_ID,
   PSDUpperFOMFitMax_NEL_ID,
+  PSDFOMScan_TB_ID,
+  PSDOptimizeWindows_TB_ID,
 
   /////////////////////////////////////////
   // Values for the "Graphics" tabbed frame
@@ -364,6 +603,7 @@ enum{
   WaveformSelector_HS_ID,
   SpectrumIntegrationLimits_DHS_ID,
 
+  CancelProcessing_TB_ID,
   Quit_TB_ID
 };
 
@@ -64,7 +64,6 @@ void AAAnalysisSlots::HandleCheckButtons()
       ButtonState = kButtonUp;
       WidgetState = true;
 
-      ComputationMgr->CalculateSpectrumBackground();
       GraphicsMgr->PlotSpectrum();
     }
     else{
@@ -80,7 +79,6 @@ void AAAnalysisSlots::HandleCheckButtons()
 
   case SpectrumBackgroundCompton_CB_ID:
   case SpectrumBackgroundSmoothing_CB_ID:
-    ComputationMgr->CalculateSpectrumBackground();
     GraphicsMgr->PlotSpectrum();
     break;
     
@@ -169,7 +167,6 @@ void AAAnalysisSlots::HandleComboBoxes(int ComboBoxID, int SelectedID)
   case SpectrumBackgroundDirection_CBL_ID:
   case SpectrumBackgroundFilterOrder_CBL_ID:
   case SpectrumBackgroundSmoothingWidth_CBL_ID:
-    ComputationMgr->CalculateSpectrumBackground();
     GraphicsMgr->PlotSpectrum();
     break;
     
@@ -206,7 +203,6 @@ void AAAnalysisSlots::HandleNumberEntries()
   case SpectrumBackgroundIterations_NEL_ID:
   case SpectrumRangeMin_NEL_ID:
   case SpectrumRangeMax_NEL_ID:
-    ComputationMgr->CalculateSpectrumBackground();
     GraphicsMgr->PlotSpectrum();
     break;
 
@@ -233,7 +229,6 @@ void AAAnalysisSlots::HandleNumberEntries()
   case EALightConversionFactor_NEL_ID:{
     double CF = TheInterface->EALightConversionFactor_NEL->GetEntry()->GetNumber();
     InterpolationMgr->SetConversionFactor(CF);
-    InterpolationMgr->ConstructResponses();
     TheInterface->NontabSlots->HandleTripleSliderPointer();
     break;
   }
@@ -267,7 +262,6 @@ void AAAnalysisSlots::HandleRadioButtons()
   case SpectrumWithBackground_RB_ID:
     TheInterface->SpectrumLessBackground_RB->SetState(kButtonUp);
     TheInterface->SaveSettings();
-    ComputationMgr->CalculateSpectrumBackground();
     GraphicsMgr->PlotSpectrum();
 
     if(TheInterface->SpectrumFindIntegral_CB->IsDown()){
@@ -279,7 +273,6 @@ void AAAnalysisSlots::HandleRadioButtons()
   case SpectrumLessBackground_RB_ID:
     TheInterface->SpectrumWithBackground_RB->SetState(kButtonUp);
     TheInterface->SaveSettings();
-    ComputationMgr->CalculateSpectrumBackground();
     GraphicsMgr->PlotSpectrum();
 
     if(TheInterface->SpectrumFindIntegral_CB->IsDown()){
@@ -293,3 +286,49 @@ void AAAnalysisSlots::HandleRadioButtons()
 
   }
 }
+
+
+void AAAnalysisSlots::HandleTextButtons()
+{
+  if(!TheInterface->EnableInterface)
+    return;
+  
+  TGTextButton *TextButton = (TGTextButton *) gTQSender;
+  int TextButtonID  = TextButton->WidgetId();
+  
+  TheInterface->SaveSettings();
+  
+  switch(TextButtonID){
+
+    // Convert the entire spectrum from electron equivalent energy
+    // into the energy of the selected incident particle
+  case EAConvertSpectrum_TB_ID:{
+
+    if(!ComputationMgr->GetSpectrumExists()){
+      TheInterface->CreateMessageBox("A spectrum must be created before it can be converted!","Stop");
+      break;
+    }
+    
+    int Channel = TheInterface->ChannelSelector_CBL->GetComboBox()->GetSelected();
+    bool SpectrumIsCalibrated = ComputationMgr->GetUseSpectraCalibrations()[Channel];
+    
+    if(TheInterface->ADAQFileLoaded and !SpectrumIsCalibrated){
+      TheInterface->CreateMessageBox("The spectrum must be calibrated in MeVee before it can be converted!","Stop");
+      break;
+    }
+
+    // Combo box entries correspond to proton, alpha, and carbon
+    int Type = TheInterface->EAConvertType_CBL->GetComboBox()->GetSelected() + zProtonEnergy;
+    
+    if(ComputationMgr->CreateConvertedSpectrum(Type))
+      GraphicsMgr->PlotConvertedSpectrum();
+    else
+      TheInterface->CreateMessageBox("The spectrum could not be converted!","Stop");
+    
+    break;
+  }
+    
+  default:
+    break;
+  }
+}
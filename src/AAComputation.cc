@@ -29,6 +29,7 @@
 /////////////////////////////////////////////////////////////////////////////////
 
 // ROOT
+#include <TROOT.h>
 #include <TSystem.h>
 #include <TError.h>
 #include <TF1.h>
@@ -38,12 +39,15 @@
 #include <TKey.h>
 #include <TMath.h>
 #include <TVirtualX.h>
+#include <TRandom3.h>
 
 // C++
 #include <iostream>
 #include <fstream>
 #include <algorithm>
 #include <chrono>
+#include <cmath>
+#include <cctype>
 using namespace std;
 
 // MPI
@@ -54,10 +58,12 @@ using namespace std;
 // Boost
 #include <boost/array.hpp>
 #include <boost/thread.hpp>
+#include <boost/bind/bind.hpp>
 
 // ADAQAnalysis
 #include "AAComputation.hh"
 #include "AAParallel.hh"
+#include "AAInterpolation.hh"
 
 
 AAComputation *AAComputation::TheComputationManager = 0;
@@ -72,8 +78,8 @@ AAComputation::AAComputation(string CmdLineArg, bool PA)
     ADAQFile(new TFile), ADAQFileName(""), ADAQFileLoaded(false), ADAQLegacyFileLoaded(false),
     ADAQWaveformTree(new TTree),
 
-    ASIMFile(new TFile), ASIMFileName(""), ASIMFileLoaded(false), 
-    ASIMEventTreeList(new TList), ASIMEvt(new ASIMEvent),
+    ASIMFileName(""), ASIMFileLoaded(false), 
+    ASIMEvt(new ASIMEvent),
     
     ADAQParResults(NULL), ADAQParResultsLoaded(false),
     Time(0), RawVoltage(0), RecordLength(0), Baseline(0.),
@@ -81,21 +87,40 @@ AAComputation::AAComputation(string CmdLineArg, bool PA)
     PeakIntegral_LowerLimit(0), PeakIntegral_UpperLimit(0), PeakLimits(0),
     WaveformStart(0), WaveformEnd(0),
     WaveformAnalysisHeight(0.), WaveformAnalysisArea(0.), 
+    WaveformIndexReady(false), WaveformIndexBuilding(false), WaveformIndexThread(0),
+    WaveformIndexCancelled(false),
     Spectrum_H(new TH1F), SpectrumDerivative_H(new TH1F), SpectrumDerivative_G(new TGraph),
     SpectrumBackground_H(new TH1F), SpectrumDeconvolved_H(new TH1F), 
-    SpectrumIntegral_H(new TH1F), SpectrumFit_F(new TF1),
-    PSDHistogram_H(new TH2F), MasterPSDHistogram_H(new TH2F), PSDHistogramSlice_H(new TH1D),
+    SpectrumIntegral_H(new TH1F), SpectrumFit_F(new TF1), ConvertedSpectrum_H(new TH1F),
+    PSDHistogram_H(new TH2F), MasterPSDHistogram_H(new TH2D), PSDHistogramSlice_H(new TH1D),
+    PSDFOMScan_GE(NULL),
     PSDRegionPolarity(1.),
    
     SpectrumExists(false), SpectrumBackgroundExists(false), SpectrumDerivativeExists(false),
-    SpectrumFitExists(false),
-    PSDHistogramExists(false), PSDHistogramSliceExists(false),
+    SpectrumFitExists(false), ASIMSpectraExist(false), ConvertedSpectrumExists(false),
+    SettingsSweepExists(false),
+    PSDHistogramExists(false), PSDHistogramSliceExists(false), PSDFOMScanExists(false),
+    SpectrumVersion(0), ProcessedWaveforms(0), SpectrumPreviewOrder(false),
 
     MPI_Size(1), MPI_Rank(0), IsMaster(true), IsSlave(false), ParallelVerbose(true),
     Verbose(false), NumDataChannels(16), TotalPeaks(0),
 
     CalibrationRegionSet(false), CalibrationBoundaryPoints(0),
-    CalibrationFound(false), CalibrationX(0.), CalibrationY(0.)
+    CalibrationFound(false), CalibrationX(0.), CalibrationY(0.),
+
+    GainDriftSliceSize(0), GainDriftChannel(-1), GainDriftNumValues(0),
+    GainDriftPAS(true), GainDriftCorrectionExists(false),
+
+    IntegratePeaks_K(NULL), FindPeakHeights_K(NULL), CalculatePSDIntegrals_K(NULL),
+    FillPulse_K(NULL),
+
+    ProcessingThread(NULL), ProcessingJob(zNoProcessingJob),
+    ProcessingActive(false), ProcessingCancelled(false),
+    ProcessingDone(0), ProcessingTotal(0), ProcessingInThread(false),
+    ProcessingSnapshotReady(false), ProcessingSnapshot_H(NULL),
+    PSDSliceAxis(-1), PSDSliceBin(-1),
+    PSDSliceFitThread(NULL), PSDSliceFitDone(false),
+    PSDSliceFitQueued(false), PSDSliceFitRequests(0)
 {
   if(TheComputationManager){
     cout << "\nADAQAnalysis error! TheComputationManager was constructed twice!\n" << endl;
@@ -104,6 +129,14 @@ AAComputation::AAComputation(string CmdLineArg, bool PA)
   else
     TheComputationManager = this;
 
+  for(Int_t p=0; p<zNumSpectrumProducts; p++){
+    SpectrumProducts[p].Version = 0;
+    SpectrumProducts[p].Valid = false;
+  }
+
+  PSDSliceFit.Request = -1;
+  PSDSliceFit.FOM = 0.;
+  PSDSliceFit.Valid = false;
   
   
   // Initialize the objects used in the calibration and pulse shape
@@ -211,7 +244,24 @@ AAComputation::AAComputation(string CmdLineArg, bool PA)
 
 
 AAComputation::~AAComputation()
-{;}
+{
+  // Stop and join the background threads that read the ADAQ file
+  CancelWaveformIndex();
+
+  CancelProcessing();
+  if(ProcessingThread){
+    ProcessingThread->join();
+    delete ProcessingThread;
+  }
+  
+  // A PSD slice fit is short and cannot be interrupted
+  if(PSDSliceFitThread){
+    PSDSliceFitThread->join();
+    delete PSDSliceFitThread;
+  }
+
+  delete ConvertedSpectrum_H;
+}
 
 
 bool AAComputation::LoadADAQFile(string FileName)
@@ -414,43 +464,132 @@ void AAComputation::LoadLegacyADAQFile()
     
 bool AAComputation::LoadASIMFile(string FileName)
 {
-  // Set the ASIM File name
-  ASIMFileName = FileName;
+  vector<string> FileNames;
+  FileNames.push_back(FileName);
+  return LoadASIMFiles(FileNames);
+}
+
+
+// Method to load one or more ASIM files. Rather than reading every
+// object in the files, a catalog of the event trees is built from the
+// TKey metadata in each file directory; the TTrees themselves are
+// only read when first requested via GetASIMEventTree(). This makes
+// opening files with many event trees nearly instantaneous
+bool AAComputation::LoadASIMFiles(vector<string> FileNames)
+{
+  // Close any previously loaded ASIM files, which also deletes any
+  // event trees that were read from them
+  vector<TFile *>::iterator It;
+  for(It=ASIMFiles.begin(); It!=ASIMFiles.end(); It++){
+    (*It)->Close();
+    delete (*It);
+  }
+  ASIMFiles.clear();
+  ASIMEventTreeCatalog.clear();
   
-  // Open the ASIM ROOT file in read-only mode
-  ASIMFile = new TFile(FileName.c_str(), "read");
+  ASIMFileLoaded = false;
 
-  // Recreate the TList that contains TTrees with ADAQSimulationEvents
-  if(ASIMEventTreeList) delete ASIMEventTreeList;
-  ASIMEventTreeList = new TList;
+  if(FileNames.empty())
+    return ASIMFileLoaded;
   
-  if(!ASIMFile->IsOpen()){
-    ASIMFileLoaded = false;
-  }
-  else{
-    // Iterate over the TFile using the TObject keys to search for
-    // TTrees to add to the EventTreeList. The EventTreeList will be
-    // access later for analysis. Note that the only TTrees that
-    // should be present in ASIM files are those that contain
-    // event-level information in branches with ADAQSimulationEvent
-    // objects.
-
-    TIter It(ASIMFile->GetListOfKeys());
+  // Set the ASIM File name to the first file in the list
+  ASIMFileName = FileNames[0];
+  
+  for(size_t f=0; f<FileNames.size(); f++){
+
+    // Open the ASIM ROOT file in read-only mode
+    TFile *File = new TFile(FileNames[f].c_str(), "read");
+    
+    if(!File->IsOpen()){
+      cout << "Warning: The ASIM file '" << FileNames[f] << "' could not be opened!\n"
+	   << endl;
+      delete File;
+      continue;
+    }
+
+    Int_t FileIndex = ASIMFiles.size();
+    ASIMFiles.push_back(File);
+    
+    // When more than one file is loaded, the event tree names are
+    // prefixed with the file name to prevent ambiguity
+    string Prefix = "";
+    if(FileNames.size() > 1){
+      Prefix = FileNames[f];
+      size_t Pos = Prefix.find_last_of("/");
+      if(Pos != string::npos)
+	Prefix = Prefix.substr(Pos+1);
+      Prefix += ":";
+    }
+    
+    // Iterate over the TFile keys to search for TTrees to add to the
+    // catalog. The class name is obtained from the key itself such
+    // that no objects are read from file. Note that the only TTrees
+    // that should be present in ASIM files are those that contain
+    // event-level information in branches with ASIMEvent objects
+    
+    TIter KeyIt(File->GetListOfKeys());
     TKey *Key;
-    while((Key = (TKey *)It.Next())){
-      TString ClassType = ASIMFile->Get(Key->GetName())->ClassName();
+    while((Key = (TKey *)KeyIt.Next())){
+      TString ClassType = Key->GetClassName();
       
-      if(ClassType == "TTree"){
-	TTree *Tree = (TTree *)ASIMFile->Get(Key->GetName());
-	ASIMEventTreeList->Add(Tree);
-      }
+      if(ClassType != "TTree")
+	continue;
+      
+      // Skip older cycles of a TTree that has already been cataloged
+      string Name = Prefix + Key->GetName();
+      
+      Bool_t Cataloged = false;
+      vector<ASIMEventTreeInfo>::iterator it;
+      for(it=ASIMEventTreeCatalog.begin(); it!=ASIMEventTreeCatalog.end(); it++)
+	if((*it).Name == Name)
+	  Cataloged = true;
+      
+      if(Cataloged)
+	continue;
+
+      ASIMEventTreeInfo Info;
+      Info.Name = Name;
+      Info.KeyName = Key->GetName();
+      Info.FileIndex = FileIndex;
+      ASIMEventTreeCatalog.push_back(Info);
     }
-    ASIMFileLoaded = true;
   }
+  
+  ASIMFileLoaded = !ASIMFiles.empty();
+  
   return ASIMFileLoaded;
 }
 
 
+vector<string> AAComputation::GetASIMEventTreeNames()
+{
+  vector<string> Names;
+  vector<ASIMEventTreeInfo>::iterator It;
+  for(It=ASIMEventTreeCatalog.begin(); It!=ASIMEventTreeCatalog.end(); It++)
+    Names.push_back((*It).Name);
+  return Names;
+}
+
+
+// Return the event tree with the specified name, reading it from the
+// ASIM file if this is the first request. NULL is returned if an
+// event tree with the specified name is not in the catalog
+TTree *AAComputation::GetASIMEventTree(string Name)
+{
+  vector<ASIMEventTreeInfo>::iterator It;
+  for(It=ASIMEventTreeCatalog.begin(); It!=ASIMEventTreeCatalog.end(); It++){
+    if((*It).Name != Name)
+      continue;
+    
+    if((*It).Tree == NULL)
+      (*It).Tree = (TTree *)ASIMFiles[(*It).FileIndex]->Get((*It).KeyName.c_str());
+    
+    return (*It).Tree;
+  }
+  return NULL;
+}
+
+
 TH1F *AAComputation::CalculateRawWaveform(int Channel, int Waveform)
 {
   // Readout the desired waveform from the tree
@@ -487,8 +626,16 @@ TH1F* AAComputation::CalculateBSWaveform(int Channel, int Waveform, bool Current
 {
   ADAQWaveformTree->GetEntry(Waveform);
 
-  vector<Int_t> RawVoltage = *Waveforms[Channel];
-  
+  return FillBSWaveform(Channel, *Waveforms[Channel]);
+}
+
+
+// Method to fill the baseline-subtracted waveform on the specified
+// data channel from a waveform that has already been read from the
+// ADAQ TTree such that the waveform may be processed repeatedly
+// (e.g. with different baseline regions) without being reread
+TH1F *AAComputation::FillBSWaveform(Int_t Channel, vector<Int_t> &RawVoltage)
+{
   Int_t Size = RawVoltage.size();
 
   if(Waveform_H[Channel])
@@ -517,11 +664,18 @@ TH1F* AAComputation::CalculateBSWaveform(int Channel, int Waveform, bool Current
 TH1F *AAComputation::CalculateZSWaveform(int Channel, int Waveform, bool CurrentWaveform)
 {
   ADAQWaveformTree->GetEntry(Waveform);
-  
+
+  return FillZSWaveform(Channel, *Waveforms[Channel]);
+}
+
+
+// Method to fill the zero suppression waveform on the specified data
+// channel from a waveform that has already been read from the ADAQ
+// TTree. See AAComputation::FillBSWaveform() for motivation
+TH1F *AAComputation::FillZSWaveform(Int_t Channel, vector<Int_t> &RawVoltage)
+{
   Double_t Polarity = ADAQSettings->WaveformPolarity;
   
-  vector<Int_t> RawVoltage = *Waveforms[Channel];
-  
   if(Waveform_H[Channel])
     delete Waveform_H[Channel];
   
@@ -562,11 +716,15 @@ TH1F *AAComputation::CalculateZSWaveform(int Channel, int Waveform, bool Current
 // of the baseline are in [samples]
 double AAComputation::CalculateBaseline(vector<int> *Waveform)
 {
+  Int_t Stage = ProcessingMetrics.Switch(zBaselineStage);
+  
   int BaselineRegionLength = ADAQSettings->BaselineRegionMax - ADAQSettings->BaselineRegionMin;
   double Baseline = 0.;
   for(int sample=ADAQSettings->BaselineRegionMin; sample<ADAQSettings->BaselineRegionMax; sample++)
     Baseline += ((*Waveform)[sample]*1.0/BaselineRegionLength);
 
+  ProcessingMetrics.Switch(Stage);
+  
   return Baseline;
 }
 
@@ -657,7 +815,9 @@ bool AAComputation::FindPeaks(TH1F *Histogram_H, int PeakFindingAlgorithm)
     // Call the member functions that will find the lower (leftwards on
     // the time axis) and upper (rightwards on the time axis)
     // integration limits for each successful peak in the waveform
+    Int_t Stage = ProcessingMetrics.Switch(zLimitFindingStage);
     FindPeakLimits(Histogram_H);
+    ProcessingMetrics.Switch(Stage);
   }
   
 
@@ -868,11 +1028,13 @@ void AAComputation::ProcessSpectrumWaveforms()
   // can find multiple values per pulse and therefore does not have a
   // fixed vector length, makes preallocation difficult.
 
-  SpectrumPHVec[Channel].clear();
-  SpectrumPAVec[Channel].clear();
+  SpectrumPHVec[Channel].Initialize(ADAQSettings->PulseStorePrecision,
+				    ADAQSettings->PulseStoreSpillToDisk);
+  SpectrumPAVec[Channel].Initialize(ADAQSettings->PulseStorePrecision,
+				    ADAQSettings->PulseStoreSpillToDisk);
   
   // Reset the waveform progress bar
-  if(SequentialArchitecture){
+  if(SequentialArchitecture and !ProcessingInThread){
     ProcessingProgressBar->Reset();
     ProcessingProgressBar->SetBarColor(ColorManager->Number2Pixel(33));
     ProcessingProgressBar->SetForegroundColor(ColorManager->Number2Pixel(1));
@@ -883,6 +1045,15 @@ void AAComputation::ProcessSpectrumWaveforms()
 			ADAQSettings->SpectrumNumBins, 
 			ADAQSettings->SpectrumMinBin,
 			ADAQSettings->SpectrumMaxBin);
+
+  // The spectrum counts are accumulated exactly and copied into the
+  // histogram once processing is complete
+  SpectrumCounts.Initialize(ADAQSettings->SpectrumNumBins, 
+			    ADAQSettings->SpectrumMinBin,
+			    ADAQSettings->SpectrumMaxBin);
+
+  if(ProcessingInThread)
+    ProcessingSnapshotReady.store(true, memory_order_release);
   
   // Variables for calculating pulse height and area
 
@@ -926,14 +1097,27 @@ void AAComputation::ProcessSpectrumWaveforms()
     SS << "WaveformDataCh" << Channel;
     string WDName = SS.str();
 
+    // Select the processing kernels for the present settings
+    SelectProcessingKernels(false);
+    
+    ProcessingTotal.store(ADAQSettings->WaveformsToHistogram);
+
+    ProcessingMetrics.Start();
+    
     // Readout appropriate waveform data into the spectrum
     for(Int_t entry=0; entry<ADAQSettings->WaveformsToHistogram; entry++){
       
       // Ensure only the specified number of events are processed
       if(entry == ADAQSettings->WaveformsToHistogram)
 	break;
+
+      ProcessingMetrics.Switch(zOtherStage);
+
+      if(ProcessingInThread and !ContinueProcessing(entry+1))
+	break;
       
-      ADAQWaveformTree->GetEntry(entry);
+      ProcessingMetrics.Switch(zReadStage);
+      ProcessingMetrics.AddWaveform(ADAQWaveformTree->GetEntry(entry));
       
       // Get the pulse height and area...
       
@@ -969,6 +1153,8 @@ void AAComputation::ProcessSpectrumWaveforms()
       Bool_t PSDReject = false;
       
       if(ADAQSettings->UsePSDRegions[Channel]){
+
+	ProcessingMetrics.Switch(zPSDRegionStage);
 	
 	// Get the stored PSD total and tail integral values
 
@@ -1001,34 +1187,17 @@ void AAComputation::ProcessSpectrumWaveforms()
 	continue;
 
       // Add uncalibrated waveform data to the storage vectors for
-      // potential later use
-      SpectrumPHVec[Channel].push_back(PulseHeight);
-      SpectrumPAVec[Channel].push_back(PulseArea);
-
-      // Determine pulse height/area value for analysis
-      
-      Double_t Quantity = 0.;
-      if(ADAQSettings->ADAQSpectrumTypePHS)
-	Quantity = PulseHeight;
-      else if(ADAQSettings->ADAQSpectrumTypePAS)
-	Quantity = PulseArea;
-      
-      // Convert the quantity if calibration has been activated
-
-      if(ADAQSettings->UseSpectraCalibrations[Channel]){
-	if(SpectraCalibrationType[Channel] == zCalibrationFit)      	  
-	  Quantity = ADAQSettings->SpectraCalibrations[Channel]->Eval(Quantity);
-	else if(SpectraCalibrationType[Channel] == zCalibrationInterp)
-	  Quantity = ADAQSettings->SpectraCalibrationData[Channel]->Eval(Quantity);
-      }
-      
-      // Fill the spectrum is quantity is within thresholds
-      
-      if(Quantity > ADAQSettings->SpectrumMinThresh and
-	 Quantity < ADAQSettings->SpectrumMaxThresh)
-	Spectrum_H->Fill(Quantity);
+      // potential later use and fill the spectrum with the
+      // (calibrated) pulse height or area
+      ProcessingMetrics.Switch(zFillStage);
+      ProcessingMetrics.AddPulses(1);
+      (this->*FillPulse_K)(Channel, PulseHeight, PulseArea);
     }
+    SpectrumCounts.CopyToHistogram(Spectrum_H);
+    ProcessingMetrics.Stop();
+    
     SpectrumExists = true;
+    SpectrumVersion++;
   }
   
   
@@ -1054,6 +1223,9 @@ void AAComputation::ProcessSpectrumWaveforms()
     if(PeakFinder) delete PeakFinder;
     PeakFinder = new TSpectrum(ADAQSettings->MaxPeaks);
 
+    // Select the processing kernels for the present settings
+    SelectProcessingKernels(false);
+
     // Assign the range of waveforms that will be analyzed to create a
     // histogram. Note that in sequential architecture if N waveforms
     // are to be histogrammed, waveforms from waveform_ID == 0 to
@@ -1099,29 +1271,61 @@ void AAComputation::ProcessSpectrumWaveforms()
 
 #endif
 
+    // In preview mode every waveform in the file is processed but the
+    // entries are visited in a random order of TTree clusters such
+    // that the spectrum is representative of the entire run after
+    // any fraction of the waveforms has been processed
+    vector<Int_t> PreviewOrder;
+    if(ADAQSettings->SpectrumPreview and SequentialArchitecture){
+      WaveformEnd = ADAQWaveformTree->GetEntries();
+      PreviewOrder = CreatePreviewOrder(WaveformEnd);
+    }
+    
     bool PeaksFound = false;
 
+    ProcessingTotal.store(WaveformEnd - WaveformStart);
+
+    ProcessedWaveforms = 0;
+    SpectrumPreviewOrder = !PreviewOrder.empty();
+    
+    ProcessingMetrics.Start();
+
     // Process the waveforms. 
-    for(int waveform=WaveformStart; waveform<WaveformEnd; waveform++){
+    for(int entry=WaveformStart; entry<WaveformEnd; entry++){
+      int waveform = (PreviewOrder.empty()) ? entry : PreviewOrder[entry];
+
+      ProcessingMetrics.Switch(zOtherStage);
+      
       // Run processing in a separate thread to enable use of the GUI by
       // the user while the spectrum is being created
-      if(SequentialArchitecture)
+      if(SequentialArchitecture and !ProcessingInThread)
 	gSystem->ProcessEvents();
 
+      // When processing in the background thread, publish the
+      // progress and stop at the next chunk boundary if cancelled
+      if(ProcessingInThread and !ContinueProcessing(entry-WaveformStart+1))
+	break;
+
+      ProcessedWaveforms++;
+
       // Get the data from the ADAQ TTree for the current waveform
-      ADAQWaveformTree->GetEntry(waveform);
+      ProcessingMetrics.Switch(zReadStage);
+      ProcessingMetrics.AddWaveform(ADAQWaveformTree->GetEntry(waveform));
       
       // Assign the raw waveform voltage to a class member vector<int>
+      ProcessingMetrics.Switch(zWaveformStage);
       RawVoltage = *Waveforms[Channel];
     
       // Calculate the selected waveform that will be analyzed into the
       // spectrum histogram. Note that "raw" waveforms may not be
       // analyzed (simply due to how the code is presently setup) and
-      // will default to analyzing the baseline subtracted waveform
+      // will default to analyzing the baseline subtracted waveform.
+      // The waveform is built from the voltage already read above
+      // rather than reading the entry from the tree a second time
       if(ADAQSettings->RawWaveform or ADAQSettings->BSWaveform)
-	CalculateBSWaveform(Channel, waveform);
+	FillBSWaveform(Channel, RawVoltage);
       else if(ADAQSettings->ZSWaveform)
-	CalculateZSWaveform(Channel, waveform);
+	FillZSWaveform(Channel, RawVoltage);
     
       ///////////////////////////////////////////
       // Simple max/sum (SMS) waveform processing
@@ -1136,8 +1340,11 @@ void AAComputation::ProcessSpectrumWaveforms()
 
 	if(ADAQSettings->UsePSDRegions[Channel]){
 	
+	  ProcessingMetrics.Switch(zPeakFindingStage);
 	  FindPeaks(Waveform_H[Channel], zWholeWaveform);
-	  CalculatePSDIntegrals(false);
+	  
+	  ProcessingMetrics.Switch(zPSDRegionStage);
+	  (this->*CalculatePSDIntegrals_K)(Channel);
 	
 	  if(PeakInfoVec[0].PSDFilterFlag == true)
 	    continue;
@@ -1146,6 +1353,8 @@ void AAComputation::ProcessSpectrumWaveforms()
 	////////////////////////////////////////////////
 	// Calculation of waveform pulse height and area
 	
+	ProcessingMetrics.Switch(zIntegrationStage);
+	
 	Int_t AnalysisMin = ADAQSettings->AnalysisRegionMin;
 	Int_t AnalysisMax = ADAQSettings->AnalysisRegionMax;
 
@@ -1159,19 +1368,6 @@ void AAComputation::ProcessSpectrumWaveforms()
 	PulseHeight = Waveform_H[Channel]->
 	  GetBinContent(Waveform_H[Channel]->GetMaximumBin());
 	
-	
-	// Store the uncalibrated pulse height in the designated vector
-	SpectrumPHVec[Channel].push_back(PulseHeight);
-	
-	// If the calibration manager is to be used to convert the
-	// value from pulse units [ADC] to energy units [keV, MeV,
-	// ...] then do so
-	if(ADAQSettings->UseSpectraCalibrations[Channel]){
-	  if(SpectraCalibrationType[Channel] == zCalibrationFit)
-	    PulseHeight = ADAQSettings->SpectraCalibrations[Channel]->Eval(PulseHeight);
-	  else if(SpectraCalibrationType[Channel] == zCalibrationInterp)
-	    PulseHeight = ADAQSettings->SpectraCalibrationData[Channel]->Eval(PulseHeight);
-	}
 	// Pulse area
 	
 	// Reset the pulse area "integral" to zero
@@ -1185,45 +1381,23 @@ void AAComputation::ProcessSpectrumWaveforms()
 	  PulseArea += SampleHeight;
 	}
 	
-	// Store the uncalibrated pulse height in the designated vector
-	SpectrumPAVec[Channel].push_back(PulseArea);
-
-	// If the calibration manager is to be used to convert the
-	// value from pulse units [ADC] to energy units [keV, MeV,
-	// ...] then do so
-	if(ADAQSettings->UseSpectraCalibrations[Channel]){
-	  if(SpectraCalibrationType[Channel] == zCalibrationFit)
-	    PulseArea = ADAQSettings->SpectraCalibrations[Channel]->Eval(PulseArea);
-	  else if(SpectraCalibrationType[Channel] == zCalibrationInterp)
-	    PulseArea = ADAQSettings->SpectraCalibrationData[Channel]->Eval(PulseArea);
-	}
-
-	// Initial spectra creation
-	
-	// Add the pulse value to the spectrum object depending on
-	// type of spectrum that is to be created initially
-
-	if(ADAQSettings->ADAQSpectrumTypePHS){
-	  if(PulseHeight > ADAQSettings->SpectrumMinThresh and
-	     PulseHeight < ADAQSettings->SpectrumMaxThresh){
-	    Spectrum_H->Fill(PulseHeight);
-	  }
-	}
+	// Store the uncalibrated pulse height and area in the
+	// designated vectors and add the (calibrated) pulse value to
+	// the spectrum object depending on type of spectrum that is to
+	// be created initially
+	ProcessingMetrics.Switch(zFillStage);
+	ProcessingMetrics.AddPulses(1);
+	(this->*FillPulse_K)(Channel, PulseHeight, PulseArea);
 	
-	else if(ADAQSettings->ADAQSpectrumTypePAS){
-	  if(PulseArea > ADAQSettings->SpectrumMinThresh and
-	     PulseArea < ADAQSettings->SpectrumMaxThresh){
-	    Spectrum_H->Fill(PulseArea);
-	  }
-	}
+	ProcessingMetrics.Switch(zOtherStage);
 	
 	// Note that we must add a +1 to the waveform number in order to
 	// get the modulo to land on the correct intervals
 	if(IsMaster)
 	  // Check to ensure no floating point exception for low number
 	  if(WaveformEnd >= 50)
-	    if((waveform+1) % int(WaveformEnd*ADAQSettings->UpdateFreq*1.0/100) == 0)
-	      UpdateProcessingProgress(waveform);
+	    if((entry+1) % int(WaveformEnd*ADAQSettings->UpdateFreq*1.0/100) == 0)
+	      UpdateProcessingProgress(entry);
       }
       
       
@@ -1241,7 +1415,9 @@ void AAComputation::ProcessSpectrumWaveforms()
 	// integrate the valid peaks to create a PAS or find the peak
 	// heights to create a PHS, returning true. If zero peaks are
 	// found in the waveform then FindPeaks() returns false
+	ProcessingMetrics.Switch(zPeakFindingStage);
 	PeaksFound = FindPeaks(Waveform_H[Channel], zPeakFinder);
+	ProcessingMetrics.Switch(zOtherStage);
 
 	// Because the peak finding algorithm skips analysis of
 	// waveforms for which it cannot find peaks, we need to update
@@ -1253,30 +1429,38 @@ void AAComputation::ProcessSpectrumWaveforms()
 	// correct intervals
 	if(IsMaster)
 	  if(WaveformEnd >= 50)
-	    if((waveform+1) % int(WaveformEnd*ADAQSettings->UpdateFreq*1.0/100) == 0)
-	      UpdateProcessingProgress(waveform);
+	    if((entry+1) % int(WaveformEnd*ADAQSettings->UpdateFreq*1.0/100) == 0)
+	      UpdateProcessingProgress(entry);
 
 	// If no peaks are present in the current waveform then continue
 	// on to the next waveform for analysis
 	if(!PeaksFound)
 	  continue;
 
+	ProcessingMetrics.AddPulses(PeakInfoVec.size());
+
 	// Calculate the PSD integrals and determine if they pass
 	// the pulse-shape filterthrough the pulse-shape filter
-	if(UsePSDRegions[ADAQSettings->WaveformChannel])
-	  CalculatePSDIntegrals(false);
+	if(UsePSDRegions[ADAQSettings->WaveformChannel]){
+	  ProcessingMetrics.Switch(zPSDRegionStage);
+	  (this->*CalculatePSDIntegrals_K)(Channel);
+	}
 	
 	// Find both pulse area and peak heights during processing so
 	// that the values can be added to the spectrum vectors
-	IntegratePeaks();
-	FindPeakHeights();
+	ProcessingMetrics.Switch(zIntegrationStage);
+	(this->*IntegratePeaks_K)(Channel);
+	(this->*FindPeakHeights_K)(Channel);
       }
     }
+
+    SpectrumCounts.CopyToHistogram(Spectrum_H);
+    ProcessingMetrics.Stop();
   
     // Make final updates to the progress bar, ensuring that it reaches
     // 100% and changes color to acknoqledge that processing is complete
 
-    if(SequentialArchitecture){
+    if(SequentialArchitecture and !ProcessingInThread){
       ProcessingProgressBar->Increment(100);
       ProcessingProgressBar->SetBarColor(ColorManager->Number2Pixel(32));
       ProcessingProgressBar->SetForegroundColor(ColorManager->Number2Pixel(0));
@@ -1297,6 +1481,13 @@ void AAComputation::ProcessSpectrumWaveforms()
 
     // Ensure that all nodes have reached the end-of-processing!
 
+    // Report the processing rates and the time spent in each stage
+    // of the processing loop on this node
+    if(ParallelVerbose)
+      cout << "\nADAQAnalysis_MPI Node[" << MPI_Rank << "] : Processing metrics\n"
+	   << ProcessingMetrics.GetSummary()
+	   << flush;
+    
     if(ParallelVerbose)
       cout << "\nADAQAnalysis_MPI Node[" << MPI_Rank << "] : Reached the end-of-processing MPI barrier!"
 	   << endl;
@@ -1306,26 +1497,27 @@ void AAComputation::ProcessSpectrumWaveforms()
     /////////////////////////////////
     // Aggregate TH1F spectra objects
 
-    // In order to aggregate the Spectrum_H objects on each node to a
+    // In order to aggregate the spectrum counts on each node to a
     // single Spectrum_H object on the master node, the following is
     // performed:
     //
     // 0. Create a double array on each node 
-    // 1. Store each node's Spectrum_H bin contents in the array
+    // 1. Store each node's SpectrumCounts bin contents in the array
     // 2. Use MPI::Reduce on the array ptr to quickly aggregate the
     //    array values to the master's array (master == node 0)
     //
     // The size of the array must be (nbins+2) since ROOT TH1 objects
     // that are created with nbins have a underflow (bin = 0) and
-    // overflow (bin = nbin+1) bin added onto the bins within range.
+    // overflow (bin = nbin+1) bin added onto the bins within
+    // range. Note that doubles represent integer counts exactly up
+    // to 2^53 such that the summed counts remain exact
   
-    const Int_t ArraySize = ADAQSettings->SpectrumNumBins + 2;
+    const Int_t ArraySize = SpectrumCounts.GetNcells();
     Double_t SpectrumArray[ArraySize];
-    for(Int_t i=0; i<ArraySize; i++)
-      SpectrumArray[i] = Spectrum_H->GetBinContent(i);
+    SpectrumCounts.CopyTo(SpectrumArray);
     
     // Get the total number of spectrum entries on the node 
-    Double_t Entries = Spectrum_H->GetEntries();
+    Double_t Entries = SpectrumCounts.GetEntries();
     
     if(ParallelVerbose)
       cout << "\nADAQAnalysis_MPI Node[" << MPI_Rank << "] : Aggregating results to Node[0]!" << endl;
@@ -1366,8 +1558,11 @@ void AAComputation::ProcessSpectrumWaveforms()
     TString FName = SS.str();
     
     TFile *VectorWrite = new TFile(FName, "recreate");
-    TVectorD PH(SpectrumPHVec[Channel].size(), &SpectrumPHVec[Channel][0]);
-    TVectorD PA(SpectrumPAVec[Channel].size(), &SpectrumPAVec[Channel][0]);
+    TVectorD PH(SpectrumPHVec[Channel].size());
+    SpectrumPHVec[Channel].CopyTo(PH.GetMatrixArray());
+
+    TVectorD PA(SpectrumPAVec[Channel].size());
+    SpectrumPAVec[Channel].CopyTo(PA.GetMatrixArray());
     PH.Write("PH");
 
     PA.Write("PA");
@@ -1377,30 +1572,28 @@ void AAComputation::ProcessSpectrumWaveforms()
     // read in by the running sequential binary of ADAQAnalysisGUI
     if(IsMaster){
       if(ParallelVerbose)
-	cout << "\nADAQAnalysis_MPI Node[0] : Writing master TH1F histogram to disk!\n"
+	cout << "\nADAQAnalysis_MPI Node[0] : Writing master TH1D histogram to disk!\n"
 	     << endl;
       
-      // Create the master TH1F histogram object. Note that the member
-      // data for spectrum creation are used to ensure the correct
-      // number of bins and bin aranges
-      MasterHistogram_H = new TH1F("MasterHistogram","MasterHistogram", 
-				   ADAQSettings->SpectrumNumBins,
-				   ADAQSettings->SpectrumMinBin, 
-				   ADAQSettings->SpectrumMaxBin);
-    
-      // Assign the bin content to the appropriate bins. Note that the
-      // 'for loop' must include the TH1 overflow bin that exists at
-      // (nbin+1) in order to capture all possible entries
+      // Accumulate the aggregated counts into a master accumulator
+      // with the same binning as the nodes' spectrum counts. Note
+      // that all bins including the TH1 overflow bin that exists at
+      // (nbin+1) are assigned in order to capture all possible
+      // entries. The number of entries is set to the total number of
+      // fills on all nodes to preserve the number of counts in the
+      // histogram for statistics purposes
+      AAHistogramAccumulator MasterCounts;
+      MasterCounts.Initialize(ADAQSettings->SpectrumNumBins,
+			      ADAQSettings->SpectrumMinBin, 
+			      ADAQSettings->SpectrumMaxBin);
+      
       for(int i=0; i<ArraySize; i++)
-	MasterHistogram_H->SetBinContent(i, ReturnArray[i]);
-    
-      // Set the total number of entries in the histogram. Because we
-      // are setting the content of each bin with a single "entry"
-      // weighted to the desired bin content value for each bin, the
-      // number of entries will equal to the total number of
-      // bins. However, we'd like to preserve the number of counts in
-      // the histogram for statistics purposes;
-      MasterHistogram_H->SetEntries(ReturnDouble);
+	MasterCounts.AddBinContent(i, llround(ReturnArray[i]));
+      MasterCounts.AddEntries(llround(ReturnDouble));
+      
+      // Create the master TH1D histogram object, which holds the
+      // exact counts for reading by the sequential binary
+      MasterHistogram_H = MasterCounts.CreateTH1D("MasterHistogram","MasterHistogram");
 
       // Aggregate each nodes' TVectorT's objects, which stored
       // calculated pulse height/areas for each waveform they
@@ -1456,6 +1649,7 @@ void AAComputation::ProcessSpectrumWaveforms()
     }
 #endif
     SpectrumExists = true;
+    SpectrumVersion++;
   }
 }
 
@@ -1475,25 +1669,34 @@ void AAComputation::CreateSpectrum()
 			ADAQSettings->SpectrumMinBin,
 			ADAQSettings->SpectrumMaxBin);
 
+  SpectrumCounts.Initialize(ADAQSettings->SpectrumNumBins, 
+			    ADAQSettings->SpectrumMinBin,
+			    ADAQSettings->SpectrumMaxBin);
+
   // Get the current digitizer channel to analyze
   Int_t Channel = ADAQSettings->WaveformChannel;
 
-  vector<Double_t>::iterator It, ItB, ItE;
-  if(ADAQSettings->ADAQSpectrumTypePAS){
-    It = SpectrumPAVec[Channel].begin();
-    ItB = SpectrumPAVec[Channel].begin();
-    ItE = SpectrumPAVec[Channel].end();
-  }
-  else if(ADAQSettings->ADAQSpectrumTypePHS){
-    It = SpectrumPHVec[Channel].begin();
-    ItB = SpectrumPHVec[Channel].begin();
-    ItE = SpectrumPHVec[Channel].end();
-  }
+  // Stream through the stored pulse values; the stores decode one
+  // chunk at a time so that access in order is efficient
+  AAPulseStore *Store = NULL;
+  if(ADAQSettings->ADAQSpectrumTypePAS)
+    Store = &SpectrumPAVec[Channel];
+  else if(ADAQSettings->ADAQSpectrumTypePHS)
+    Store = &SpectrumPHVec[Channel];
+
+  size_t NumValues = (Store) ? Store->size() : 0;
+
+  // Apply the per-slice gain drift correction if it has been
+  // requested and was computed for the present store
+  Bool_t CorrectGainDrift = (ADAQSettings->UseGainDriftCorrection and
+			     GainDriftCorrectionValid(Channel, Store));
   
-  for(; It!=ItE; It++){
+  for(size_t v=0; v<NumValues; v++){
 
     // If using SMS or WD algorithms, histogram only the number of
-    // waveforms specified by user; note that if using PF algorithm,
+    // waveforms processed by the last run (the number specified by
+    // the user, all waveforms for a preview, or fewer if the run was
+    // cancelled); note that if using PF algorithm,
     // all pulse heights/areas will be histogrammed regardless of user
     // specifications to account for case of multiple values per
     // waveforms, in which case values>waveforms-specified. This
@@ -1501,10 +1704,13 @@ void AAComputation::CreateSpectrum()
     // are used in the spectrum histogram.
 
     if(!ADAQSettings->ADAQSpectrumAlgorithmPF)
-      if((It-ItB) > ADAQSettings->WaveformsToHistogram)
+      if((Int_t)v > ProcessedWaveforms)
 	break;
 
-    Double_t Quantity = (*It);
+    Double_t Quantity = Store->At(v);
+
+    if(CorrectGainDrift)
+      Quantity *= GainDriftCorrections[v / GainDriftSliceSize];
 
     // Convert the quantity if calibration has been activated
     if(ADAQSettings->UseSpectraCalibrations[Channel]){
@@ -1516,14 +1722,116 @@ void AAComputation::CreateSpectrum()
     
     if(Quantity > ADAQSettings->SpectrumMinThresh and
        Quantity < ADAQSettings->SpectrumMaxThresh)
-      Spectrum_H->Fill(Quantity);
+      SpectrumCounts.Fill(Quantity);
   }
+  SpectrumCounts.CopyToHistogram(Spectrum_H);
   SpectrumExists = true;
+  SpectrumVersion++;
 }
 
 
+// Method to integrate each of the peaks located by the peak finding
+// algorithm, storing the uncalibrated integrals and (for pulse area
+// spectra) adding the calibrated integrals to the spectrum
 void AAComputation::IntegratePeaks()
 {
+  const Int_t Channel = ADAQSettings->WaveformChannel;
+  Int_t Options = GetPeakKernelOptions(Channel, ADAQSettings->ADAQSpectrumTypePAS);
+  (this->*SelectKernel<IntegratePeaksKernels>(Options))(Channel);
+}
+
+
+// Method to find the maximum height of each of the peaks located by
+// the peak finding algorithm, storing the uncalibrated heights and
+// (for pulse height spectra) adding the calibrated heights to the
+// spectrum
+void AAComputation::FindPeakHeights()
+{
+  const Int_t Channel = ADAQSettings->WaveformChannel;
+  Int_t Options = GetPeakKernelOptions(Channel, ADAQSettings->ADAQSpectrumTypePHS);
+  (this->*SelectKernel<FindPeakHeightsKernels>(Options))(Channel);
+}
+
+
+////////////////////////
+// Processing kernels //
+////////////////////////
+
+// The kernel selector recursively compares the run-time options
+// against each compile-time instantiation from the highest option
+// value downwards; the recursion terminates at -1, which would only
+// be reached for invalid options
+template<class Family, Int_t O>
+struct AAComputation::KernelSelector{
+  static typename Family::Type Get(Int_t Options)
+  {
+    if(Options == O)
+      return Family::template Get<O>();
+    else
+      return KernelSelector<Family, O-1>::Get(Options);
+  }
+};
+
+
+template<class Family>
+struct AAComputation::KernelSelector<Family, -1>{
+  static typename Family::Type Get(Int_t)
+  { return NULL; }
+};
+
+
+template<class Family>
+typename Family::Type AAComputation::SelectKernel(Int_t Options)
+{ return KernelSelector<Family, zNumKernelOptions-1>::Get(Options); }
+
+
+// Method to compute the integral of a contiguous range of bins
+// directly from the bin content array of a histogram with NumCells
+// bins (including underflow and overflow). The bin range is treated
+// identically to TH1::Integral(First, Last): a negative first bin
+// starts from the underflow and an out-of-range or inverted last bin
+// ends at the overflow
+Double_t AAComputation::IntegrateBins(const Float_t *Array, Int_t NumCells,
+				      Int_t First, Int_t Last)
+{
+  if(First < 0)
+    First = 0;
+  if(Last >= NumCells or Last < First)
+    Last = NumCells - 1;
+
+  Double_t Integral = 0.;
+  for(Int_t bin=First; bin<=Last; bin++)
+    Integral += Array[bin];
+  
+  return Integral;
+}
+
+
+template<Int_t O>
+Double_t AAComputation::CalibrateKernel(Int_t Channel, Double_t Value)
+{
+  if(!(O & (zKernelCalibrationFit | zKernelCalibrationInterp)))
+    return Value;
+
+  Int_t Stage = ProcessingMetrics.Switch(zCalibrationStage);
+  
+  if(O & zKernelCalibrationFit)
+    Value = ADAQSettings->SpectraCalibrations[Channel]->Eval(Value);
+  else
+    Value = ADAQSettings->SpectraCalibrationData[Channel]->Eval(Value);
+
+  ProcessingMetrics.Switch(Stage);
+
+  return Value;
+}
+
+
+template<Int_t O>
+void AAComputation::IntegratePeaksKernel(Int_t Channel)
+{
+  const Float_t *Array = Waveform_H[Channel]->GetArray();
+  const Int_t NumCells = Waveform_H[Channel]->GetNcells();
+  
   // Iterate over each peak stored in the vector of PeakInfoStructs...
   vector<PeakInfoStruct>::iterator it;
   for(it=PeakInfoVec.begin(); it!=PeakInfoVec.end(); it++){
@@ -1531,14 +1839,13 @@ void AAComputation::IntegratePeaks()
     // If pileup rejection is begin used, examine the pileup flag
     // stored in each PeakInfoStruct to determine whether or not this
     // peak is part of a pileup events. If so, skip it...
-    //if(UsePileupRejection_CB->IsDown() and (*it).PileupFlag==true)
-    if(ADAQSettings->UsePileupRejection and (*it).PileupFlag==true)
+    if((O & zKernelPileup) and (*it).PileupFlag==true)
       continue;
     
     // If the PSD filter is desired, examine the PSD filter flag
     // stored in each PeakInfoStruct to determine whether or not this
     // peak should be filtered out of the spectrum.
-    if(UsePSDRegions[ADAQSettings->WaveformChannel] and (*it).PSDFilterFlag==true)
+    if((O & zKernelPSDRegion) and (*it).PSDFilterFlag==true)
       continue;
 
     // If the peak falls outside the user-specific waveform analysis
@@ -1549,37 +1856,37 @@ void AAComputation::IntegratePeaks()
     
     // ...and use the lower and upper peak limits to calculate the
     // integral under each waveform peak that has passed all criterion
-    Double_t PeakIntegral = Waveform_H[ADAQSettings->WaveformChannel]->Integral((*it).PeakLimit_Lower,
-										(*it).PeakLimit_Upper);
-    
-    Int_t Channel = ADAQSettings->WaveformChannel;
+    Double_t PeakIntegral = IntegrateBins(Array, NumCells,
+					  (*it).PeakLimit_Lower,
+					  (*it).PeakLimit_Upper);
     
     // Add the uncalibrated integral to the spectrum vector
     SpectrumPAVec[Channel].push_back(PeakIntegral);
-    
-    // If the user has calibrated the spectrum, then transform the
-    // peak integral in pulse units [ADC] to energy units
-    if(ADAQSettings->UseSpectraCalibrations[Channel]){
-      if(SpectraCalibrationType[Channel] == zCalibrationFit)
-	PeakIntegral = ADAQSettings->SpectraCalibrations[Channel]->Eval(PeakIntegral);
-      else if(SpectraCalibrationType[Channel] == zCalibrationInterp)
-	PeakIntegral = ADAQSettings->SpectraCalibrationData[Channel]->Eval(PeakIntegral);
-    }
-    
-    // Add the integral to the spectrum if a pulse area spectrum is
-    // desired to create the initial post-processing histogram
-    if(ADAQSettings->ADAQSpectrumTypePAS){
+
+    // Add the calibrated integral to the spectrum if a pulse area
+    // spectrum is desired to create the initial post-processing
+    // histogram
+    if(O & zKernelFill){
+      Int_t Stage = ProcessingMetrics.Switch(zFillStage);
+      
+      PeakIntegral = CalibrateKernel<O>(Channel, PeakIntegral);
+      
       if(PeakIntegral > ADAQSettings->SpectrumMinThresh and
-	 PeakIntegral < ADAQSettings->SpectrumMaxThresh){
-	Spectrum_H->Fill(PeakIntegral);
-      }
+	 PeakIntegral < ADAQSettings->SpectrumMaxThresh)
+	SpectrumCounts.Fill(PeakIntegral);
+
+      ProcessingMetrics.Switch(Stage);
     }
   }
 }
 
 
-void AAComputation::FindPeakHeights()
+template<Int_t O>
+void AAComputation::FindPeakHeightsKernel(Int_t Channel)
 {
+  const Float_t *Array = Waveform_H[Channel]->GetArray();
+  const Int_t NumCells = Waveform_H[Channel]->GetNcells();
+
   // Iterate over each peak stored in the vector of PeakInfoStructs...
   vector<PeakInfoStruct>::iterator it;
   for(it=PeakInfoVec.begin(); it!=PeakInfoVec.end(); it++){
@@ -1587,13 +1894,13 @@ void AAComputation::FindPeakHeights()
     // If pileup rejection is begin used, examine the pileup flag
     // stored in each PeakInfoStruct to determine whether or not this
     // peak is part of a pileup events. If so, skip it...
-    if(ADAQSettings->UsePileupRejection and (*it).PileupFlag==true)
+    if((O & zKernelPileup) and (*it).PileupFlag==true)
       continue;
 
     // If the PSD filter is desired, examine the PSD filter flag
     // stored in each PeakInfoStruct to determine whether or not this
     // peak should be filtered out of the spectrum.
-    if(UsePSDRegions[ADAQSettings->WaveformChannel] and (*it).PSDFilterFlag==true)
+    if((O & zKernelPSDRegion) and (*it).PSDFilterFlag==true)
       continue;
 
     // If the peak falls outside the user-specific waveform analysis
@@ -1605,141 +1912,914 @@ void AAComputation::FindPeakHeights()
     // Initialize the peak height for each peak region
     Double_t PeakHeight = 0.;
 
-    // Get the waveform processing channel number
-    Int_t Channel = ADAQSettings->WaveformChannel;
+    // Determine the maximum peak height over the samples from the
+    // lower limit up to (but excluding) the upper limit. Samples
+    // outside the waveform are clamped onto the underflow and
+    // overflow bins as by TH1::GetBinContent()
+    Int_t First = (*it).PeakLimit_Lower;
+    Int_t Last = (Int_t)ceil((*it).PeakLimit_Upper) - 1;
 
-    // Iterate over the samples between lower and upper integration
-    // limits to determine the maximum peak height
-    for(Int_t sample=(*it).PeakLimit_Lower; sample<(*it).PeakLimit_Upper; sample++){
-      if(Waveform_H[Channel]->GetBinContent(sample) > PeakHeight)
-	PeakHeight = Waveform_H[Channel]->GetBinContent(sample);
+    if(First <= Last){
+      First = min(max(First, 0), NumCells-1);
+      Last = max(min(Last, NumCells-1), 0);
+      
+      for(Int_t sample=First; sample<=Last; sample++)
+	if(Array[sample] > PeakHeight)
+	  PeakHeight = Array[sample];
     }
 
     // Add the uncalibrated peak height to the spectrum vector
     SpectrumPHVec[Channel].push_back(PeakHeight);
     
-    // If the user has calibrated the spectrum then transform the peak
-    // heights in pulse units [ADC] to energy
-    if(ADAQSettings->UseSpectraCalibrations[Channel]){
-      if(SpectraCalibrationType[Channel] == zCalibrationFit)
-	PeakHeight = ADAQSettings->SpectraCalibrations[Channel]->Eval(PeakHeight);
-      else if(SpectraCalibrationType[Channel] == zCalibrationInterp)
-	PeakHeight = ADAQSettings->SpectraCalibrationData[Channel]->Eval(PeakHeight);
+    // Add the calibrated peak height to the spectrum if a pulse
+    // height spectrum is desired to create the initial
+    // post-processing histogram
+    if(O & zKernelFill){
+      Int_t Stage = ProcessingMetrics.Switch(zFillStage);
+      
+      PeakHeight = CalibrateKernel<O>(Channel, PeakHeight);
+
+      if(PeakHeight > ADAQSettings->SpectrumMinThresh and
+	 PeakHeight < ADAQSettings->SpectrumMaxThresh)
+	SpectrumCounts.Fill(PeakHeight);
+
+      ProcessingMetrics.Switch(Stage);
     }
+  }
+}
+
+
+template<Int_t O>
+void AAComputation::CalculatePSDIntegralsKernel(Int_t Channel)
+{
+  const Float_t *Array = Waveform_H[Channel]->GetArray();
+  const Int_t NumCells = Waveform_H[Channel]->GetNcells();
+  
+  // Iterate over each peak stored in the vector of PeakInfoStructs...
+  vector<PeakInfoStruct>::iterator it;
+  for(it=PeakInfoVec.begin(); it!=PeakInfoVec.end(); it++){
     
-    // Add the integral to the spectrum if a pulse area spectrum is
-    // desired to create the initial post-processing histogram
-    if(ADAQSettings->ADAQSpectrumTypePHS){
-      if(PeakHeight > ADAQSettings->SpectrumMinThresh and
-	 PeakHeight < ADAQSettings->SpectrumMaxThresh){
-	Spectrum_H->Fill(PeakHeight);
-      }
+    // If the peak falls outside the user-specific waveform analysis
+    // region then filter this peak out of the spectrum
+    if((*it).PeakPosX < ADAQSettings->AnalysisRegionMin or
+       (*it).PeakPosX > ADAQSettings->AnalysisRegionMax)
+      continue;
+
+    // Get the peak position in time (x axis)
+    Double_t Peak = (*it).PeakPosX;
+
+    // Compute the total and tail integrals; note that the integral
+    // regions are truncated to whole samples as by TH1::Integral()
+    Double_t TotalIntegral = IntegrateBins(Array, NumCells,
+					   Peak + ADAQSettings->PSDTotalStart,
+					   Peak + ADAQSettings->PSDTotalStop);
+    
+    Double_t TailIntegral = IntegrateBins(Array, NumCells,
+					  Peak + ADAQSettings->PSDTailStart,
+					  Peak + ADAQSettings->PSDTailStop);
+    
+    // Store the values in the member data vectors
+    PSDHistogramTotalVec[Channel].push_back(TotalIntegral);
+    PSDHistogramTailVec[Channel].push_back(TailIntegral);
+    
+    // If the user wants to plot (Tail integral / Total integral) on
+    // the y-axis of the PSD histogram then modify the TailIntegral
+    if(O & zKernelTailTotal)
+      TailIntegral /= TotalIntegral;
+    
+    // If the user wants to plot the X-axis (PSD total integral) in
+    // energy [MeVee] then use the spectra calibrations
+    TotalIntegral = CalibrateKernel<O>(Channel, TotalIntegral);
+    
+    // If the user has enabled a PSD filter then apply the PSD filter
+    // to the waveform. If the waveform does not pass the filter, mark
+    // the flag indicating that it should be filtered out due to its
+    // pulse shape
+    if(O & zKernelPSDRegion)
+      if(ApplyPSDRegion(TotalIntegral, TailIntegral))
+	(*it).PSDFilterFlag = true;
+    
+    // The total integral of the waveform must exceed the PSDThreshold
+    // in order to be histogrammed
+    if(O & zKernelFill){
+      Int_t Stage = ProcessingMetrics.Switch(zFillStage);
+      
+      if(TotalIntegral > ADAQSettings->PSDThreshold and
+	 (*it).PSDFilterFlag == false)
+	PSDHistogramCounts.Fill(TotalIntegral, TailIntegral);
+
+      ProcessingMetrics.Switch(Stage);
     }
   }
 }
 
 
-void AAComputation::UpdateProcessingProgress(int Waveform)
+template<Int_t O>
+void AAComputation::FillPulseKernel(Int_t Channel, Double_t PulseHeight, Double_t PulseArea)
 {
-#ifndef MPI_ENABLED
-  if(Waveform > 0)
-    ProcessingProgressBar->Increment(ADAQSettings->UpdateFreq);
-#else
-  if(Waveform == 0)
-    cout << "\n\n"; 
-  else
-    cout << "\rADAQAnalysis_MPI Node[0] : Estimated progress = " 
-	 << setprecision(2)
-	 << (Waveform*100./WaveformEnd) << "%"
-	 << "       "
-	 << flush;
-#endif
+  // Add the uncalibrated pulse height and area to the storage
+  // vectors for potential later use
+  SpectrumPHVec[Channel].push_back(PulseHeight);
+  SpectrumPAVec[Channel].push_back(PulseArea);
+
+  // Determine the calibrated pulse height/area value for analysis
+  Double_t Quantity = CalibrateKernel<O>(Channel, (O & zKernelPAS) ? PulseArea : PulseHeight);
+  
+  // Fill the spectrum if the quantity is within thresholds
+  if(Quantity > ADAQSettings->SpectrumMinThresh and
+     Quantity < ADAQSettings->SpectrumMaxThresh)
+    SpectrumCounts.Fill(Quantity);
 }
 
 
-// Method to compute a background of a TH1F object representing a
-// detector pulse height / energy spectrum.
-void AAComputation::CalculateSpectrumBackground()//TH1F *Spectrum_H)
+// Method to determine the calibration kernel options for a channel
+Int_t AAComputation::GetCalibrationKernelOptions(Int_t Channel)
 {
-  // raw = original spectrum for which background is calculated 
-  // background = background component of raw spectrum
-  // deconvolved = raw spectrum less background spectrum
+  Int_t Options = 0;
+  
+  if(ADAQSettings->UseSpectraCalibrations[Channel]){
+    if(SpectraCalibrationType[Channel] == zCalibrationFit)
+      Options |= zKernelCalibrationFit;
+    else if(SpectraCalibrationType[Channel] == zCalibrationInterp)
+      Options |= zKernelCalibrationInterp;
+  }
+  
+  return Options;
+}
 
 
-  // Clone the Spectrum_H object and give the clone a unique name
-  TH1F *SpectrumClone_H = (TH1F *)Spectrum_H->Clone("SpectrumClone_H");
+// Method to determine the peak integral and peak height kernel
+// options, with the spectrum filled if desired
+Int_t AAComputation::GetPeakKernelOptions(Int_t Channel, Bool_t Fill)
+{
+  Int_t Options = GetCalibrationKernelOptions(Channel);
   
-  // Set the range of the Spectrum_H clone to correspond to the range
-  // that the user has specified to calculate the background over
-  SpectrumClone_H->GetXaxis()->SetRangeUser(ADAQSettings->BackgroundMinBin,
-					    ADAQSettings->BackgroundMaxBin);
+  if(Fill)
+    Options |= zKernelFill;
   
-  // Delete and recreate the TSpectrum peak finder object
-  if(PeakFinder) delete PeakFinder;
-  PeakFinder = new TSpectrum(5);
+  if(UsePSDRegions[Channel])
+    Options |= zKernelPSDRegion;
   
-  // ZSH: This widget has been disabled for lack of use. Presently, I
-  //       have hardcoded a rather unimportant (Ha! This will come
-  //       back to bite you in the ass, I'm sure of it) "5" above in
-  //       place since it doesn't affect the backgroud calculation.
-  //
-  // PeakFinder = new TSpectrum(SpectrumNumPeaks_NEL->GetEntry()->GetIntNumber());
+  if(ADAQSettings->UsePileupRejection)
+    Options |= zKernelPileup;
+  
+  return Options;
+}
 
-  // Delete the TH1F object that holds a previous background histogram
-  if(SpectrumBackground_H){
-    delete SpectrumBackground_H;
-    SpectrumBackgroundExists = false;
+
+// Method to determine the PSD integral kernel options, with the PSD
+// histogram filled if desired
+Int_t AAComputation::GetPSDKernelOptions(Int_t Channel, Bool_t Fill)
+{
+  Int_t Options = 0;
+
+  if(ADAQSettings->PSDXAxisEnergy)
+    Options |= GetCalibrationKernelOptions(Channel);
+  
+  if(Fill)
+    Options |= zKernelFill;
+  
+  if(ADAQSettings->UsePSDRegions[Channel])
+    Options |= zKernelPSDRegion;
+  
+  if(ADAQSettings->PSDYAxisTailTotal)
+    Options |= zKernelTailTotal;
+  
+  return Options;
+}
+
+
+// Method to determine the pulse kernel options used by the waveform
+// data and simple maximum/sum spectrum algorithms
+Int_t AAComputation::GetPulseKernelOptions(Int_t Channel)
+{
+  Int_t Options = GetCalibrationKernelOptions(Channel);
+  
+  if(ADAQSettings->ADAQSpectrumTypePAS)
+    Options |= zKernelPAS;
+  
+  return Options;
+}
+
+
+// Method to select the kernels used by the waveform processing loops
+// from the present settings. This must be called once per processing
+// job before the waveform loop since the settings are then fixed for
+// the duration of the loop
+void AAComputation::SelectProcessingKernels(Bool_t FillPSDHistogram)
+{
+  const Int_t Channel = ADAQSettings->WaveformChannel;
+  
+  IntegratePeaks_K =
+    SelectKernel<IntegratePeaksKernels>(GetPeakKernelOptions(Channel, ADAQSettings->ADAQSpectrumTypePAS));
+  
+  FindPeakHeights_K =
+    SelectKernel<FindPeakHeightsKernels>(GetPeakKernelOptions(Channel, ADAQSettings->ADAQSpectrumTypePHS));
+  
+  CalculatePSDIntegrals_K =
+    SelectKernel<CalculatePSDIntegralsKernels>(GetPSDKernelOptions(Channel, FillPSDHistogram));
+  
+  FillPulse_K =
+    SelectKernel<FillPulseKernels>(GetPulseKernelOptions(Channel));
+}
+
+
+void AAComputation::SetKernelInput(Int_t Channel, TH1F *H, const vector<PeakInfoStruct> &Peaks)
+{
+  Waveform_H[Channel] = H;
+  PeakInfoVec = Peaks;
+}
+
+
+TH1F *AAComputation::GetKernelWaveform(Int_t Channel)
+{ return Waveform_H[Channel]; }
+
+
+void AAComputation::InitializePulseStores(Int_t Channel, Int_t Precision)
+{
+  SpectrumPHVec[Channel].Initialize(Precision, false);
+  SpectrumPAVec[Channel].Initialize(Precision, false);
+  PSDHistogramTotalVec[Channel].Initialize(Precision, false);
+  PSDHistogramTailVec[Channel].Initialize(Precision, false);
+}
+
+
+void AAComputation::InitializeAccumulators()
+{
+  SpectrumCounts.Initialize(ADAQSettings->SpectrumNumBins,
+			    ADAQSettings->SpectrumMinBin,
+			    ADAQSettings->SpectrumMaxBin);
+  
+  PSDHistogramCounts.Initialize(ADAQSettings->PSDNumTotalBins,
+				ADAQSettings->PSDMinTotalBin,
+				ADAQSettings->PSDMaxTotalBin,
+				ADAQSettings->PSDNumTailBins,
+				ADAQSettings->PSDMinTailBin,
+				ADAQSettings->PSDMaxTailBin);
+}
+
+
+const AAPulseStore &AAComputation::GetPSDTotalStore(Int_t Channel)
+{ return PSDHistogramTotalVec[Channel]; }
+
+
+const AAPulseStore &AAComputation::GetPSDTailStore(Int_t Channel)
+{ return PSDHistogramTailVec[Channel]; }
+
+
+void AAComputation::RunIntegratePeaksKernel(Int_t Channel)
+{ (this->*IntegratePeaks_K)(Channel); }
+
+
+void AAComputation::RunFindPeakHeightsKernel(Int_t Channel)
+{ (this->*FindPeakHeights_K)(Channel); }
+
+
+void AAComputation::RunCalculatePSDIntegralsKernel(Int_t Channel)
+{ (this->*CalculatePSDIntegrals_K)(Channel); }
+
+
+void AAComputation::RunFillPulseKernel(Int_t Channel, Double_t PulseHeight, Double_t PulseArea)
+{ (this->*FillPulse_K)(Channel, PulseHeight, PulseArea); }
+
+
+// Method to create one spectrum for each of a set of waveform
+// extraction parameter variants (floor, sigma, resolution, baseline
+// region, and analysis region) in a single pass over the waveforms
+// such that peak finder parameters can be tuned without repeatedly
+// processing the entire data set. Each waveform is read from the
+// ADAQ TTree once and all variants are applied while it remains in
+// memory. Variants sharing a baseline region share the calculated
+// waveform; variants that further share the peak finding parameters
+// share the located peaks and their heights or areas, differing only
+// in the peaks that fall within their analysis regions. The time
+// spent on shared work is divided equally between the variants that
+// share it. All other settings are taken from the present settings.
+// The sweep is run as a background job (see zSettingsSweepJob) such
+// that the settings it modifies cannot be replaced while it runs,
+// and it may be cancelled
+Bool_t AAComputation::SweepSpectrumSettings(vector<SettingsVariantStruct> Variants)
+{
+  ClearSettingsSweep();
+
+  if(!SequentialArchitecture or !ADAQFileLoaded or Variants.empty())
+    return false;
+
+  // Stored waveform data does not depend on the extraction parameters
+  if(ADAQSettings->ADAQSpectrumAlgorithmWD)
+    return false;
+
+  const Int_t NumVariants = Variants.size();
+  
+  for(Int_t v=0; v<NumVariants; v++)
+    if(Variants[v].BaselineRegionMin < 0 or
+       Variants[v].BaselineRegionMax <= Variants[v].BaselineRegionMin)
+      return false;
+  
+  const Int_t Channel = ADAQSettings->WaveformChannel;
+  const Bool_t PeakFinding = ADAQSettings->ADAQSpectrumAlgorithmPF;
+
+  // Group the variants by baseline region and, within each baseline
+  // group, by peak finding parameters such that Groups[b][p] holds
+  // the indices of the variants sharing both. Note that the peak
+  // finding parameters are irrelevant to the simple max/sum algorithm
+  
+  vector< vector< vector<Int_t> > > Groups;
+  vector< vector<Int_t> > BaselineMembers;
+  
+  for(Int_t v=0; v<NumVariants; v++){
+    const SettingsVariantStruct &V = Variants[v];
+    
+    size_t b = 0;
+    for(; b<Groups.size(); b++){
+      const SettingsVariantStruct &B = Variants[Groups[b][0][0]];
+      if(B.BaselineRegionMin == V.BaselineRegionMin and
+	 B.BaselineRegionMax == V.BaselineRegionMax)
+	break;
+    }
+    if(b == Groups.size()){
+      Groups.push_back(vector< vector<Int_t> >());
+      BaselineMembers.push_back(vector<Int_t>());
+    }
+    
+    size_t p = 0;
+    for(; p<Groups[b].size(); p++){
+      const SettingsVariantStruct &P = Variants[Groups[b][p][0]];
+      if(!PeakFinding or (P.Floor == V.Floor and P.Sigma == V.Sigma and
+			  P.Resolution == V.Resolution))
+	break;
+    }
+    if(p == Groups[b].size())
+      Groups[b].push_back(vector<Int_t>());
+    
+    Groups[b][p].push_back(v);
+    BaselineMembers[b].push_back(v);
   }
 
-  // Use the TSpectrum::Background() method to compute the spectrum
-  // background; Set the resulting TH1F objects graphic attributes
+  // Create one spectrum per variant with the present binning
 
-  int Iterations = ADAQSettings->BackgroundIterations;
+  for(Int_t v=0; v<NumVariants; v++){
+    const SettingsVariantStruct &V = Variants[v];
+    
+    stringstream Name, Title;
+    Name << "SettingsSweep" << v << "_H";
+    Title << "F=" << V.Floor << " S=" << V.Sigma << " R=" << V.Resolution
+	  << " B=" << V.BaselineRegionMin << ":" << V.BaselineRegionMax
+	  << " A=" << V.AnalysisRegionMin << ":" << V.AnalysisRegionMax;
+    
+    SettingsSweepSpectra_H.push_back(new TH1F(Name.str().c_str(), Title.str().c_str(),
+					      ADAQSettings->SpectrumNumBins,
+					      ADAQSettings->SpectrumMinBin,
+					      ADAQSettings->SpectrumMaxBin));
 
-  string Compton = "";
-  if(ADAQSettings->BackgroundCompton)
-    Compton = " Compton ";
+    SettingsSweepCounts.push_back(new AAHistogramAccumulator);
+    SettingsSweepCounts.back()->Initialize(ADAQSettings->SpectrumNumBins,
+					   ADAQSettings->SpectrumMinBin,
+					   ADAQSettings->SpectrumMaxBin);
+  }
 
-  string Smoothing = " nosmoothing ";
-  if(ADAQSettings->BackgroundSmoothing)
-    Smoothing = "";
+  // The variant parameters are applied through the settings object
+  // such that the existing peak finding methods may be used; the
+  // present settings are restored once the sweep is complete
+
+  SettingsVariantStruct Original;
+  Original.Floor = ADAQSettings->Floor;
+  Original.Sigma = ADAQSettings->Sigma;
+  Original.Resolution = ADAQSettings->Resolution;
+  Original.BaselineRegionMin = ADAQSettings->BaselineRegionMin;
+  Original.BaselineRegionMax = ADAQSettings->BaselineRegionMax;
+  Original.AnalysisRegionMin = ADAQSettings->AnalysisRegionMin;
+  Original.AnalysisRegionMax = ADAQSettings->AnalysisRegionMax;
+
+  Int_t OriginalTotalPeaks = TotalPeaks;
+
+  // The PSD region decision is taken from the settings for every
+  // variant. The PSD integrals skip peaks outside the analysis region
+  // in the settings, which is therefore set to the union of the
+  // variant analysis regions such that every peak is evaluated once;
+  // each variant then applies the decision only to the peaks within
+  // its own analysis region, as if it were processed individually
+  
+  const Bool_t UsePSDRegion = ADAQSettings->UsePSDRegions[Channel];
+  
+  for(Int_t v=0; v<NumVariants; v++){
+    if(v == 0 or Variants[v].AnalysisRegionMin < ADAQSettings->AnalysisRegionMin)
+      ADAQSettings->AnalysisRegionMin = Variants[v].AnalysisRegionMin;
+    if(v == 0 or Variants[v].AnalysisRegionMax > ADAQSettings->AnalysisRegionMax)
+      ADAQSettings->AnalysisRegionMax = Variants[v].AnalysisRegionMax;
+  }
+  
+  // Reboot the PeakFinder with up-to-date max peaks
+  if(PeakFinder) delete PeakFinder;
+  PeakFinder = new TSpectrum(ADAQSettings->MaxPeaks);
 
-  string Direction;
-  if(ADAQSettings->BackgroundDirection == 0)
-    Direction = " BackIncreasingWindow ";
-  else if(ADAQSettings->BackgroundDirection == 1)
-    Direction = " BackDecreasingWindow ";
+  WaveformStart = 0;
+  WaveformEnd = min((Int_t)ADAQWaveformTree->GetEntries(), ADAQSettings->WaveformsToHistogram);
+
+  ProcessingTotal.store(WaveformEnd - WaveformStart);
+
+  vector<Double_t> Times(NumVariants, 0.);
+  vector<Double_t> PeakValues, Quantities;
+  vector<Bool_t> PeakAccepted;
+  
+  for(Int_t waveform=WaveformStart; waveform<WaveformEnd; waveform++){
+
+    // Publish the progress and stop at the next chunk boundary if
+    // the job has been cancelled
+    if(ProcessingInThread and !ContinueProcessing(waveform-WaveformStart+1))
+      break;
+
+    chrono::steady_clock::time_point Start = chrono::steady_clock::now();
+    
+    ADAQWaveformTree->GetEntry(waveform);
+    
+    RawVoltage = *Waveforms[Channel];
+
+    Double_t Elapsed = chrono::duration<Double_t>(chrono::steady_clock::now() - Start).count();
+    for(Int_t v=0; v<NumVariants; v++)
+      Times[v] += Elapsed / NumVariants;
+    
+    if(RawVoltage.empty())
+      continue;
+    
+    for(size_t b=0; b<Groups.size(); b++){
+
+      Start = chrono::steady_clock::now();
+      
+      const SettingsVariantStruct &B = Variants[Groups[b][0][0]];
+      ADAQSettings->BaselineRegionMin = B.BaselineRegionMin;
+      ADAQSettings->BaselineRegionMax = B.BaselineRegionMax;
+      
+      if(ADAQSettings->RawWaveform or ADAQSettings->BSWaveform)
+	FillBSWaveform(Channel, RawVoltage);
+      else if(ADAQSettings->ZSWaveform)
+	FillZSWaveform(Channel, RawVoltage);
+
+      TH1F *SweepWaveform_H = Waveform_H[Channel];
+      const Int_t NumBins = SweepWaveform_H->GetNbinsX();
+      const Float_t *Contents = SweepWaveform_H->GetArray();
+
+      // For the simple max/sum algorithm the PSD region decision
+      // depends only upon the waveform and is shared by the group;
+      // it applies to the variants whose analysis region contains
+      // the waveform maximum
+      
+      Bool_t PSDFlagged = false;
+      Double_t PSDPeakPos = 0.;
+      if(!PeakFinding and UsePSDRegion){
+	FindPeaks(SweepWaveform_H, zWholeWaveform);
+	CalculatePSDIntegrals(false);
+	PSDFlagged = PeakInfoVec[0].PSDFilterFlag;
+	PSDPeakPos = PeakInfoVec[0].PeakPosX;
+      }
+      
+      Elapsed = chrono::duration<Double_t>(chrono::steady_clock::now() - Start).count();
+      for(size_t m=0; m<BaselineMembers[b].size(); m++)
+	Times[BaselineMembers[b][m]] += Elapsed / BaselineMembers[b].size();
+      
+      for(size_t p=0; p<Groups[b].size(); p++){
+	const vector<Int_t> &Members = Groups[b][p];
+
+	// Locate the peaks and compute the height or area of each
+	// once for all variants sharing the peak finding parameters
+	
+	Bool_t PeaksFound = false;
+	
+	if(PeakFinding){
+	  Start = chrono::steady_clock::now();
+
+	  const SettingsVariantStruct &P = Variants[Members[0]];
+	  ADAQSettings->Floor = P.Floor;
+	  ADAQSettings->Sigma = P.Sigma;
+	  ADAQSettings->Resolution = P.Resolution;
+	  
+	  PeaksFound = FindPeaks(SweepWaveform_H, zPeakFinder);
+
+	  if(PeaksFound and UsePSDRegion)
+	    CalculatePSDIntegrals(false);
+	  
+	  PeakValues.assign(PeakInfoVec.size(), 0.);
+	  PeakAccepted.assign(PeakInfoVec.size(), false);
+	  
+	  for(size_t peak=0; PeaksFound and peak<PeakInfoVec.size(); peak++){
+	    const PeakInfoStruct &Peak = PeakInfoVec[peak];
+	    
+	    if(ADAQSettings->UsePileupRejection and Peak.PileupFlag)
+	      continue;
+	    
+	    if(UsePSDRegion and Peak.PSDFilterFlag)
+	      continue;
+	    
+	    if(ADAQSettings->ADAQSpectrumTypePAS)
+	      PeakValues[peak] = SweepWaveform_H->Integral(Peak.PeakLimit_Lower, Peak.PeakLimit_Upper);
+	    else if(ADAQSettings->ADAQSpectrumTypePHS){
+	      for(Int_t sample=Peak.PeakLimit_Lower; sample<Peak.PeakLimit_Upper; sample++)
+		if(SweepWaveform_H->GetBinContent(sample) > PeakValues[peak])
+		  PeakValues[peak] = SweepWaveform_H->GetBinContent(sample);
+	    }
+	    PeakAccepted[peak] = true;
+	  }
+
+	  Elapsed = chrono::duration<Double_t>(chrono::steady_clock::now() - Start).count();
+	  for(size_t m=0; m<Members.size(); m++)
+	    Times[Members[m]] += Elapsed / Members.size();
+
+	  if(!PeaksFound)
+	    continue;
+	}
+
+	for(size_t m=0; m<Members.size(); m++){
+	  Start = chrono::steady_clock::now();
+
+	  const Int_t v = Members[m];
+	  const SettingsVariantStruct &V = Variants[v];
+
+	  Quantities.clear();
+	  
+	  // Peak finding: accept the peaks within the analysis region
+	  
+	  if(PeakFinding){
+	    for(size_t peak=0; peak<PeakInfoVec.size(); peak++){
+	      if(!PeakAccepted[peak] or
+		 PeakInfoVec[peak].PeakPosX < V.AnalysisRegionMin or
+		 PeakInfoVec[peak].PeakPosX > V.AnalysisRegionMax)
+		continue;
+	      Quantities.push_back(PeakValues[peak]);
+	    }
+	  }
+
+	  // Simple max/sum: the maximum or sum of the bins within the
+	  // analysis region, with the bin range treated as by
+	  // TAxis::SetRange (height) and TH1::GetBinContent (area)
+
+	  else{
+	    if(PSDFlagged and
+	       PSDPeakPos >= V.AnalysisRegionMin and
+	       PSDPeakPos <= V.AnalysisRegionMax){
+	      Times[v] += chrono::duration<Double_t>(chrono::steady_clock::now() - Start).count();
+	      continue;
+	    }
+	    
+	    Double_t Quantity = 0.;
+	    
+	    if(ADAQSettings->ADAQSpectrumTypePHS){
+	      Int_t First = max(0, V.AnalysisRegionMin);
+	      Int_t Last = min(NumBins+1, V.AnalysisRegionMax);
+	      if(Last < First){
+		First = 1;
+		Last = NumBins;
+	      }
+	      Quantity = Contents[First];
+	      for(Int_t sample=First+1; sample<=Last; sample++)
+		if(Contents[sample] > Quantity)
+		  Quantity = Contents[sample];
+	    }
+	    else if(ADAQSettings->ADAQSpectrumTypePAS){
+	      Int_t First = max(0, V.AnalysisRegionMin);
+	      Int_t Last = min(NumBins+1, V.AnalysisRegionMax);
+	      for(Int_t sample=First; sample<=Last; sample++)
+		Quantity += Contents[sample];
+	    }
+	    Quantities.push_back(Quantity);
+	  }
+
+	  for(size_t q=0; q<Quantities.size(); q++){
+	    Double_t Quantity = Quantities[q];
+	    
+	    if(ADAQSettings->UseSpectraCalibrations[Channel]){
+	      if(SpectraCalibrationType[Channel] == zCalibrationFit)
+		Quantity = ADAQSettings->SpectraCalibrations[Channel]->Eval(Quantity);
+	      else if(SpectraCalibrationType[Channel] == zCalibrationInterp)
+		Quantity = ADAQSettings->SpectraCalibrationData[Channel]->Eval(Quantity);
+	    }
+	    
+	    if(Quantity > ADAQSettings->SpectrumMinThresh and
+	       Quantity < ADAQSettings->SpectrumMaxThresh)
+	      SettingsSweepCounts[v]->Fill(Quantity);
+	  }
+	  
+	  Times[v] += chrono::duration<Double_t>(chrono::steady_clock::now() - Start).count();
+	}
+      }
+    }
+  }
+
+  for(Int_t v=0; v<NumVariants; v++)
+    SettingsSweepCounts[v]->CopyToHistogram(SettingsSweepSpectra_H[v]);
+
+  ADAQSettings->Floor = Original.Floor;
+  ADAQSettings->Sigma = Original.Sigma;
+  ADAQSettings->Resolution = Original.Resolution;
+  ADAQSettings->BaselineRegionMin = Original.BaselineRegionMin;
+  ADAQSettings->BaselineRegionMax = Original.BaselineRegionMax;
+  ADAQSettings->AnalysisRegionMin = Original.AnalysisRegionMin;
+  ADAQSettings->AnalysisRegionMax = Original.AnalysisRegionMax;
+
+  TotalPeaks = OriginalTotalPeaks;
+  
+  SettingsSweepVariants = Variants;
+  SettingsSweepTimes = Times;
+  SettingsSweepExists = true;
+  
+  return true;
+}
+
+
+void AAComputation::ClearSettingsSweep()
+{
+  for(size_t s=0; s<SettingsSweepSpectra_H.size(); s++){
+    delete SettingsSweepSpectra_H[s];
+    delete SettingsSweepCounts[s];
+  }
+  SettingsSweepSpectra_H.clear();
+  SettingsSweepCounts.clear();
+  SettingsSweepVariants.clear();
+  SettingsSweepTimes.clear();
+  SettingsSweepExists = false;
+}
+
+
+void AAComputation::UpdateProcessingProgress(int Waveform)
+{
+#ifndef MPI_ENABLED
+  // The progress bar is updated from the GUI thread when processing
+  // in the background thread (see ContinueProcessing)
+  if(ProcessingInThread)
+    return;
+  
+  if(Waveform > 0)
+    ProcessingProgressBar->Increment(ADAQSettings->UpdateFreq);
+#else
+  if(Waveform == 0)
+    cout << "\n\n"; 
+  else
+    cout << "\rADAQAnalysis_MPI Node[0] : Estimated progress = " 
+	 << setprecision(2)
+	 << (Waveform*100./WaveformEnd) << "%"
+	 << "       "
+	 << flush;
+#endif
+}
+
+
+// Method to start one of the waveform processing jobs (spectrum
+// creation, PSD histogram creation, or desplicing) in a background
+// thread such that the GUI remains responsive while processing. The
+// worker thread communicates with the GUI solely through atomic
+// progress counters and flags, which are polled by the GUI to update
+// the progress bar and to detect when the job has finished. The
+// settings and all processing data members must not be modified by
+// the GUI until FinishProcessingThread() has been called
+Bool_t AAComputation::StartProcessingThread(Int_t Job)
+{
+  if(ProcessingActive.load() or !ADAQFileLoaded)
+    return false;
+
+  // Join a previously finished job that has not been collected
+  FinishProcessingThread();
+  
+  ProcessingJob.store(Job);
+  ProcessingDone.store(0);
+  ProcessingTotal.store(0);
+  ProcessingCancelled.store(false);
+  ProcessingSnapshotReady.store(false);
+  ProcessingActive.store(true);
+  ProcessingInThread = true;
+
+  // The snapshot histogram is recreated with the binning of the job
+  delete ProcessingSnapshot_H;
+  ProcessingSnapshot_H = NULL;
+
+  // ROOT I/O from more than one thread requires the global locks
+  ROOT::EnableThreadSafety();
+  
+  ProcessingThread = new boost::thread(&AAComputation::ProcessingThreadWorker, this, Job);
+
+  return true;
+}
+
+
+void AAComputation::ProcessingThreadWorker(Int_t Job)
+{
+  if(Job == zSpectrumProcessingJob)
+    ProcessSpectrumWaveforms();
+  else if(Job == zPSDHistogramProcessingJob)
+    ProcessPSDHistogramWaveforms();
+  else if(Job == zDesplicingProcessingJob)
+    CreateDesplicedFile();
+  else if(Job == zPSDWindowOptimizationJob)
+    OptimizePSDWindows(PSDWindowScan);
+  else if(Job == zSettingsSweepJob)
+    SweepSpectrumSettings(SettingsSweep);
+
+  ProcessingActive.store(false);
+}
+
+
+// Method to join the worker thread once the job has finished. This
+// returns false (without blocking) while the job remains active
+Bool_t AAComputation::FinishProcessingThread()
+{
+  if(ProcessingActive.load())
+    return false;
+
+  if(ProcessingThread){
+    ProcessingThread->join();
+    delete ProcessingThread;
+    ProcessingThread = NULL;
+  }
+  ProcessingInThread = false;
+
+  return true;
+}
+
+
+// Method to request that the active job stops at the next chunk
+// boundary. The results accumulated up to that point are retained
+void AAComputation::CancelProcessing()
+{ ProcessingCancelled.store(true); }
+
+
+Bool_t AAComputation::GetProcessingActive()
+{ return ProcessingActive.load(); }
+
+
+Bool_t AAComputation::GetProcessingCancelled()
+{ return ProcessingCancelled.load(); }
+
+
+Int_t AAComputation::GetProcessingJob()
+{ return ProcessingJob.load(); }
+
+
+Double_t AAComputation::GetProcessingFraction()
+{
+  Long64_t Total = ProcessingTotal.load(memory_order_relaxed);
+  if(Total <= 0)
+    return 0.;
+  
+  return min(1., ProcessingDone.load(memory_order_relaxed) * 1. / Total);
+}
+
+
+// Method to create the order in which the entries of the waveform
+// tree are processed in preview mode. The TTree clusters are visited
+// in a random permutation and the entries within each cluster are
+// visited in order such that each cluster is read and decompressed
+// only once. The permutation uses a fixed seed so that previews are
+// reproducible
+vector<Int_t> AAComputation::CreatePreviewOrder(Long64_t Entries)
+{
+  vector<Long64_t> ClusterStarts;
+  
+  TTree::TClusterIterator Clusters = ADAQWaveformTree->GetClusterIterator(0);
+  Long64_t Start = 0;
+  while((Start = Clusters()) < Entries)
+    ClusterStarts.push_back(Start);
+  ClusterStarts.push_back(Entries);
+
+  // Fisher-Yates shuffle of the cluster order
+  vector<Int_t> ClusterOrder(ClusterStarts.size() - 1);
+  for(size_t c=0; c<ClusterOrder.size(); c++)
+    ClusterOrder[c] = c;
+
+  TRandom3 PreviewRNG(PreviewSeed);
+  for(Int_t c=ClusterOrder.size()-1; c>0; c--)
+    swap(ClusterOrder[c], ClusterOrder[PreviewRNG.Integer(c+1)]);
+  
+  vector<Int_t> Order;
+  Order.reserve(Entries);
+  for(size_t c=0; c<ClusterOrder.size(); c++)
+    for(Long64_t entry=ClusterStarts[ClusterOrder[c]]; entry<ClusterStarts[ClusterOrder[c]+1]; entry++)
+      Order.push_back(entry);
+  
+  return Order;
+}
+
+
+Long64_t AAComputation::GetProcessingDone()
+{ return ProcessingDone.load(memory_order_relaxed); }
+
+
+// Method called from the GUI thread while a spectrum or PSD histogram
+// job runs in the background thread. The accumulator bins are atomic
+// and are only read here such that the snapshot is copied without
+// locking or otherwise stalling the worker, which keeps filling the
+// same bins; a snapshot may therefore include some but not all of the
+// fills made during the copy, which is immaterial for display
+Bool_t AAComputation::UpdateProcessingSnapshot()
+{
+  if(!ProcessingSnapshotReady.load(memory_order_acquire))
+    return false;
+
+  Bool_t PSDJob = (ProcessingJob.load() == zPSDHistogramProcessingJob);
+  
+  // The settings are not modified while the job runs (see
+  // AAInterface::SaveSettings) and provide the job's binning
+  if(!ProcessingSnapshot_H){
+    if(PSDJob)
+      ProcessingSnapshot_H = new TH2F("ProcessingSnapshot_H", "",
+				      ADAQSettings->PSDNumTotalBins, 
+				      ADAQSettings->PSDMinTotalBin,
+				      ADAQSettings->PSDMaxTotalBin,
+				      ADAQSettings->PSDNumTailBins,
+				      ADAQSettings->PSDMinTailBin,
+				      ADAQSettings->PSDMaxTailBin);
+    else
+      ProcessingSnapshot_H = new TH1F("ProcessingSnapshot_H", "",
+				      ADAQSettings->SpectrumNumBins, 
+				      ADAQSettings->SpectrumMinBin,
+				      ADAQSettings->SpectrumMaxBin);
+    
+    ProcessingSnapshot_H->SetDirectory(0);
+  }
+  
+  if(PSDJob)
+    PSDHistogramCounts.CopyToHistogram(ProcessingSnapshot_H);
+  else
+    SpectrumCounts.CopyToHistogram(ProcessingSnapshot_H);
+  
+  stringstream SS;
+  SS << (PSDJob ? "PSD histogram" : "Spectrum") << " in progress ("
+     << GetProcessingDone() << " of " << ProcessingTotal.load(memory_order_relaxed)
+     << " waveforms)";
+  ProcessingSnapshot_H->SetTitle(SS.str().c_str());
+
+  return true;
+}
 
-  stringstream ss;
 
-  string FilterOrder;
-  ss << " BackOrder" << ADAQSettings->BackgroundFilterOrder << " ";
-  FilterOrder = ss.str();
+// Method called by the worker thread for each waveform with the
+// number of waveforms processed so far. Returns false if the job has
+// been cancelled, which is checked once per chunk of waveforms
+Bool_t AAComputation::ContinueProcessing(Long64_t Done)
+{
+  ProcessingDone.store(Done, memory_order_relaxed);
+
+  if(Done % ProcessingChunkSize == 0)
+    return !ProcessingCancelled.load(memory_order_relaxed);
+  
+  return true;
+}
 
-  ss.str("");
 
-  string SmoothingWidth;
-  ss << " BackSmoothing" << ADAQSettings->BackgroundSmoothingWidth << " ";
-  SmoothingWidth = ss.str();
+// Method to compute a background of a TH1F object representing a
+// detector pulse height / energy spectrum.
+void AAComputation::CalculateSpectrumBackground()//TH1F *Spectrum_H)
+{
+  // raw = original spectrum for which background is calculated 
+  // background = background component of raw spectrum
+  // deconvolved = raw spectrum less background spectrum
 
-  string BackgroundOptionsString = Compton + Smoothing + Direction + FilterOrder + SmoothingWidth;
 
-  SpectrumBackground_H = (TH1F *)PeakFinder->Background(SpectrumClone_H, 
-							Iterations,
-							BackgroundOptionsString.c_str());
+  // Clone the Spectrum_H object and give the clone a unique name
+  TH1F *SpectrumClone_H = (TH1F *)Spectrum_H->Clone("SpectrumClone_H");
+  
+  // Set the range of the Spectrum_H clone to correspond to the range
+  // that the user has specified to calculate the background over
+  SpectrumClone_H->GetXaxis()->SetRangeUser(ADAQSettings->BackgroundMinBin,
+					    ADAQSettings->BackgroundMaxBin);
+  
+  // Delete the TH1F object that holds a previous background histogram
+  if(SpectrumBackground_H){
+    delete SpectrumBackground_H;
+    SpectrumBackgroundExists = false;
+  }
+
+  // Use the native SNIP background engine to compute the spectrum
+  // background. As with TSpectrum::Background(), the clipping runs
+  // over only the bins within the user-specified range and bins
+  // outside the range are set to zero. The engine caches its
+  // clipping passes such that changes to only the iterations or
+  // Compton option do not require recomputing the background
+  
+  Int_t FirstBin = SpectrumClone_H->GetXaxis()->GetFirst();
+  Int_t LastBin = SpectrumClone_H->GetXaxis()->GetLast();
+  
+  vector<Double_t> Contents(LastBin-FirstBin+1);
+  for(Int_t bin=FirstBin; bin<=LastBin; bin++)
+    Contents[bin-FirstBin] = Spectrum_H->GetBinContent(bin);
+  
+  BackgroundEngine.SetSpectrum(&Contents[0], Contents.size());
+  BackgroundEngine.SetOptions(ADAQSettings->BackgroundDirection,
+			      ADAQSettings->BackgroundFilterOrder,
+			      ADAQSettings->BackgroundSmoothing,
+			      ADAQSettings->BackgroundSmoothingWidth);
+
+  const vector<Double_t> &Background = BackgroundEngine.Calculate(ADAQSettings->BackgroundIterations,
+								  ADAQSettings->BackgroundCompton);
+  
+  SpectrumBackground_H = (TH1F *)Spectrum_H->Clone("SpectrumBackground_H");
+  SpectrumBackground_H->Reset();
+  for(Int_t bin=FirstBin; bin<=LastBin; bin++)
+    SpectrumBackground_H->SetBinContent(bin, Background[bin-FirstBin]);
+  
   SpectrumBackground_H->SetLineColor(2);
   SpectrumBackground_H->SetLineWidth(2);
 
-  // ZSH: The TSpectrum::Background() method sets the TH1F::Entries
-  // class member of the returned TH1F background object to the number
-  // of bins of the TH1F object for which the background is calculated
-  // NOT the actual integral of the resulting background histogram
-  // (including under/over flow bins). See TSpectrum.cxx Line 241 in
-  // the ROOT source code. Unclear if this is a bug or if this is done
-  // for statistical validity reasons. May post in ROOTTalk forum.
-  //
   // Set the TH1F::Entries variable to equal the full integral of the
-  // background TH1F object
+  // background TH1F object rather than the number of SetBinContent()
+  // calls (which is the behavior of TSpectrum::Background() as well)
   SpectrumBackground_H->SetEntries(SpectrumBackground_H->Integral(0, ADAQSettings->SpectrumNumBins+1));
   
   // Delete the TH1F object that holds a previous deconvolved TH1F
@@ -1791,6 +2871,107 @@ void AAComputation::CalculateSpectrumBackground()//TH1F *Spectrum_H)
 }
 
 
+// Method to bring a spectrum analysis product up to date. The
+// products form a small dependency graph: the background (and the
+// deconvolved spectrum) depends on the spectrum; the integral (and
+// Gaussian fit) depends on the spectrum or, when the background is
+// subtracted, on the background; and the derivative depends on the
+// spectrum. A product is recomputed only when one of the settings it
+// declares in GetSpectrumProductDependencies() or the version of an
+// upstream product has changed since it was last computed, such that
+// the graphics may request products every time they are plotted
+// without repeating the background or fit calculations
+Bool_t AAComputation::UpdateSpectrumProduct(Int_t Product)
+{
+  if(!SpectrumExists)
+    return false;
+
+  // Upstream products must be current before the dependencies of the
+  // requested product are evaluated
+  if(Product == zSpectrumIntegralProduct and ADAQSettings->PlotLessBackground)
+    UpdateSpectrumProduct(zSpectrumBackgroundProduct);
+
+  SpectrumProductStruct &State = SpectrumProducts[Product];
+  
+  vector<Double_t> Dependencies = GetSpectrumProductDependencies(Product);
+  
+  if(State.Valid and State.Dependencies == Dependencies)
+    return false;
+
+  switch(Product){
+  case zSpectrumBackgroundProduct:
+    CalculateSpectrumBackground();
+    break;
+
+  case zSpectrumIntegralProduct:
+    IntegrateSpectrum();
+    break;
+
+  case zSpectrumDerivativeProduct:
+    CalculateSpectrumDerivative();
+    break;
+
+  default:
+    return false;
+  }
+
+  State.Dependencies = Dependencies;
+  State.Version++;
+  State.Valid = true;
+
+  return true;
+}
+
+
+// Method to assemble the values on which a spectrum analysis product
+// depends. Any settings that are not listed here may change without
+// invalidating the product
+vector<Double_t> AAComputation::GetSpectrumProductDependencies(Int_t Product)
+{
+  // All products depend on the spectrum and its binning
+  vector<Double_t> Dependencies = {(Double_t)SpectrumVersion,
+				   (Double_t)ADAQSettings->SpectrumNumBins,
+				   ADAQSettings->SpectrumMinBin,
+				   ADAQSettings->SpectrumMaxBin};
+  
+  switch(Product){
+  case zSpectrumBackgroundProduct:
+    Dependencies.insert(Dependencies.end(),
+			{ADAQSettings->BackgroundMinBin,
+			 ADAQSettings->BackgroundMaxBin,
+			 (Double_t)ADAQSettings->BackgroundIterations,
+			 (Double_t)ADAQSettings->BackgroundCompton,
+			 (Double_t)ADAQSettings->BackgroundDirection,
+			 (Double_t)ADAQSettings->BackgroundFilterOrder,
+			 (Double_t)ADAQSettings->BackgroundSmoothing,
+			 (Double_t)ADAQSettings->BackgroundSmoothingWidth});
+    break;
+    
+  case zSpectrumIntegralProduct:
+    Dependencies.insert(Dependencies.end(),
+			{ADAQSettings->SpectrumIntegrationMin,
+			 ADAQSettings->SpectrumIntegrationMax,
+			 (Double_t)ADAQSettings->SpectrumFindIntegral,
+			 (Double_t)ADAQSettings->SpectrumIntegralInCounts,
+			 (Double_t)ADAQSettings->SpectrumUseGaussianFit,
+			 (Double_t)ADAQSettings->SpectrumUseVerboseFit,
+			 (Double_t)ADAQSettings->PlotLessBackground});
+    
+    if(ADAQSettings->PlotLessBackground)
+      Dependencies.push_back(SpectrumProducts[zSpectrumBackgroundProduct].Version);
+    break;
+
+  case zSpectrumDerivativeProduct:
+    Dependencies.insert(Dependencies.end(),
+			{(Double_t)ADAQSettings->PlotAbsValueSpectrumDerivative,
+			 (Double_t)ADAQSettings->PlotSpectrumDerivativeError});
+    break;
+  }
+  
+  return Dependencies;
+}
+
+
 // Method used to integrate a pulse / energy spectrum
 void AAComputation::IntegrateSpectrum()
 {
@@ -1997,62 +3178,88 @@ Bool_t AAComputation::WriteSpectrumFitResultsFile(string FName)
 
   // Get the gaussian fit parameters
 
-  Double_t Const = SpectrumFit_F->GetParameter(0);
-  Double_t ConstErr = SpectrumFit_F->GetParError(0);
+  SpectrumFitResultStruct Result;
+  
+  Result.Const = SpectrumFit_F->GetParameter(0);
+  Result.ConstErr = SpectrumFit_F->GetParError(0);
   
-  Double_t Mean = SpectrumFit_F->GetParameter(1);
-  Double_t MeanErr = SpectrumFit_F->GetParError(1);
+  Result.Mean = SpectrumFit_F->GetParameter(1);
+  Result.MeanErr = SpectrumFit_F->GetParError(1);
   
-  Double_t Sigma = SpectrumFit_F->GetParameter(2);
-  Double_t SigmaErr = SpectrumFit_F->GetParError(2);
+  Result.Sigma = SpectrumFit_F->GetParameter(2);
+  Result.SigmaErr = SpectrumFit_F->GetParError(2);
 
-  Double_t Res = 2.35 * Sigma / Mean * 100;
-  Double_t ResErr = Res * sqrt(pow(SigmaErr/Sigma,2) + pow(MeanErr/Mean,2));
+  Result.Res = 2.35 * Result.Sigma / Result.Mean * 100;
+  Result.ResErr = Result.Res * sqrt(pow(Result.SigmaErr/Result.Sigma,2) + pow(Result.MeanErr/Result.Mean,2));
 
   // Compute the covariance of constant / sigma
   
-  Double_t CovConstSigma = CovMatrix(2,0);
+  Result.CovConstSigma = CovMatrix(2,0);
 
-  // Compute the spectrum bin width
-  
-  Double_t Min = ADAQSettings->SpectrumMinBin;
-  Double_t Max = ADAQSettings->SpectrumMaxBin;
-  Double_t Range = Max - Min;
-  Double_t BinWidth = Range / ADAQSettings->SpectrumNumBins;
+  for(Int_t i=0; i<3; i++){
+    for(Int_t j=0; j<3; j++){
+      Result.Cov[i][j] = CovMatrix(i,j);
+      Result.Cor[i][j] = CorMatrix(i,j);
+    }
+  }
 
-  // Get the present time/date
+  Result.Integral = SpectrumIntegralValue;
+  Result.IntegralErr = SpectrumIntegralError;
 
-  time_t Time = chrono::system_clock::to_time_t(chrono::system_clock::now());
+  // Compute the spectrum bin width
+  
+  Result.SpectrumMin = ADAQSettings->SpectrumMinBin;
+  Result.SpectrumMax = ADAQSettings->SpectrumMaxBin;
+  Result.SpectrumBins = ADAQSettings->SpectrumNumBins;
+  Result.BinWidth = (Result.SpectrumMax - Result.SpectrumMin) / Result.SpectrumBins;
 
   // Output to file
     
   ofstream Out(FName.c_str(), ofstream::trunc);
 
+  WriteSpectrumFitResultsHeader(Out, FName);
+  WriteSpectrumFitResult(Out, Result);
+
+  return true;
+}
+
+
+void AAComputation::WriteSpectrumFitResultsHeader(ofstream &Out, string FName)
+{
+  // Get the present time/date
+
+  time_t Time = chrono::system_clock::to_time_t(chrono::system_clock::now());
+
   Out << setprecision(8);
 
   Out << "# File name : " << FName << "\n"
       << "# File date : " << ctime(&Time)
       << "# File desc : " << "Spectral analysis output from ADAQAnalysis\n"
       << "# ADAQ file : " << ADAQFileName << "\n"
-      << "\n"
-      << "# Spectrum information\n"
-      << "  Min : " << Min << "\n"
-      << "  Max : " << Max << "\n"
-      << " Bins : " << ADAQSettings->SpectrumNumBins << "\n"
-      << "Width : " << BinWidth << "\n"
+      << "\n";
+}
+
+
+void AAComputation::WriteSpectrumFitResult(ofstream &Out, SpectrumFitResultStruct &Result)
+{
+  Out << "# Spectrum information\n"
+      << "  Min : " << Result.SpectrumMin << "\n"
+      << "  Max : " << Result.SpectrumMax << "\n"
+      << " Bins : " << Result.SpectrumBins << "\n"
+      << "Width : " << Result.BinWidth << "\n"
       << "\n"
       << "# Gaussian fit parameters\n"
-      << "     Constant : " << Const << setw(15) << ConstErr << "\n"
-      << "         Mean : " << Mean << setw(15) << MeanErr << "\n"
-      << "        Sigma : " << Sigma << setw(15) << SigmaErr << "\n"
-      << "   Resolution : " << Res << setw(15) << ResErr << "\n"
-      << "CovConstSigma : " << CovConstSigma << "\n"
+      << "     Constant : " << Result.Const << setw(15) << Result.ConstErr << "\n"
+      << "         Mean : " << Result.Mean << setw(15) << Result.MeanErr << "\n"
+      << "        Sigma : " << Result.Sigma << setw(15) << Result.SigmaErr << "\n"
+      << "   Resolution : " << Result.Res << setw(15) << Result.ResErr << "\n"
+      << "CovConstSigma : " << Result.CovConstSigma << "\n"
       << "\n"
       << "# Gaussian fit correlation matrix\n";
   
   for(Int_t i=0; i<3; i++){
     for(Int_t j=0; j<3; j++){
-      Out << setw(15) << CorMatrix(i,j);
+      Out << setw(15) << Result.Cor[i][j];
     }
     Out << endl;
   }
@@ -2062,41 +3269,214 @@ Bool_t AAComputation::WriteSpectrumFitResultsFile(string FName)
   
   for(Int_t i=0; i<3; i++){
     for(Int_t j=0; j<3; j++){
-      Out << setw(15) << CovMatrix(i,j);
+      Out << setw(15) << Result.Cov[i][j];
     }
     Out << endl;
   }
    
   Out << "\n"
       << "# Gaussian fit integral\n"
-      << "Integral : " << SpectrumIntegralValue << setw(15) << SpectrumIntegralError << "\n"
+      << "Integral : " << Result.Integral << setw(15) << Result.IntegralErr << "\n"
       << endl;
+}
+
 
+// Method to fit one or more Gaussian peaks (with a linear or step
+// background) within each of the specified windows in each of the
+// specified spectra. Each spectrum/window combination is fit as an
+// independent job using AASpectrumFitter with the jobs distributed
+// across all available threads. The results are written to a single
+// file with one block per fitted peak in the same format as
+// WriteSpectrumFitResultsFile(), each preceded by the spectrum name,
+// fit window, and fit quality
+Bool_t AAComputation::BatchFitSpectra(vector<TH1F *> Spectra,
+				      vector<string> Names,
+				      vector<SpectrumFitWindowStruct> Windows,
+				      string FName)
+{
+  if(Spectra.empty() or Windows.empty())
+    return false;
+  
+  // Extract the bin centers/contents of all spectra such that no ROOT
+  // objects are accessed during the (threaded) fitting
+  
+  vector<SpectrumFitJob> Jobs;
+  
+  for(size_t s=0; s<Spectra.size(); s++){
+    
+    TH1F *H = Spectra[s];
+    const Int_t NumBins = H->GetNbinsX();
+    
+    vector<Double_t> Centers(NumBins), Contents(NumBins);
+    for(Int_t bin=1; bin<=NumBins; bin++){
+      Centers[bin-1] = H->GetBinCenter(bin);
+      Contents[bin-1] = H->GetBinContent(bin);
+    }
+    
+    for(size_t w=0; w<Windows.size(); w++){
+      SpectrumFitJob Job;
+      Job.Name = (s < Names.size()) ? Names[s] : H->GetName();
+      Job.Centers = Centers;
+      Job.Contents = Contents;
+      Job.BinWidth = H->GetBinWidth(1);
+      Job.Min = H->GetBinLowEdge(1);
+      Job.Max = H->GetBinLowEdge(NumBins+1);
+      Job.Bins = NumBins;
+      Job.Window = Windows[w];
+      Jobs.push_back(Job);
+    }
+  }
+  
+  Int_t NumThreads = boost::thread::hardware_concurrency();
+  if(NumThreads < 1)
+    NumThreads = 1;
+  if(NumThreads > (Int_t)Jobs.size())
+    NumThreads = Jobs.size();
+  
+  boost::thread_group Threads;
+  for(Int_t t=0; t<NumThreads; t++)
+    Threads.create_thread(boost::bind(&AAComputation::ProcessSpectrumFitJobs, this, &Jobs, t, NumThreads));
+  Threads.join_all();
+  
+  // Output the results of all jobs to file
+  
+  ofstream Out(FName.c_str(), ofstream::trunc);
+  
+  if(!Out.good())
+    return false;
+  
+  WriteSpectrumFitResultsHeader(Out, FName);
+  
+  for(size_t j=0; j<Jobs.size(); j++){
+    
+    if(Jobs[j].Results.empty()){
+      Out << "# Spectrum name : " << Jobs[j].Name << "\n"
+	  << "# Fit window    : " << Jobs[j].Window.Min << " - " << Jobs[j].Window.Max << "\n"
+	  << "# Fit failed (insufficient nonempty bins in the fit window)\n"
+	  << endl;
+      continue;
+    }
+    
+    for(size_t r=0; r<Jobs[j].Results.size(); r++){
+      SpectrumFitResultStruct &Result = Jobs[j].Results[r];
+      
+      Result.SpectrumName = Jobs[j].Name;
+      Result.SpectrumMin = Jobs[j].Min;
+      Result.SpectrumMax = Jobs[j].Max;
+      Result.SpectrumBins = Jobs[j].Bins;
+      
+      Out << "# Spectrum name : " << Result.SpectrumName << "\n"
+	  << "# Fit window    : " << Result.WindowMin << " - " << Result.WindowMax << "\n"
+	  << "# Fit peak      : " << Result.Peak+1 << " of " << Result.NumPeaks << "\n"
+	  << "# Fit quality   : " << Result.ChiSquare << " / " << Result.NDF
+	  << (Result.Converged ? "" : " (not converged)") << "\n"
+	  << "\n";
+      
+      WriteSpectrumFitResult(Out, Result);
+    }
+  }
+  
+  Out.close();
+  
   return true;
 }
 
 
+// Method to read the batch fit windows from a text file. Each
+// noncomment ('#') line specifies a single window as:
+//
+//   <min> <max> <number of peaks> <background: 0=none, 1=linear, 2=step>
+//
+vector<SpectrumFitWindowStruct> AAComputation::ReadSpectrumFitWindowsFile(string FName)
+{
+  vector<SpectrumFitWindowStruct> Windows;
+  
+  ifstream In(FName.c_str());
+  
+  string Line;
+  while(getline(In, Line)){
+    
+    if(Line.empty() or Line[0] == '#')
+      continue;
+    
+    stringstream SS(Line);
+    
+    SpectrumFitWindowStruct Window;
+    Window.NumPeaks = 1;
+    Window.Background = zLinearFitBackground;
+    
+    if(!(SS >> Window.Min >> Window.Max))
+      continue;
+    SS >> Window.NumPeaks >> Window.Background;
+    
+    if(Window.Max > Window.Min)
+      Windows.push_back(Window);
+  }
+  
+  return Windows;
+}
+
+
+// Method run by each thread during batch fitting to process every
+// Stride-th fit job beginning from Start
+void AAComputation::ProcessSpectrumFitJobs(vector<SpectrumFitJob> *Jobs, Int_t Start, Int_t Stride)
+{
+  AASpectrumFitter Fitter;
+  Fitter.SetIntegralInCounts(ADAQSettings->SpectrumIntegralInCounts);
+  
+  for(size_t j=Start; j<Jobs->size(); j+=Stride){
+    SpectrumFitJob &Job = (*Jobs)[j];
+    Job.Results = Fitter.Fit(Job.Centers, Job.Contents, Job.BinWidth, Job.Window);
+  }
+}
+
+
 // Method used to output a generic TH1 object to a data text file in
 // the format column1 == bin center, column2 == bin content. Note that
 // the function accepts class types TH1 such that any derived class
 // (TH1F, TH1D ...) can be saved with this function
 bool AAComputation::SaveHistogramData(string Type, string FileName, string FileExtension)
 {
-  TH1F *HistogramToSave_H1 = NULL;
-  TH2F *HistogramToSave_H2 = NULL;
+  if(Type == "ASIMSpectra")
+    return SaveASIMSpectraData(FileName, FileExtension);
+  else if(Type == "PSDFOMScan")
+    return SavePSDFOMScanData(FileName, FileExtension);
+  else if(Type == "SettingsSweep")
+    return SaveSettingsSweepData(FileName, FileExtension);
+  
+  TH1 *HistogramToSave_H1 = NULL;
+  TH2 *HistogramToSave_H2 = NULL;
+
+  // The spectrum and PSD histogram are exported from their exact
+  // counts as TH1D/TH2D objects that are deleted after saving
+  TH1 *Exact_H = NULL;
   
   if(Type == "Waveform")
     HistogramToSave_H1 = Waveform_H[ADAQSettings->WaveformChannel];
-  else if(Type == "Spectrum")
-    HistogramToSave_H1 = Spectrum_H;
-  else if(Type == "SpectrumBackground")
+  else if(Type == "Spectrum"){
+    if(SpectrumCounts.GetNcells() == Spectrum_H->GetNcells())
+      Exact_H = HistogramToSave_H1 = SpectrumCounts.CreateTH1D("SpectrumExport_H", Spectrum_H->GetTitle());
+    else
+      HistogramToSave_H1 = Spectrum_H;
+  }
+  else if(Type == "SpectrumBackground"){
+    UpdateSpectrumProduct(zSpectrumBackgroundProduct);
     HistogramToSave_H1 = SpectrumBackground_H;
-  else if(Type == "SpectrumDerivative")
+  }
+  else if(Type == "SpectrumDerivative"){
+    UpdateSpectrumProduct(zSpectrumDerivativeProduct);
     HistogramToSave_H1 = SpectrumDerivative_H;
-  else if(Type == "PSDHistogram")
-    HistogramToSave_H2 = PSDHistogram_H;
+  }
+  else if(Type == "ConvertedSpectrum")
+    HistogramToSave_H1 = ConvertedSpectrum_H;
+  else if(Type == "PSDHistogram"){
+    if(PSDHistogramCounts.GetNcells() == PSDHistogram_H->GetNcells())
+      Exact_H = HistogramToSave_H2 = PSDHistogramCounts.CreateTH2D("PSDHistogramExport_H", PSDHistogram_H->GetTitle());
+    else
+      HistogramToSave_H2 = PSDHistogram_H;
+  }
   else if(Type == "PSDHistogramSlice")
-    HistogramToSave_H1 = (TH1F *)PSDHistogramSlice_H;
+    HistogramToSave_H1 = PSDHistogramSlice_H;
   
   if(FileExtension == ".dat" or FileExtension == ".csv"){
     
@@ -2120,6 +3500,8 @@ bool AAComputation::SaveHistogramData(string Type, string FileName, string FileE
     
     HistogramOutput.close();
 
+    delete Exact_H;
+
     return true;
   }
   else if(FileExtension == ".root"){
@@ -2136,15 +3518,187 @@ bool AAComputation::SaveHistogramData(string Type, string FileName, string FileE
       HistogramToSave_H1->Write("Spectrum");
     
     HistogramOutput->Close();
+
+    delete Exact_H;
     
     return true;
   }
   else{
+    delete Exact_H;
+    return false;
+  }
+}
+
+
+// Method to output the spectra created from multiple ASIM event
+// trees. Text files contain the bin center in the first column
+// followed by one column of bin contents per event tree; ROOT files
+// contain each spectrum stored under the name of its event tree
+Bool_t AAComputation::SaveASIMSpectraData(string FileName, string FileExtension)
+{
+  if(!ASIMSpectraExist or ASIMSpectra_H.empty())
     return false;
+  
+  string FullFileName = FileName + FileExtension;
+  
+  if(FileExtension == ".dat" or FileExtension == ".csv"){
+    
+    ofstream SpectraOutput(FullFileName.c_str(), ofstream::trunc);
+    
+    string separator;
+    if(FileExtension == ".dat")
+      separator = "\t";
+    else if(FileExtension == ".csv")
+      separator = ",";
+    
+    // The header names one column per value written below. Event
+    // tree names may contain whitespace or the separator, which are
+    // replaced such that each name remains a single column
+    SpectraOutput << "#BinCenter";
+    for(size_t s=0; s<ASIMSpectra_H.size(); s++){
+      string Column = ASIMSpectra_H[s]->GetTitle();
+      for(size_t c=0; c<Column.size(); c++)
+	if(isspace(Column[c]) or Column[c] == ',')
+	  Column[c] = '_';
+      SpectraOutput << separator << Column;
+    }
+    SpectraOutput << endl;
+    
+    int NumBins = ASIMSpectra_H[0]->GetNbinsX();
+    
+    for(int bin=0; bin<=NumBins; bin++){
+      SpectraOutput << ASIMSpectra_H[0]->GetBinCenter(bin);
+      for(size_t s=0; s<ASIMSpectra_H.size(); s++)
+	SpectraOutput << separator << ASIMSpectra_H[s]->GetBinContent(bin);
+      SpectraOutput << endl;
+    }
+    
+    SpectraOutput.close();
+    
+    return true;
+  }
+  else if(FileExtension == ".root"){
+    
+    TFile *SpectraOutput = new TFile(FullFileName.c_str(), "recreate");
+    
+    for(size_t s=0; s<ASIMSpectra_H.size(); s++)
+      ASIMSpectra_H[s]->Write(ASIMSpectra_H[s]->GetTitle());
+    
+    SpectraOutput->Close();
+    delete SpectraOutput;
+    
+    return true;
   }
+  else
+    return false;
 }
 
 
+// Method to output the spectra created during a settings sweep. Text
+// files begin with one comment line per variant listing its
+// parameters and processing time followed by the bin center and one
+// column of bin contents per variant; ROOT files contain each
+// spectrum and a TTree named 'SettingsSweepVariants' holding the
+// parameters and processing time [s] of each variant
+Bool_t AAComputation::SaveSettingsSweepData(string FileName, string FileExtension)
+{
+  if(!SettingsSweepExists or SettingsSweepSpectra_H.empty())
+    return false;
+  
+  string FullFileName = FileName + FileExtension;
+  
+  if(FileExtension == ".dat" or FileExtension == ".csv"){
+    
+    ofstream SweepOutput(FullFileName.c_str(), ofstream::trunc);
+    
+    string separator;
+    if(FileExtension == ".dat")
+      separator = "\t";
+    else if(FileExtension == ".csv")
+      separator = ",";
+
+    for(size_t v=0; v<SettingsSweepVariants.size(); v++){
+      const SettingsVariantStruct &V = SettingsSweepVariants[v];
+      SweepOutput << "# Variant" << v
+		  << " : Floor " << V.Floor
+		  << " : Sigma " << V.Sigma
+		  << " : Resolution " << V.Resolution
+		  << " : Baseline " << V.BaselineRegionMin << " to " << V.BaselineRegionMax
+		  << " : Analysis " << V.AnalysisRegionMin << " to " << V.AnalysisRegionMax
+		  << " : Time [s] " << SettingsSweepTimes[v]
+		  << endl;
+    }
+    
+    SweepOutput << "#BinCenter";
+    for(size_t v=0; v<SettingsSweepSpectra_H.size(); v++)
+      SweepOutput << separator << "Variant" << v;
+    SweepOutput << endl;
+    
+    int NumBins = SettingsSweepSpectra_H[0]->GetNbinsX();
+    
+    for(int bin=0; bin<=NumBins; bin++){
+      SweepOutput << SettingsSweepSpectra_H[0]->GetBinCenter(bin);
+      for(size_t v=0; v<SettingsSweepCounts.size(); v++)
+	SweepOutput << separator << SettingsSweepCounts[v]->GetBinContent(bin);
+      SweepOutput << endl;
+    }
+    
+    SweepOutput.close();
+    
+    return true;
+  }
+  else if(FileExtension == ".root"){
+    
+    TFile *SweepOutput = new TFile(FullFileName.c_str(), "recreate");
+    
+    // The spectra are exported from their exact counts
+    for(size_t v=0; v<SettingsSweepCounts.size(); v++){
+      stringstream SS;
+      SS << "SettingsSweep" << v;
+      TH1D *Exact_H = SettingsSweepCounts[v]->CreateTH1D(SS.str(), SettingsSweepSpectra_H[v]->GetTitle());
+      Exact_H->Write(SS.str().c_str());
+      delete Exact_H;
+    }
+
+    Int_t Variant, Floor, Sigma;
+    Int_t BaselineRegionMin, BaselineRegionMax, AnalysisRegionMin, AnalysisRegionMax;
+    Double_t Resolution, Time;
+    
+    TTree *VariantTree = new TTree("SettingsSweepVariants", "Settings sweep variants");
+    VariantTree->Branch("Variant", &Variant, "Variant/I");
+    VariantTree->Branch("Floor", &Floor, "Floor/I");
+    VariantTree->Branch("Sigma", &Sigma, "Sigma/I");
+    VariantTree->Branch("Resolution", &Resolution, "Resolution/D");
+    VariantTree->Branch("BaselineRegionMin", &BaselineRegionMin, "BaselineRegionMin/I");
+    VariantTree->Branch("BaselineRegionMax", &BaselineRegionMax, "BaselineRegionMax/I");
+    VariantTree->Branch("AnalysisRegionMin", &AnalysisRegionMin, "AnalysisRegionMin/I");
+    VariantTree->Branch("AnalysisRegionMax", &AnalysisRegionMax, "AnalysisRegionMax/I");
+    VariantTree->Branch("Time", &Time, "Time/D");
+
+    for(size_t v=0; v<SettingsSweepVariants.size(); v++){
+      const SettingsVariantStruct &V = SettingsSweepVariants[v];
+      Variant = v;
+      Floor = V.Floor;
+      Sigma = V.Sigma;
+      Resolution = V.Resolution;
+      BaselineRegionMin = V.BaselineRegionMin;
+      BaselineRegionMax = V.BaselineRegionMax;
+      AnalysisRegionMin = V.AnalysisRegionMin;
+      AnalysisRegionMax = V.AnalysisRegionMax;
+      Time = SettingsSweepTimes[v];
+      VariantTree->Fill();
+    }
+    VariantTree->Write();
+    
+    SweepOutput->Close();
+    delete SweepOutput;
+    
+    return true;
+  }
+  else
+    return false;
+}
+
 TH2F *AAComputation::ProcessPSDHistogramWaveforms()
 {
   if(PSDHistogramExists){
@@ -2152,7 +3706,7 @@ TH2F *AAComputation::ProcessPSDHistogramWaveforms()
     PSDHistogramExists = false;
   }
   
-  if(SequentialArchitecture){
+  if(SequentialArchitecture and !ProcessingInThread){
     ProcessingProgressBar->Reset();
     ProcessingProgressBar->SetBarColor(ColorManager->Number2Pixel(33));
     ProcessingProgressBar->SetForegroundColor(ColorManager->Number2Pixel(1));
@@ -2166,6 +3720,18 @@ TH2F *AAComputation::ProcessPSDHistogramWaveforms()
 			    ADAQSettings->PSDNumTailBins,
 			    ADAQSettings->PSDMinTailBin,
 			    ADAQSettings->PSDMaxTailBin);
+
+  // The PSD histogram counts are accumulated exactly and copied into
+  // the histogram once processing is complete
+  PSDHistogramCounts.Initialize(ADAQSettings->PSDNumTotalBins, 
+				ADAQSettings->PSDMinTotalBin,
+				ADAQSettings->PSDMaxTotalBin,
+				ADAQSettings->PSDNumTailBins,
+				ADAQSettings->PSDMinTailBin,
+				ADAQSettings->PSDMaxTailBin);
+
+  if(ProcessingInThread)
+    ProcessingSnapshotReady.store(true, memory_order_release);
   
   Int_t Channel = ADAQSettings->WaveformChannel;
 
@@ -2178,8 +3744,10 @@ TH2F *AAComputation::ProcessPSDHistogramWaveforms()
   // preallocation for our purposes and (b) the PF algorithm, which
   // can find multiple values per pulse and therefore does not have a
   // fixed vector length, makes preallocation difficult.
-  PSDHistogramTotalVec[Channel].clear();
-  PSDHistogramTailVec[Channel].clear();
+  PSDHistogramTotalVec[Channel].Initialize(ADAQSettings->PulseStorePrecision,
+					   ADAQSettings->PulseStoreSpillToDisk);
+  PSDHistogramTailVec[Channel].Initialize(ADAQSettings->PulseStorePrecision,
+					  ADAQSettings->PulseStoreSpillToDisk);
 
 
   ////////////////////////////////////////////////////////
@@ -2226,6 +3794,11 @@ TH2F *AAComputation::ProcessPSDHistogramWaveforms()
     TTree *CloneTree = (TTree *)ADAQWaveformTree->Clone("CloneTree");
     CloneTree->SetBranchAddress(WDName.c_str(), &WD);
     
+    ProcessingTotal.store(min(CloneTree->GetEntries(),
+			      (Long64_t)ADAQSettings->PSDWaveformsToDiscriminate));
+    
+    ProcessingMetrics.Start();
+    
     // Readout appropriate waveform data into the spectrum
     for(Int_t entry=0; entry<CloneTree->GetEntries(); entry++){
       
@@ -2233,8 +3806,17 @@ TH2F *AAComputation::ProcessPSDHistogramWaveforms()
       if(entry == ADAQSettings->PSDWaveformsToDiscriminate)
 	break;
 
+      ProcessingMetrics.Switch(zOtherStage);
+
+      if(ProcessingInThread and !ContinueProcessing(entry+1))
+	break;
+
       // Get the entry
-      CloneTree->GetEntry(entry);
+      ProcessingMetrics.Switch(zReadStage);
+      ProcessingMetrics.AddWaveform(CloneTree->GetEntry(entry));
+      ProcessingMetrics.AddPulses(1);
+
+      ProcessingMetrics.Switch(zPSDRegionStage);
       
       // Get the stored total and tail PSD integrals
       TotalIntegral = WD->GetPSDTotalIntegral();
@@ -2265,19 +3847,27 @@ TH2F *AAComputation::ProcessPSDHistogramWaveforms()
 	if(UsePSDRegions[ADAQSettings->WaveformChannel]){
 	  
 	  // Determine whether to accept/exclude the event
-	  if(!ApplyPSDRegion(TotalIntegral, TailIntegral))
-	    PSDHistogram_H->Fill(TotalIntegral, TailIntegral);
+	  if(!ApplyPSDRegion(TotalIntegral, TailIntegral)){
+	    ProcessingMetrics.Switch(zFillStage);
+	    PSDHistogramCounts.Fill(TotalIntegral, TailIntegral);
+	  }
 	}
 	
 	// ... otherwise straight PSD histogramming
-	else
-	  PSDHistogram_H->Fill(TotalIntegral, TailIntegral);
+	else{
+	  ProcessingMetrics.Switch(zFillStage);
+	  PSDHistogramCounts.Fill(TotalIntegral, TailIntegral);
+	}
       }
     }
 
     // Memory clean up
     delete CloneTree;
     delete WD;
+
+    PSDHistogramCounts.CopyToHistogram(PSDHistogram_H);
+    ProcessingMetrics.Stop();
+    CreatePSDSliceCache();
     
     PSDHistogramExists = true;
   }
@@ -2325,30 +3915,49 @@ TH2F *AAComputation::ProcessPSDHistogramWaveforms()
 	   << endl;
 #endif
     
+    // Select the processing kernels for the present settings; the
+    // PSD integrals of each waveform are added to the PSD histogram
+    SelectProcessingKernels(true);
+    
     Bool_t PeaksFound = false;
+
+    ProcessingTotal.store(WaveformEnd - WaveformStart);
+
+    ProcessingMetrics.Start();
     
     for(Int_t waveform=WaveformStart; waveform<WaveformEnd; waveform++){
-      if(SequentialArchitecture)
+      ProcessingMetrics.Switch(zOtherStage);
+      
+      if(SequentialArchitecture and !ProcessingInThread)
 	gSystem->ProcessEvents();
 
-      ADAQWaveformTree->GetEntry(waveform);
+      // When processing in the background thread, publish the
+      // progress and stop at the next chunk boundary if cancelled
+      if(ProcessingInThread and !ContinueProcessing(waveform-WaveformStart+1))
+	break;
+
+      ProcessingMetrics.Switch(zReadStage);
+      ProcessingMetrics.AddWaveform(ADAQWaveformTree->GetEntry(waveform));
 
+      ProcessingMetrics.Switch(zWaveformStage);
       RawVoltage = *Waveforms[Channel];
     
       if(ADAQSettings->RawWaveform or ADAQSettings->BSWaveform)
-	CalculateBSWaveform(Channel, waveform);
+	FillBSWaveform(Channel, RawVoltage);
       else if(ADAQSettings->ZSWaveform)
-	CalculateZSWaveform(Channel, waveform);
+	FillZSWaveform(Channel, RawVoltage);
     
       // Find the peaks and peak limits in the current waveform. The
       // second argument ('true') indicates the find peaks calculation
       // is being performed for PSD and thus the radio button settings
       // for PSD 'peak finder' or 'whole waveform' should be used to
       // decide which peak finding algorithm to use
+      ProcessingMetrics.Switch(zPeakFindingStage);
       if(ADAQSettings->PSDAlgorithmPF)
 	PeaksFound = FindPeaks(Waveform_H[Channel], zPeakFinder);
       else if(ADAQSettings->PSDAlgorithmSMS)
 	PeaksFound = FindPeaks(Waveform_H[Channel], zWholeWaveform);
+      ProcessingMetrics.Switch(zOtherStage);
 
       // Update the user with progress here because the peak finding
       // algorithm can skip waveform for which it doesn't find a peak,
@@ -2365,10 +3974,15 @@ TH2F *AAComputation::ProcessPSDHistogramWaveforms()
       // Calculate the "total" and "tail" integrals of each
       // peak. Because we want to create a PSD histogram, pass "true" to
       // the function to indicate the results should be histogrammed
-      CalculatePSDIntegrals(true);
+      ProcessingMetrics.AddPulses(PeakInfoVec.size());
+      ProcessingMetrics.Switch(zPSDRegionStage);
+      (this->*CalculatePSDIntegrals_K)(Channel);
     }
+
+    PSDHistogramCounts.CopyToHistogram(PSDHistogram_H);
+    ProcessingMetrics.Stop();
   
-    if(SequentialArchitecture){
+    if(SequentialArchitecture and !ProcessingInThread){
       ProcessingProgressBar->Increment(100);
       ProcessingProgressBar->SetBarColor(ColorManager->Number2Pixel(32));
       ProcessingProgressBar->SetForegroundColor(ColorManager->Number2Pixel(0));
@@ -2376,6 +3990,13 @@ TH2F *AAComputation::ProcessPSDHistogramWaveforms()
 
 #ifdef MPI_ENABLED
 
+    // Report the processing rates and the time spent in each stage
+    // of the processing loop on this node
+    if(ParallelVerbose)
+      cout << "\nADAQAnalysis_MPI Node[" << MPI_Rank << "] : Processing metrics\n"
+	   << ProcessingMetrics.GetSummary()
+	   << flush;
+    
     if(ParallelVerbose)
       cout << "\nADAQAnalysis_MPI Node[" << MPI_Rank << "] : Reached the end-of-processing MPI barrier!"
 	   << endl;
@@ -2412,9 +4033,9 @@ TH2F *AAComputation::ProcessPSDHistogramWaveforms()
     // are aggregated and assigned to the master object, and the
     // deuterons are integrated as well.
 
-    // Create a 2-D array to represent the PSDHistogram_H in array form
-    const Int_t ArraySizeX = PSDHistogram_H->GetNbinsX() + 2;
-    const Int_t ArraySizeY = PSDHistogram_H->GetNbinsY() + 2;
+    // Create a 2-D array to represent the PSDHistogramCounts in array form
+    const Int_t ArraySizeX = ADAQSettings->PSDNumTotalBins + 2;
+    const Int_t ArraySizeY = ADAQSettings->PSDNumTailBins + 2;
     Double_t DoubleArray[ArraySizeX][ArraySizeY];
 
     // Iterate over the PSDHistogram_H columns...
@@ -2423,9 +4044,9 @@ TH2F *AAComputation::ProcessPSDHistogramWaveforms()
       // A container for the PSDHistogram_H's present column
       vector<Double_t> ColumnVector(ArraySizeY, 0.);
 
-      // Assign the PSDHistogram_H's column to the vector
+      // Assign the PSDHistogramCounts' column to the vector
       for(Int_t j=0; j<ArraySizeY; j++)
-	ColumnVector[j] = PSDHistogram_H->GetBinContent(i,j);
+	ColumnVector[j] = PSDHistogramCounts.GetBinContent(i,j);
       
       // Reduce the array representing the column
       Double_t *ReturnArray = AAParallel::GetInstance()->SumDoubleArrayToMaster(&ColumnVector[0], ArraySizeY);
@@ -2437,7 +4058,7 @@ TH2F *AAComputation::ProcessPSDHistogramWaveforms()
     }
     
     // Aggregated the histogram entries from all nodes to the master
-    double Entries = PSDHistogram_H->GetEntries();
+    double Entries = PSDHistogramCounts.GetEntries();
     double ReturnDouble = AAParallel::GetInstance()->SumDoublesToMaster(Entries);
     
     ///////////////////////////////////////////
@@ -2453,11 +4074,11 @@ TH2F *AAComputation::ProcessPSDHistogramWaveforms()
     TString FName = SS.str();
     
     TFile *VectorWrite = new TFile(FName, "recreate");
-    TVectorD PT(PSDHistogramTotalVec[Channel].size(),
-		&PSDHistogramTotalVec[Channel][0]);
+    TVectorD PT(PSDHistogramTotalVec[Channel].size());
+    PSDHistogramTotalVec[Channel].CopyTo(PT.GetMatrixArray());
     
-    TVectorD PP(PSDHistogramTailVec[Channel].size(),
-		&PSDHistogramTailVec[Channel][0]);
+    TVectorD PP(PSDHistogramTailVec[Channel].size());
+    PSDHistogramTailVec[Channel].CopyTo(PP.GetMatrixArray());
     
     PT.Write("PT");
     PP.Write("PP");
@@ -2467,27 +4088,29 @@ TH2F *AAComputation::ProcessPSDHistogramWaveforms()
     if(IsMaster){
     
       if(ParallelVerbose)
-	cout << "\nADAQAnalysis_MPI Node[0] : Writing master PSD TH2F histogram to disk!\n"
+	cout << "\nADAQAnalysis_MPI Node[0] : Writing master PSD TH2D histogram to disk!\n"
 	     << endl;
 
-      // Create the master PSDHistogram_H object, i.e. the sum of all
-      // the PSDHistogram_H object values from the nodes
-      MasterPSDHistogram_H = new TH2F("MasterPSDHistogram_H","MasterPSDHistogram_H",
-				      ADAQSettings->PSDNumTotalBins, 
-				      ADAQSettings->PSDMinTotalBin,
-				      ADAQSettings->PSDMaxTotalBin,
-				      ADAQSettings->PSDNumTailBins,
-				      ADAQSettings->PSDMinTailBin,
-				      ADAQSettings->PSDMaxTailBin);
-
-      // Assign each bin content in the master PSD histogram from the
+      // Accumulate the master PSD histogram counts, i.e. the sum of
+      // all the PSDHistogramCounts values from the nodes, from the
       // double array containing the aggregated slave values
+      AAHistogramAccumulator MasterCounts;
+      MasterCounts.Initialize(ADAQSettings->PSDNumTotalBins, 
+			      ADAQSettings->PSDMinTotalBin,
+			      ADAQSettings->PSDMaxTotalBin,
+			      ADAQSettings->PSDNumTailBins,
+			      ADAQSettings->PSDMinTailBin,
+			      ADAQSettings->PSDMaxTailBin);
+      
       for(Int_t i=0; i<ArraySizeX; i++)
 	for(Int_t j=0; j<ArraySizeY; j++)
-	  MasterPSDHistogram_H->SetBinContent(i, j, DoubleArray[i][j]);
+	  MasterCounts.AddBinContent(i + j*ArraySizeX, llround(DoubleArray[i][j]));
       
       // Assign the total number of entries in the master PSD histogram
-      MasterPSDHistogram_H->SetEntries(ReturnDouble);
+      MasterCounts.AddEntries(llround(ReturnDouble));
+
+      // Create the master PSD histogram object
+      MasterPSDHistogram_H = MasterCounts.CreateTH2D("MasterPSDHistogram_H","MasterPSDHistogram_H");
 
       vector<Double_t> PSDHistogramTotalVec_Master, PSDHistogramTailVec_Master;
       
@@ -2532,6 +4155,8 @@ TH2F *AAComputation::ProcessPSDHistogramWaveforms()
     }
 #endif
     
+    CreatePSDSliceCache();
+    
     // Update the bool to alert the code that a valid PSDHistogram_H object exists.
     PSDHistogramExists = true;
   }
@@ -2554,6 +4179,13 @@ TH2F *AAComputation::CreatePSDHistogram()
 			    ADAQSettings->PSDMinTailBin,
 			    ADAQSettings->PSDMaxTailBin);
 
+  PSDHistogramCounts.Initialize(ADAQSettings->PSDNumTotalBins, 
+				ADAQSettings->PSDMinTotalBin,
+				ADAQSettings->PSDMaxTotalBin,
+				ADAQSettings->PSDNumTailBins,
+				ADAQSettings->PSDMinTailBin,
+				ADAQSettings->PSDMaxTailBin);
+
   Int_t Channel = ADAQSettings->WaveformChannel;
 
   for(Int_t p=0; p<(Int_t)PSDHistogramTotalVec[Channel].size(); p++){
@@ -2591,14 +4223,17 @@ TH2F *AAComputation::CreatePSDHistogram()
 	
 	// Determine whether to accept/exclude the event 
 	if(!ApplyPSDRegion(PSDTotal, PSDParameter))
-	  PSDHistogram_H->Fill(PSDTotal, PSDParameter);
+	  PSDHistogramCounts.Fill(PSDTotal, PSDParameter);
       }
       
       // else just straight fill the PSD histogram
       else
-	PSDHistogram_H->Fill(PSDTotal, PSDParameter);
+	PSDHistogramCounts.Fill(PSDTotal, PSDParameter);
     }
   }
+
+  PSDHistogramCounts.CopyToHistogram(PSDHistogram_H);
+  CreatePSDSliceCache();
   
   PSDHistogramExists = true;
   
@@ -2617,73 +4252,9 @@ TH2F *AAComputation::CreatePSDHistogram()
 // function argment boolean to provide flexibility
 void AAComputation::CalculatePSDIntegrals(Bool_t FillPSDHistogram)
 {
-  // Get the present channel for analysis
-  Int_t Channel = ADAQSettings->WaveformChannel;
-  
-  // Iterate over each peak stored in the vector of PeakInfoStructs...
-  vector<PeakInfoStruct>::iterator it;
-  for(it=PeakInfoVec.begin(); it!=PeakInfoVec.end(); it++){
-    
-    // If the peak falls outside the user-specific waveform analysis
-    // region then filter this peak out of the spectrum
-    if((*it).PeakPosX < ADAQSettings->AnalysisRegionMin or
-       (*it).PeakPosX > ADAQSettings->AnalysisRegionMax)
-      continue;
-
-    // Get the peak position in time (x axis)
-    Double_t Peak = (*it).PeakPosX;
-    
-    // Compute the total and tail integral regions
-    Double_t TotalStart = Peak + ADAQSettings->PSDTotalStart;
-    Double_t TotalStop = Peak + ADAQSettings->PSDTotalStop;
-    Double_t TailStart = Peak + ADAQSettings->PSDTailStart;
-    Double_t TailStop = Peak + ADAQSettings->PSDTailStop;
-    
-    // Compute the total integral
-    Double_t TotalIntegral = Waveform_H[Channel]->Integral(TotalStart,
-							   TotalStop);
-    
-    // Compute the tail integral
-    Double_t TailIntegral = Waveform_H[Channel]->Integral(TailStart,
-							  TailStop);
-    
-    // Store the values in the member data vectors
-    PSDHistogramTotalVec[Channel].push_back(TotalIntegral);
-    PSDHistogramTailVec[Channel].push_back(TailIntegral);
-    
-      // If the user wants to plot (Tail integral / Total integral) on
-    // the y-axis of the PSD histogram then modify the TailIntegral:
-    if(ADAQSettings->PSDYAxisTailTotal)
-      TailIntegral /= TotalIntegral;
-    
-    // If the user wants to plot the X-axis (PSD total integral) in
-    // energy [MeVee] then use the spectra calibrations
-    
-    if(ADAQSettings->PSDXAxisEnergy and ADAQSettings->UseSpectraCalibrations[Channel]){
-      if(SpectraCalibrationType[Channel] == zCalibrationFit)
-	TotalIntegral = ADAQSettings->SpectraCalibrations[Channel]->Eval(TotalIntegral);
-      else if(SpectraCalibrationType[Channel] == zCalibrationInterp)
-	TotalIntegral = ADAQSettings->SpectraCalibrationData[Channel]->Eval(TotalIntegral);
-    }
-    
-    // If the user has enabled a PSD filter ...
-    if(ADAQSettings->UsePSDRegions[Channel]){
-      
-      // ... then apply the PSD filter to the waveform. If the
-      // waveform does not pass the filter, mark the flag indicating
-      // that it should be filtered out due to its pulse shap
-      if(ApplyPSDRegion(TotalIntegral, TailIntegral))
-	(*it).PSDFilterFlag = true;
-    }
-    
-    // The total integral of the waveform must exceed the PSDThreshold
-    // in order to be histogrammed. This allows the user flexibility
-    // in eliminating the large numbers of small waveform events.
-    if((TotalIntegral > ADAQSettings->PSDThreshold) and FillPSDHistogram){
-      if((*it).PSDFilterFlag == false)
-	PSDHistogram_H->Fill(TotalIntegral, TailIntegral);
-    }
-  }
+  const Int_t Channel = ADAQSettings->WaveformChannel;
+  Int_t Options = GetPSDKernelOptions(Channel, FillPSDHistogram);
+  (this->*SelectKernel<CalculatePSDIntegralsKernels>(Options))(Channel);
 }
 
 
@@ -2874,11 +4445,22 @@ void AAComputation::ProcessWaveformsInParallel(string ProcessingType)
 
     if(ProcessingType == "histogramming"){
       
-      // Retrieve the master TH1F histogram, which is a sum of all
-      // TH1F histograms computed by all MPI nodes 
+      // Retrieve the master TH1D histogram, which is a sum of the
+      // spectrum counts computed by all MPI nodes, into the spectrum
+      // counts and copy them into the spectrum for display
 
-      Spectrum_H = (TH1F *)ParallelFile->Get("MasterHistogram");
+      TH1D *Master_H = (TH1D *)ParallelFile->Get("MasterHistogram");
+      SpectrumCounts.Initialize(Master_H);
+
+      const TAxis *Axis = Master_H->GetXaxis();
+      Spectrum_H = new TH1F("Spectrum_H", "ADAQ spectrum",
+			    Axis->GetNbins(), Axis->GetXmin(), Axis->GetXmax());
+      SpectrumCounts.CopyToHistogram(Spectrum_H);
       SpectrumExists = true;
+      SpectrumVersion++;
+
+      ProcessedWaveforms = ADAQSettings->WaveformsToHistogram;
+      SpectrumPreviewOrder = false;
 
       // Retrieve the master TVectorT<double> objects that contain the
       // pulse height and areas computed by all MPI nodes and use them
@@ -2887,12 +4469,14 @@ void AAComputation::ProcessWaveformsInParallel(string ProcessingType)
       Int_t Channel = ADAQSettings->WaveformChannel;
 
       TVectorD *MasterPHVec = (TVectorD *)ParallelFile->Get("MasterPHVec");
-      SpectrumPHVec[Channel].clear();
+      SpectrumPHVec[Channel].Initialize(ADAQSettings->PulseStorePrecision,
+					ADAQSettings->PulseStoreSpillToDisk);
       for(int i=0; i<MasterPHVec->GetNoElements(); i++)
 	SpectrumPHVec[Channel].push_back( (*MasterPHVec)[i]);
 
       TVectorD *MasterPAVec = (TVectorD *)ParallelFile->Get("MasterPAVec");
-      SpectrumPAVec[Channel].clear();
+      SpectrumPAVec[Channel].Initialize(ADAQSettings->PulseStorePrecision,
+					ADAQSettings->PulseStoreSpillToDisk);
       for(int i=0; i<MasterPAVec->GetNoElements(); i++)
 	SpectrumPAVec[Channel].push_back( (*MasterPAVec)[i]);
     }
@@ -2910,7 +4494,16 @@ void AAComputation::ProcessWaveformsInParallel(string ProcessingType)
     
     else if(ProcessingType == "discriminating"){
 
-      PSDHistogram_H = (TH2F *)ParallelFile->Get("MasterPSDHistogram");
+      TH2D *Master_H = (TH2D *)ParallelFile->Get("MasterPSDHistogram");
+      PSDHistogramCounts.Initialize(Master_H);
+
+      const TAxis *XAxis = Master_H->GetXaxis();
+      const TAxis *YAxis = Master_H->GetYaxis();
+      PSDHistogram_H = new TH2F("PSDHistogram_H","PSDHistogram_H",
+				XAxis->GetNbins(), XAxis->GetXmin(), XAxis->GetXmax(),
+				YAxis->GetNbins(), YAxis->GetXmin(), YAxis->GetXmax());
+      PSDHistogramCounts.CopyToHistogram(PSDHistogram_H);
+      CreatePSDSliceCache();
       PSDHistogramExists = true;
 
       // Retrieve the master TVectorD<Double_t> objects that contain
@@ -2920,12 +4513,14 @@ void AAComputation::ProcessWaveformsInParallel(string ProcessingType)
       Int_t Channel = ADAQSettings->WaveformChannel;
       
       TVectorD *MasterPSDTotalVec = (TVectorD *)ParallelFile->Get("MasterPSDTotalVec");
-      PSDHistogramTotalVec[Channel].clear();
+      PSDHistogramTotalVec[Channel].Initialize(ADAQSettings->PulseStorePrecision,
+					       ADAQSettings->PulseStoreSpillToDisk);
       for(int i=0; i<MasterPSDTotalVec->GetNoElements(); i++)
 	PSDHistogramTotalVec[Channel].push_back( (*MasterPSDTotalVec)[i]);
       
       TVectorD *MasterPSDTailVec = (TVectorD *)ParallelFile->Get("MasterPSDTailVec");
-      PSDHistogramTailVec[Channel].clear();
+      PSDHistogramTailVec[Channel].Initialize(ADAQSettings->PulseStorePrecision,
+					      ADAQSettings->PulseStoreSpillToDisk);
       for(int i=0; i<MasterPSDTailVec->GetNoElements(); i++)
 	PSDHistogramTailVec[Channel].push_back( (*MasterPSDTailVec)[i]);
     }
@@ -3069,6 +4664,43 @@ Bool_t AAComputation::SetCalibration(Int_t Channel)
 }
 
 
+// Method to create a copy of a channel's spectrum calibration that
+// can be evaluated directly (and from multiple threads) rather than
+// through the TF1/TGraph objects. If the calibration is not in use
+// then the returned lookup leaves values unchanged
+CalibrationLookupStruct AAComputation::CreateCalibrationLookup(Int_t Channel)
+{
+  CalibrationLookupStruct Lookup;
+  
+  if(!ADAQSettings->UseSpectraCalibrations[Channel])
+    return Lookup;
+  
+  Lookup.Active = true;
+  
+  if(SpectraCalibrationType[Channel] == zCalibrationFit){
+    TF1 *Calibration = SpectraCalibrations[Channel];
+    for(Int_t par=0; par<Calibration->GetNpar(); par++)
+      Lookup.Coefficients.push_back(Calibration->GetParameter(par));
+  }
+  else if(SpectraCalibrationType[Channel] == zCalibrationInterp){
+    Lookup.Interpolate = true;
+
+    TGraph *Calibration = SpectraCalibrationData[Channel];
+
+    vector< pair<Double_t,Double_t> > Points;
+    for(Int_t p=0; p<Calibration->GetN(); p++)
+      Points.push_back(make_pair(Calibration->GetX()[p], Calibration->GetY()[p]));
+    sort(Points.begin(), Points.end());
+
+    for(size_t p=0; p<Points.size(); p++){
+      Lookup.X.push_back(Points[p].first);
+      Lookup.Y.push_back(Points[p].second);
+    }
+  }
+  return Lookup;
+}
+
+
 bool AAComputation::ClearCalibration(int Channel)
 {
   // Clear the channel calibration vectors for the current channel
@@ -3150,8 +4782,10 @@ Bool_t AAComputation::FindCalibrationPeak()
   // the computed continuum subtracted out (DeconvolvedSpectrum_H)
   
   TH1F *CalibrationSpectrum_H;
-  if(ADAQSettings->PlotLessBackground)
+  if(ADAQSettings->PlotLessBackground){
+    UpdateSpectrumProduct(zSpectrumBackgroundProduct);
     CalibrationSpectrum_H = (TH1F*)SpectrumDeconvolved_H->Clone("CalibrationSpectrum_H");
+  }
   else
     CalibrationSpectrum_H = (TH1F*)Spectrum_H->Clone("CalibrationSpectrum_H");
   
@@ -3214,35 +4848,301 @@ Bool_t AAComputation::FindCalibrationEdge()
     MaxADC = CalibrationXBounds.at(0);
   }
   
-  // Determine the x-value (ADC) corresponding to the half-height of
-  // the spectrum edge as the calibration method
+  // Determine the x-value (ADC) corresponding to the half-height of
+  // the spectrum edge as the calibration method
+  
+  Double_t increment = 1;
+  for(Double_t value=MinADC; value<=MaxADC; value+=increment){
+    Double_t X0 = value;
+    Double_t X1 = value + increment;
+    
+    Double_t Y0 = Spectrum_H->Interpolate(X0);
+    Double_t Y1 = Spectrum_H->Interpolate(X1);
+    
+    if((Y0 > EdgeHalfHeight) and (Y1 < EdgeHalfHeight)){
+      Double_t m = (Y1 - Y0) / (X1 - X0);
+      Double_t Y = abs(Y0+Y1)/2;
+      
+      CalibrationX = (1./m)*(Y-Y0)+X0;
+      CalibrationY = EdgeHalfHeight;
+      CalibrationFound = true;
+      break;
+    }
+  }
+
+  // Reset variables in preparation for searching for the next edge
+
+  CalibrationRegionSet = false;
+  CalibrationXBounds.clear();
+  CalibrationYBounds.clear();
+
+  return CalibrationFound;
+}
+
+
+// Method to construct a table of per-slice gain correction factors
+// for the pulse values of the present channel and spectrum type. The
+// stored values are divided into the specified number of slices of
+// consecutive values (in the order in which waveforms were
+// processed) and a fine histogram of each reference window is filled
+// for every slice during a single pass through the store. The
+// position of each reference peak or edge is then located in every
+// slice and in the sum over all slices; the gain correction for a
+// slice is the least-squares scale factor that maps the slice
+// positions onto the whole-run positions. Slices are only time
+// ordered if the store was filled sequentially, so a correction
+// cannot be constructed from the store of a preview run.
+Bool_t AAComputation::CreateGainDriftCorrection(vector<GainReferenceStruct> References,
+						Int_t NumSlices)
+{
+  ClearGainDriftCorrection();
+
+  Int_t Channel = ADAQSettings->WaveformChannel;
+
+  AAPulseStore *Store = NULL;
+  if(ADAQSettings->ADAQSpectrumTypePAS)
+    Store = &SpectrumPAVec[Channel];
+  else if(ADAQSettings->ADAQSpectrumTypePHS)
+    Store = &SpectrumPHVec[Channel];
+  
+  if(!Store or References.empty() or NumSlices < 1 or SpectrumPreviewOrder)
+    return false;
+
+  const size_t NumValues = Store->size();
+  if(NumValues == 0)
+    return false;
+
+  // Accommodate reference windows set either left-right or right-left
+  for(size_t r=0; r<References.size(); r++)
+    if(References[r].Min > References[r].Max)
+      swap(References[r].Min, References[r].Max);
+  
+  const Int_t SliceSize = (NumValues + NumSlices - 1) / NumSlices;
+  NumSlices = (NumValues + SliceSize - 1) / SliceSize;
+
+  const Int_t NumRefs = References.size();
+  const Int_t RefBins = 200;
+
+  // The reference window histograms for all slices are held in a
+  // single contiguous array indexed by [slice][reference][bin]
+  vector<Double_t> Counts(NumSlices * NumRefs * RefBins, 0.);
+
+  vector<Double_t> BinWidths(NumRefs);
+  for(Int_t r=0; r<NumRefs; r++)
+    BinWidths[r] = (References[r].Max - References[r].Min) / RefBins;
+  
+  for(size_t v=0; v<NumValues; v++){
+    Double_t Quantity = Store->At(v);
+    Int_t Slice = v / SliceSize;
+    
+    for(Int_t r=0; r<NumRefs; r++){
+      if(Quantity < References[r].Min or Quantity >= References[r].Max)
+	continue;
+
+      Int_t Bin = (Quantity - References[r].Min) / BinWidths[r];
+      if(Bin < RefBins)
+	Counts[(Slice*NumRefs + r)*RefBins + Bin]++;
+    }
+  }
+
+  // Locate the whole-run position of each reference
+  vector<Double_t> RunPositions(NumRefs, -1.);
+  vector<Double_t> RefCounts(RefBins);
+  for(Int_t r=0; r<NumRefs; r++){
+    fill(RefCounts.begin(), RefCounts.end(), 0.);
+    for(Int_t s=0; s<NumSlices; s++)
+      for(Int_t b=0; b<RefBins; b++)
+	RefCounts[b] += Counts[(s*NumRefs + r)*RefBins + b];
+    
+    RunPositions[r] = LocateGainReference(RefCounts, References[r]);
+  }
+
+  // Compute the gain correction for each slice from the references
+  // that could be located in both the slice and the whole run; slices
+  // without any usable reference are flagged for later treatment
+  vector<Double_t> Gains(NumSlices, -1.);
+  for(Int_t s=0; s<NumSlices; s++){
+    Double_t Numerator = 0., Denominator = 0.;
+    
+    for(Int_t r=0; r<NumRefs; r++){
+      if(RunPositions[r] <= 0.)
+	continue;
+      
+      RefCounts.assign(Counts.begin() + (s*NumRefs + r)*RefBins,
+		       Counts.begin() + (s*NumRefs + r + 1)*RefBins);
+      
+      Double_t Position = LocateGainReference(RefCounts, References[r]);
+      if(Position <= 0.)
+	continue;
+      
+      Numerator += RunPositions[r] * Position;
+      Denominator += Position * Position;
+    }
+    
+    if(Denominator > 0.)
+      Gains[s] = Numerator / Denominator;
+  }
+
+  // Slices without a usable reference take the correction of the
+  // nearest preceding slice (or following slice at the run start)
+  Int_t FirstValid = -1;
+  for(Int_t s=0; s<NumSlices and FirstValid<0; s++)
+    if(Gains[s] > 0.)
+      FirstValid = s;
+  
+  if(FirstValid < 0){
+    if(Verbose)
+      cout << "\nAAComputation : None of the gain references could be located!\n"
+	   << endl;
+    return false;
+  }
+  
+  for(Int_t s=0; s<NumSlices; s++){
+    if(Gains[s] > 0.)
+      continue;
+    Gains[s] = (s < FirstValid) ? Gains[FirstValid] : Gains[s-1];
+  }
+  
+  GainDriftCorrections = Gains;
+  GainDriftReferences = References;
+  GainDriftSliceSize = SliceSize;
+  GainDriftChannel = Channel;
+  GainDriftNumValues = NumValues;
+  GainDriftPAS = (Store == &SpectrumPAVec[Channel]);
+  GainDriftCorrectionExists = true;
+  
+  return true;
+}
+
+
+// Method to locate the position of a gain reference within a fine
+// histogram of its window. Peaks are located by fitting a Gaussian
+// plus linear background (falling back to the maximum bin should the
+// fit fail); edges are located at the half-height of the falling
+// edge above the maximum, as in FindCalibrationEdge(). A negative
+// value is returned if the reference cannot be located.
+Double_t AAComputation::LocateGainReference(const vector<Double_t> &Counts,
+					    const GainReferenceStruct &Reference)
+{
+  const Int_t NumBins = Counts.size();
+  const Double_t BinWidth = (Reference.Max - Reference.Min) / NumBins;
+  
+  // Require a minimum number of counts for a meaningful position
+  Double_t Total = 0.;
+  for(Int_t b=0; b<NumBins; b++)
+    Total += Counts[b];
+  if(Total < 20.)
+    return -1.;
+
+  vector<Double_t> Centers(NumBins);
+  for(Int_t b=0; b<NumBins; b++)
+    Centers[b] = Reference.Min + (b + 0.5) * BinWidth;
+
+  if(!Reference.Edge){
+    SpectrumFitWindowStruct Window;
+    Window.Min = Reference.Min;
+    Window.Max = Reference.Max;
+    Window.NumPeaks = 1;
+    Window.Background = zLinearFitBackground;
+
+    AASpectrumFitter Fitter;
+    vector<SpectrumFitResultStruct> Results = Fitter.Fit(Centers, Counts, BinWidth, Window);
+
+    if(!Results.empty() and Results[0].Converged and
+       Results[0].Mean > Reference.Min and Results[0].Mean < Reference.Max)
+      return Results[0].Mean;
+    
+    return Centers[max_element(Counts.begin(), Counts.end()) - Counts.begin()];
+  }
+  
+  // Smooth the counts with a five bin running average to suppress
+  // statistical fluctuations in sparsely populated slices
+  vector<Double_t> Smoothed(NumBins, 0.);
+  for(Int_t b=0; b<NumBins; b++){
+    Int_t Low = max(0, b-2);
+    Int_t High = min(NumBins-1, b+2);
+    for(Int_t i=Low; i<=High; i++)
+      Smoothed[b] += Counts[i];
+    Smoothed[b] /= (High - Low + 1);
+  }
+  
+  Int_t MaxBin = max_element(Smoothed.begin(), Smoothed.end()) - Smoothed.begin();
+  Double_t HalfHeight = Smoothed[MaxBin] / 2.;
   
-  Double_t increment = 1;
-  for(Double_t value=MinADC; value<=MaxADC; value+=increment){
-    Double_t X0 = value;
-    Double_t X1 = value + increment;
-    
-    Double_t Y0 = Spectrum_H->Interpolate(X0);
-    Double_t Y1 = Spectrum_H->Interpolate(X1);
-    
-    if((Y0 > EdgeHalfHeight) and (Y1 < EdgeHalfHeight)){
-      Double_t m = (Y1 - Y0) / (X1 - X0);
-      Double_t Y = abs(Y0+Y1)/2;
-      
-      CalibrationX = (1./m)*(Y-Y0)+X0;
-      CalibrationY = EdgeHalfHeight;
-      CalibrationFound = true;
-      break;
+  for(Int_t b=MaxBin+1; b<NumBins; b++){
+    if(Smoothed[b] < HalfHeight){
+      Double_t Y0 = Smoothed[b-1];
+      Double_t Y1 = Smoothed[b];
+      return Centers[b-1] + (Y0 - HalfHeight) / (Y0 - Y1) * BinWidth;
     }
   }
+  return -1.;
+}
 
-  // Reset variables in preparation for searching for the next edge
 
-  CalibrationRegionSet = false;
-  CalibrationXBounds.clear();
-  CalibrationYBounds.clear();
+void AAComputation::ClearGainDriftCorrection()
+{
+  GainDriftCorrections.clear();
+  GainDriftReferences.clear();
+  GainDriftSliceSize = 0;
+  GainDriftChannel = -1;
+  GainDriftNumValues = 0;
+  GainDriftCorrectionExists = false;
+}
 
-  return CalibrationFound;
+
+// Method to determine whether the gain correction table applies to
+// the specified store, i.e. that it was computed for the same channel
+// and spectrum type and that the store has not since been refilled,
+// in particular by a preview run in random cluster order
+Bool_t AAComputation::GainDriftCorrectionValid(Int_t Channel, AAPulseStore *Store)
+{
+  if(!GainDriftCorrectionExists or !Store or GainDriftSliceSize < 1 or SpectrumPreviewOrder)
+    return false;
+
+  if(Channel != GainDriftChannel or (Int_t)Store->size() != GainDriftNumValues)
+    return false;
+
+  return (GainDriftPAS == (Store == &SpectrumPAVec[Channel]));
+}
+
+
+Bool_t AAComputation::WriteGainDriftCorrectionFile(string FName)
+{
+  if(!GainDriftCorrectionExists)
+    return false;
+
+  ofstream Out(FName.c_str(), ofstream::trunc);
+  if(!Out.is_open())
+    return false;
+
+  Out << "# ADAQAnalysis gain drift correction table\n"
+      << "# Channel       : " << GainDriftChannel << "\n"
+      << "# Spectrum type : " << (GainDriftPAS ? "pulse area" : "pulse height") << "\n"
+      << "# Slice size    : " << GainDriftSliceSize << " pulse values\n";
+
+  for(size_t r=0; r<GainDriftReferences.size(); r++)
+    Out << "# Reference " << r << "   : "
+	<< (GainDriftReferences[r].Edge ? "edge" : "peak") << " in ["
+	<< GainDriftReferences[r].Min << ", " << GainDriftReferences[r].Max << "] ADC\n";
+
+  Out << "#\n"
+      << "# Slice    First value    Last value    Gain correction\n";
+  
+  for(size_t s=0; s<GainDriftCorrections.size(); s++){
+    Int_t First = s * GainDriftSliceSize;
+    Int_t Last = min(GainDriftNumValues, (Int_t)(s+1) * GainDriftSliceSize) - 1;
+    
+    Out << setw(7) << s << "    "
+	<< setw(11) << First << "    "
+	<< setw(10) << Last << "    "
+	<< setw(15) << setprecision(6) << fixed << GainDriftCorrections[s]
+	<< "\n";
+  }
+  
+  Out.close();
+  
+  return true;
 }
 
 
@@ -3302,7 +5202,7 @@ void AAComputation::CreateDesplicedFile()
   
   // Reset the progres bar if binary is sequential architecture
   
-  if(SequentialArchitecture){
+  if(SequentialArchitecture and !ProcessingInThread){
     ProcessingProgressBar->Reset();
     ProcessingProgressBar->SetBarColor(ColorManager->Number2Pixel(33));
     ProcessingProgressBar->SetForegroundColor(ColorManager->Number2Pixel(1));
@@ -3451,14 +5351,21 @@ void AAComputation::CreateDesplicedFile()
   bool PeaksFound = false;
 
   int Channel = ADAQSettings->WaveformChannel;
+
+  ProcessingTotal.store(WaveformEnd - WaveformStart);
   
   for(int waveform=WaveformStart; waveform<WaveformEnd; waveform++){
 
     // Run sequential desplicing in a separate thread to allow full
     // control of the ADAQAnalysisGUI while processing
-    if(SequentialArchitecture)
+    if(SequentialArchitecture and !ProcessingInThread)
       gSystem->ProcessEvents();
 
+    // When processing in the background thread, publish the progress
+    // and stop at the next chunk boundary if cancelled
+    if(ProcessingInThread and !ContinueProcessing(waveform-WaveformStart+1))
+      break;
+
     /////////////////////////////////////////
     // Calculate the Waveform_H member object
     
@@ -3551,138 +5458,668 @@ void AAComputation::CreateDesplicedFile()
   
   // Make final updates to the progress bar, ensuring that it reaches
   // 100% and changes color to acknoqledge that processing is complete
-  if(SequentialArchitecture){
+  if(SequentialArchitecture and !ProcessingInThread){
     ProcessingProgressBar->Increment(100);
     ProcessingProgressBar->SetBarColor(ColorManager->Number2Pixel(32));
     ProcessingProgressBar->SetForegroundColor(ColorManager->Number2Pixel(0));
   }
   
-#ifdef MPI_ENABLED
+#ifdef MPI_ENABLED
+  
+  if(ParallelVerbose)
+    cout << "\nADAQAnalysis_MPI Node[" << MPI_Rank << "] : Reached the end-of-processing MPI barrier!"
+	 << endl;
+
+  AAParallel::GetInstance()->Barrier();
+  
+  if(IsMaster)
+    cout << "\nADAQAnalysis_MPI Node[0] : Waveform processing complete!\n"
+	 << endl;
+  
+  #endif
+  
+  ///////////////////////////////////////////////////////
+  // Finish processing and creation of the despliced file
+
+  // Now that we are finished processing waveforms from the original
+  // ADAQ ROOT file we want to switch the current TFile (or
+  // "directory") to the despliced TFile such that we can store the
+  // appropriate despliced objects in it and write it to disk
+  F->cd();
+
+  // Write the objects to the ROOT file. In parallel architecture, a
+  // number of temporary, despliced ROOT files will be created in the
+  // /tmp directory for later aggregation; in sequential architecture,
+  // the final despliced ROOT will be created with the specified fle
+  // name and file path
+  T->Write();
+  MP->Write("MeasParams");
+  MC->Write("MeasComment");
+  PR->Write("ParResults");
+  F->Close();
+
+  // Switch back to the ADAQFile TFile directory
+  ADAQFile->cd();
+  
+  // Note: if in parallel architecture then at this point a series of
+  // despliced TFiles now exists in the /tmp directory with each TFile
+  // containing despliced waveforms for the range of original
+  // waveforms allocated to each node.
+
+#ifdef MPI_ENABLED
+
+  /////////////////////////////////////////////////
+  // Aggregrate parallel TFiles into a single TFile
+  
+  // Ensure all nodes are at the same point before aggregating files
+  AAParallel::GetInstance()->Barrier();
+
+  // If the present node is the master then use a TChain object to
+  // merge the despliced waveform TTrees contained in each of the
+  // TFiles created by each node 
+  if(IsMaster){
+
+  if(IsMaster and ParallelVerbose)
+    cout << "\nADAQAnalysis_MPI Node[" << MPI_Rank << "] : Beginning aggregation of ROOT TFiles ..."
+	 << endl;
+    
+    // Create the TChain
+    TChain *WaveformTreeChain = new TChain("WaveformTree");
+
+    // Create each node's TFile name and add the TFile to the TChain
+    for(int node=0; node<MPI_Size; node++){
+      // Create the name
+      stringstream ss;
+      ss << "/tmp/DesplicedWaveforms.root.node" << node;
+      string FName = ss.str();
+
+      // Add TFile to TChain
+      WaveformTreeChain->Add(FName.c_str());
+    }
+
+    // Using the TChain to merge all the TTrees in all the TFiles into
+    // a single TTree contained in a TFile of the provided name. Note
+    // that the name and location of this TFile correspond to the
+    // values set by the user in the despliced widgets.
+    WaveformTreeChain->Merge(ADAQSettings->DesplicedFileName.c_str());
+    
+    // Open the final despliced TFile, write the measurement
+    // parameters and comment objects to it, and close the TFile.
+    TFile *F_Final = new TFile(ADAQSettings->DesplicedFileName.c_str(), "update");
+    MP->Write("MeasParams");
+    MC->Write("MeasComment");
+    PR->Write("ParResults");
+    F_Final->Close();
+    
+    cout << "\nADAQAnalysis_MPI Node[" << MPI_Rank << "] : Finished aggregation of ROOT TFiles!"
+	 << endl;  
+    
+    cout << "\nADAQAnalysis_MPI Node[" << MPI_Rank << "] : Finished production of despliced file!\n"
+	 << endl;  
+  }
+#endif
+}
+
+
+// Method used to find peaks in a pulse / energy spectrum
+void AAComputation::FindSpectrumPeaks()
+{
+  /*
+  int SpectrumNumPeaks = SpectrumNumPeaks_NEL->GetEntry()->GetIntNumber();
+  int SpectrumSigma = SpectrumSigma_NEL->GetEntry()->GetIntNumber();
+  int SpectrumResolution = SpectrumResolution_NEL->GetEntry()->GetNumber();
+  
+  TSpectrum *SpectrumPeakFinder = new TSpectrum(SpectrumNumPeaks);
+
+  int SpectrumPeaks = SpectrumPeakFinder->Search(Spectrum_H, SpectrumSigma, "goff", SpectrumResolution);
+  float *PeakPosX = SpectrumPeakFinder->GetPositionX();
+  float *PeakPosY = SpectrumPeakFinder->GetPositionY();
+  
+  for(int peak=0; peak<SpectrumPeaks; peak++){
+    TMarker *PeakMarker = new TMarker(PeakPosX[peak],
+				      PeakPosY[peak]+50,
+				      peak);
+    PeakMarker->SetMarkerColor(2);
+    PeakMarker->SetMarkerStyle(23);
+    PeakMarker->SetMarkerSize(2.0);
+    PeakMarker->Draw();
+  }
+  Canvas_EC->GetCanvas()->Update();
+  */
+}
+
+
+// Method to compute the PSD figure-of-merit (FOM) as a function of
+// the PSD histogram X axis (total integral or energy). The X axis is
+// divided into either NumBands equal bands over [Min, Max] or, if
+// NumBands < 1, one band per X bin. The Y projection of each band is
+// fit with two Gaussians (seeded automatically from the two most
+// prominent maxima of the projection) with the fits distributed
+// across all available threads. The FOM of each successfully fit
+// band is stored in a TGraphErrors with the band width as the X error
+Bool_t AAComputation::CreatePSDFOMScan(Int_t NumBands, Double_t Min, Double_t Max)
+{
+  if(!PSDHistogramExists)
+    return false;
+
+  TAxis *XAxis = PSDHistogram_H->GetXaxis();
+  TAxis *YAxis = PSDHistogram_H->GetYaxis();
+  const Int_t NumXBins = PSDHistogram_H->GetNbinsX();
+  const Int_t NumYBins = PSDHistogram_H->GetNbinsY();
+
+  // Determine the X bin range of each band
+  
+  vector<Int_t> FirstBins, LastBins;
+
+  if(NumBands < 1 or Max <= Min){
+    for(Int_t bin=1; bin<=NumXBins; bin++){
+      FirstBins.push_back(bin);
+      LastBins.push_back(bin);
+    }
+  }
+  else{
+    Double_t Width = (Max - Min) / NumBands;
+    for(Int_t b=0; b<NumBands; b++){
+      Int_t First = max(1, XAxis->FindFixBin(Min + b*Width));
+      Int_t Last = min(NumXBins, XAxis->FindFixBin(Min + (b+1)*Width));
+      if(Last > First and XAxis->GetBinLowEdge(Last) >= Min + (b+1)*Width)
+	Last--;
+      if(Last < First)
+	continue;
+      FirstBins.push_back(First);
+      LastBins.push_back(Last);
+    }
+  }
+
+  // Extract the Y projection of each band such that no ROOT objects
+  // are accessed during the (threaded) fitting
+  
+  vector<PSDFOMJob> Jobs(FirstBins.size());
+
+  for(size_t j=0; j<Jobs.size(); j++){
+    PSDFOMJob &Job = Jobs[j];
+    Job.Low = XAxis->GetBinLowEdge(FirstBins[j]);
+    Job.High = XAxis->GetBinUpEdge(LastBins[j]);
+    Job.BinWidth = YAxis->GetBinWidth(1);
+    Job.FOM = Job.FOMError = 0.;
+    Job.Valid = false;
+    
+    Job.Centers.resize(NumYBins);
+    Job.Contents.assign(NumYBins, 0.);
+    for(Int_t ybin=1; ybin<=NumYBins; ybin++){
+      Job.Centers[ybin-1] = YAxis->GetBinCenter(ybin);
+      for(Int_t xbin=FirstBins[j]; xbin<=LastBins[j]; xbin++)
+	Job.Contents[ybin-1] += PSDHistogram_H->GetBinContent(xbin, ybin);
+    }
+  }
+
+  if(Jobs.empty())
+    return false;
+  
+  Int_t NumThreads = boost::thread::hardware_concurrency();
+  if(NumThreads < 1)
+    NumThreads = 1;
+  if(NumThreads > (Int_t)Jobs.size())
+    NumThreads = Jobs.size();
+  
+  boost::thread_group Threads;
+  for(Int_t t=0; t<NumThreads; t++)
+    Threads.create_thread(boost::bind(&AAComputation::ProcessPSDFOMJobs, this, &Jobs, t, NumThreads));
+  Threads.join_all();
+
+  // Assemble the figure-of-merit graph from the successful fits
+  
+  if(PSDFOMScan_GE)
+    delete PSDFOMScan_GE;
+  PSDFOMScan_GE = new TGraphErrors;
+  PSDFOMScan_GE->SetName("PSDFOMScan");
+
+  for(size_t j=0; j<Jobs.size(); j++){
+    if(!Jobs[j].Valid)
+      continue;
+
+    Int_t Point = PSDFOMScan_GE->GetN();
+    PSDFOMScan_GE->SetPoint(Point, (Jobs[j].Low + Jobs[j].High)/2, Jobs[j].FOM);
+    PSDFOMScan_GE->SetPointError(Point, (Jobs[j].High - Jobs[j].Low)/2, Jobs[j].FOMError);
+  }
+
+  PSDFOMScanExists = (PSDFOMScan_GE->GetN() > 0);
+
+  return PSDFOMScanExists;
+}
+
+
+// Method run by each thread during the PSD figure-of-merit scan to
+// fit every Stride-th band beginning from Start
+void AAComputation::ProcessPSDFOMJobs(vector<PSDFOMJob> *Jobs, Int_t Start, Int_t Stride)
+{
+  AASpectrumFitter Fitter;
+
+  for(size_t j=Start; j<Jobs->size(); j+=Stride){
+    PSDFOMJob &Job = (*Jobs)[j];
+    
+    const Int_t N = Job.Contents.size();
+    
+    Double_t Total = 0.;
+    for(Int_t i=0; i<N; i++)
+      Total += Job.Contents[i];
+    
+    if(N < 10 or Total < 50.)
+      continue;
+    
+    // Smooth the projection with a three bin running average in order
+    // to seed the two Gaussians from the smoothed shape
+    
+    vector<Double_t> Smoothed(N);
+    for(Int_t i=0; i<N; i++){
+      Int_t Low = max(0, i-1);
+      Int_t High = min(N-1, i+1);
+      Double_t Sum = 0.;
+      for(Int_t k=Low; k<=High; k++)
+	Sum += Job.Contents[k];
+      Smoothed[i] = Sum / (High - Low + 1);
+    }
+
+    // The first peak is the global maximum with its width estimated
+    // from the narrower of its two half widths at half maximum, which
+    // is the side least affected by the other peak
+    
+    Int_t First = max_element(Smoothed.begin(), Smoothed.end()) - Smoothed.begin();
+    Double_t HalfMax = Smoothed[First] / 2;
+
+    Int_t Left = First;
+    while(Left > 0 and Smoothed[Left] > HalfMax)
+      Left--;
+
+    Int_t Right = First;
+    while(Right < N-1 and Smoothed[Right] > HalfMax)
+      Right++;
+    
+    Double_t FirstSigma = max(1, min(First - Left, Right - First)) * Job.BinWidth / 1.1774;
+
+    // The second peak is the maximum of the projection after the
+    // first peak has been subtracted, which locates the second peak
+    // even when it appears only as a shoulder upon the first
+    
+    const Int_t MinSeparation = max(3, N/20);
+    
+    Int_t Second = -1;
+    Double_t SecondMax = 0.;
+    for(Int_t i=0; i<N; i++){
+      if(abs(i - First) < MinSeparation)
+	continue;
+      
+      Double_t U = (i - First) * Job.BinWidth / FirstSigma;
+      Double_t Residual = Smoothed[i] - Smoothed[First] * exp(-0.5*U*U);
+      
+      if(Residual > SecondMax){
+	SecondMax = Residual;
+	Second = i;
+      }
+    }
+    
+    // Require the second peak to be statistically significant
+    if(Second < 0 or SecondMax < 3*sqrt(Smoothed[Second]/3))
+      continue;
+    
+    Int_t Lower = min(First, Second);
+    Int_t Upper = max(First, Second);
+    
+    // Seed the sigma of each peak from its half width at half maximum
+    // on the side away from the other peak
+    
+    Int_t LowerEdge = Lower;
+    while(LowerEdge > 0 and Smoothed[LowerEdge] > Smoothed[Lower]/2)
+      LowerEdge--;
+    
+    Int_t UpperEdge = Upper;
+    while(UpperEdge < N-1 and Smoothed[UpperEdge] > Smoothed[Upper]/2)
+      UpperEdge++;
+
+    Double_t Separation = (Upper - Lower) * Job.BinWidth;
+    
+    Double_t LowerSigma = (Lower - LowerEdge) * Job.BinWidth / 1.1774;
+    if(LowerSigma <= 0. or LowerSigma > Separation)
+      LowerSigma = Separation / 4;
+
+    Double_t UpperSigma = (UpperEdge - Upper) * Job.BinWidth / 1.1774;
+    if(UpperSigma <= 0. or UpperSigma > Separation)
+      UpperSigma = Separation / 4;
+    
+    vector<Double_t> Means(2), Sigmas(2);
+    Means[0] = Job.Centers[Lower];
+    Means[1] = Job.Centers[Upper];
+    Sigmas[0] = max(LowerSigma, Job.BinWidth);
+    Sigmas[1] = max(UpperSigma, Job.BinWidth);
+
+    // Restrict the fit to three sigma beyond each peak to exclude
+    // distant tails that are not well described by a Gaussian
+    
+    SpectrumFitWindowStruct Window;
+    Window.Min = max(Job.Centers[0] - Job.BinWidth/2, Means[0] - 3*Sigmas[0]);
+    Window.Max = min(Job.Centers[N-1] + Job.BinWidth/2, Means[1] + 3*Sigmas[1]);
+    Window.NumPeaks = 2;
+    Window.Background = zNoFitBackground;
+
+    Fitter.SetSeeds(Means, Sigmas);
+    vector<SpectrumFitResultStruct> Results = Fitter.Fit(Job.Centers, Job.Contents, Job.BinWidth, Window);
+    
+    if(Results.size() != 2 or !Results[0].Converged)
+      continue;
+    
+    if(Results[0].Mean > Results[1].Mean)
+      swap(Results[0], Results[1]);
+
+    // Reject fits in which a peak has left the fit window or vanished
+    if(Results[0].Mean < Window.Min or Results[1].Mean > Window.Max or
+       Results[0].Const <= 0. or Results[1].Const <= 0.)
+      continue;
+    
+    SpectrumFitResultStruct &L = Results[0];
+    SpectrumFitResultStruct &U = Results[1];
+    
+    // FOM = (upper mean - lower mean) / (upper FWHM + lower FWHM)
+    // using the same FWHM conversion as the interactive calculation in
+    // AAGraphics::PlotPSDHistogramSlice()
+    
+    Double_t FWHMSum = 2.35 * (fabs(L.Sigma) + fabs(U.Sigma));
+    if(FWHMSum <= 0.)
+      continue;
+    
+    Job.FOM = (U.Mean - L.Mean) / FWHMSum;
+
+    Double_t MeanVar = L.MeanErr*L.MeanErr + U.MeanErr*U.MeanErr;
+    Double_t SigmaVar = 2.35*2.35 * (L.SigmaErr*L.SigmaErr + U.SigmaErr*U.SigmaErr);
+    Job.FOMError = sqrt(MeanVar + Job.FOM*Job.FOM*SigmaVar) / FWHMSum;
+    Job.Valid = true;
+  }
+}
+
+
+// Method to evaluate a grid of PSD integration windows in a single
+// pass through the waveforms. For each peak, the cumulative sum of
+// the waveform bins is computed once such that the total and tail
+// integrals of every candidate window (identical to those computed
+// by TH1::Integral in CalculatePSDIntegrals) cost only a subtraction.
+// Each candidate accumulates a compact histogram of the PSD parameter
+// (tail or tail/total, as selected for the PSD histogram y-axis) for
+// the pulses whose total integral falls within the specified energy
+// band, subject to the PSD region if enabled, which is then fit as
+// in CreatePSDFOMScan() to rank the candidates by figure-of-merit. The scan is run as a background job (see
+// zPSDWindowOptimizationJob) and may be cancelled
+Bool_t AAComputation::OptimizePSDWindows(PSDWindowScanStruct Scan)
+{
+  PSDWindowCandidates.clear();
+
+  if(!SequentialArchitecture or !ADAQFileLoaded or ADAQSettings->PSDAlgorithmWD)
+    return false;
+
+  if(Scan.BandMax <= Scan.BandMin)
+    return false;
+  
+  // Construct the grid of candidate windows
   
-  if(ParallelVerbose)
-    cout << "\nADAQAnalysis_MPI Node[" << MPI_Rank << "] : Reached the end-of-processing MPI barrier!"
-	 << endl;
+  Int_t TotalSteps = max(1, Scan.TotalStopSteps);
+  Int_t TailSteps = max(1, Scan.TailStartSteps);
 
-  AAParallel::GetInstance()->Barrier();
+  vector<Int_t> TotalStops, TailStarts;
+  for(Int_t i=0; i<TotalSteps; i++)
+    TotalStops.push_back((TotalSteps == 1) ? Scan.TotalStopMin :
+			 Scan.TotalStopMin + i*(Scan.TotalStopMax - Scan.TotalStopMin)/(TotalSteps-1));
+  for(Int_t i=0; i<TailSteps; i++)
+    TailStarts.push_back((TailSteps == 1) ? Scan.TailStartMin :
+			 Scan.TailStartMin + i*(Scan.TailStartMax - Scan.TailStartMin)/(TailSteps-1));
   
-  if(IsMaster)
-    cout << "\nADAQAnalysis_MPI Node[0] : Waveform processing complete!\n"
-	 << endl;
+  vector<PSDWindowCandidateStruct> Candidates;
+  for(size_t i=0; i<TotalStops.size(); i++){
+    for(size_t j=0; j<TailStarts.size(); j++){
+      if(TailStarts[j] >= TotalStops[i] or Scan.TotalStart >= TotalStops[i])
+	continue;
+      
+      PSDWindowCandidateStruct Candidate;
+      Candidate.TotalStart = Scan.TotalStart;
+      Candidate.TotalStop = TotalStops[i];
+      Candidate.TailStart = TailStarts[j];
+      Candidate.TailStop = TotalStops[i];
+      Candidate.FOM = Candidate.FOMError = 0.;
+      Candidate.Valid = false;
+      Candidates.push_back(Candidate);
+    }
+  }
+
+  const Int_t NumCandidates = Candidates.size();
+  if(NumCandidates == 0)
+    return false;
+
+  // The compact histograms of all candidates are held in a single
+  // contiguous array indexed by [candidate][PSD bin]
   
-  #endif
+  const Int_t NumPSDBins = 100;
+
+  // The PSD parameter is binned over the y-axis range of the PSD
+  // histogram; tail/total defaults to [0, 1] if the range is unset
+  Double_t PSDMin = 0., PSDMax = 1.;
+  if(ADAQSettings->PSDMaxTailBin > ADAQSettings->PSDMinTailBin){
+    PSDMin = ADAQSettings->PSDMinTailBin;
+    PSDMax = ADAQSettings->PSDMaxTailBin;
+  }
+  else if(!ADAQSettings->PSDYAxisTailTotal)
+    return false;
   
-  ///////////////////////////////////////////////////////
-  // Finish processing and creation of the despliced file
+  const Double_t PSDBinWidth = (PSDMax - PSDMin) / NumPSDBins;
 
-  // Now that we are finished processing waveforms from the original
-  // ADAQ ROOT file we want to switch the current TFile (or
-  // "directory") to the despliced TFile such that we can store the
-  // appropriate despliced objects in it and write it to disk
-  F->cd();
+  vector<Float_t> Counts(NumCandidates * NumPSDBins, 0.);
 
-  // Write the objects to the ROOT file. In parallel architecture, a
-  // number of temporary, despliced ROOT files will be created in the
-  // /tmp directory for later aggregation; in sequential architecture,
-  // the final despliced ROOT will be created with the specified fle
-  // name and file path
-  T->Write();
-  MP->Write("MeasParams");
-  MC->Write("MeasComment");
-  PR->Write("ParResults");
-  F->Close();
+  Int_t Channel = ADAQSettings->WaveformChannel;
 
-  // Switch back to the ADAQFile TFile directory
-  ADAQFile->cd();
+  Bool_t Calibrate = (ADAQSettings->PSDXAxisEnergy and ADAQSettings->UseSpectraCalibrations[Channel]);
+  Bool_t UseRegion = ADAQSettings->UsePSDRegions[Channel];
   
-  // Note: if in parallel architecture then at this point a series of
-  // despliced TFiles now exists in the /tmp directory with each TFile
-  // containing despliced waveforms for the range of original
-  // waveforms allocated to each node.
+  // Reboot the PeakFinder with up-to-date max peaks
+  if(PeakFinder) delete PeakFinder;
+  PeakFinder = new TSpectrum(ADAQSettings->MaxPeaks);
 
-#ifdef MPI_ENABLED
+  WaveformStart = 0;
+  WaveformEnd = min((Int_t)ADAQWaveformTree->GetEntries(), ADAQSettings->PSDWaveformsToDiscriminate);
 
-  /////////////////////////////////////////////////
-  // Aggregrate parallel TFiles into a single TFile
+  ProcessingTotal.store(WaveformEnd - WaveformStart);
   
-  // Ensure all nodes are at the same point before aggregating files
-  AAParallel::GetInstance()->Barrier();
-
-  // If the present node is the master then use a TChain object to
-  // merge the despliced waveform TTrees contained in each of the
-  // TFiles created by each node 
-  if(IsMaster){
+  vector<Double_t> Cumulative;
+  
+  for(Int_t waveform=WaveformStart; waveform<WaveformEnd; waveform++){
 
-  if(IsMaster and ParallelVerbose)
-    cout << "\nADAQAnalysis_MPI Node[" << MPI_Rank << "] : Beginning aggregation of ROOT TFiles ..."
-	 << endl;
+    // Publish the progress and stop at the next chunk boundary if
+    // the job has been cancelled
+    if(ProcessingInThread and !ContinueProcessing(waveform-WaveformStart+1))
+      break;
     
-    // Create the TChain
-    TChain *WaveformTreeChain = new TChain("WaveformTree");
-
-    // Create each node's TFile name and add the TFile to the TChain
-    for(int node=0; node<MPI_Size; node++){
-      // Create the name
-      stringstream ss;
-      ss << "/tmp/DesplicedWaveforms.root.node" << node;
-      string FName = ss.str();
+    ADAQWaveformTree->GetEntry(waveform);
+    
+    RawVoltage = *Waveforms[Channel];
+    
+    if(ADAQSettings->RawWaveform or ADAQSettings->BSWaveform)
+      FillBSWaveform(Channel, RawVoltage);
+    else if(ADAQSettings->ZSWaveform)
+      FillZSWaveform(Channel, RawVoltage);
 
-      // Add TFile to TChain
-      WaveformTreeChain->Add(FName.c_str());
-    }
+    Bool_t PeaksFound = false;
+    if(ADAQSettings->PSDAlgorithmPF)
+      PeaksFound = FindPeaks(Waveform_H[Channel], zPeakFinder);
+    else if(ADAQSettings->PSDAlgorithmSMS)
+      PeaksFound = FindPeaks(Waveform_H[Channel], zWholeWaveform);
+    
+    if(!PeaksFound)
+      continue;
 
-    // Using the TChain to merge all the TTrees in all the TFiles into
-    // a single TTree contained in a TFile of the provided name. Note
-    // that the name and location of this TFile correspond to the
-    // values set by the user in the despliced widgets.
-    WaveformTreeChain->Merge(ADAQSettings->DesplicedFileName.c_str());
+    // Cumulative sum over all bins (including under/overflow) such
+    // that the sum of bins [a, b] is Cumulative[b+1] - Cumulative[a]
     
-    // Open the final despliced TFile, write the measurement
-    // parameters and comment objects to it, and close the TFile.
-    TFile *F_Final = new TFile(ADAQSettings->DesplicedFileName.c_str(), "update");
-    MP->Write("MeasParams");
-    MC->Write("MeasComment");
-    PR->Write("ParResults");
-    F_Final->Close();
+    const Int_t NumBins = Waveform_H[Channel]->GetNbinsX();
+    const Float_t *Contents = Waveform_H[Channel]->GetArray();
     
-    cout << "\nADAQAnalysis_MPI Node[" << MPI_Rank << "] : Finished aggregation of ROOT TFiles!"
-	 << endl;  
+    Cumulative.resize(NumBins+3);
+    Cumulative[0] = 0.;
+    for(Int_t bin=0; bin<=NumBins+1; bin++)
+      Cumulative[bin+1] = Cumulative[bin] + Contents[bin];
     
-    cout << "\nADAQAnalysis_MPI Node[" << MPI_Rank << "] : Finished production of despliced file!\n"
-	 << endl;  
+    vector<PeakInfoStruct>::iterator it;
+    for(it=PeakInfoVec.begin(); it!=PeakInfoVec.end(); it++){
+      
+      if((*it).PeakPosX < ADAQSettings->AnalysisRegionMin or
+	 (*it).PeakPosX > ADAQSettings->AnalysisRegionMax)
+	continue;
+      
+      Double_t Peak = (*it).PeakPosX;
+
+      for(Int_t c=0; c<NumCandidates; c++){
+	const PSDWindowCandidateStruct &Candidate = Candidates[c];
+
+	// Bin limits are truncated and clamped as in TH1::Integral
+	Int_t TotalFirst = max(0, (Int_t)(Peak + Candidate.TotalStart));
+	Int_t TotalLast = min(NumBins+1, (Int_t)(Peak + Candidate.TotalStop));
+	Int_t TailFirst = max(0, (Int_t)(Peak + Candidate.TailStart));
+	Int_t TailLast = min(NumBins+1, (Int_t)(Peak + Candidate.TailStop));
+	
+	if(TotalLast < TotalFirst or TailLast < TailFirst)
+	  continue;
+	
+	Double_t TotalIntegral = Cumulative[TotalLast+1] - Cumulative[TotalFirst];
+	Double_t TailIntegral = Cumulative[TailLast+1] - Cumulative[TailFirst];
+	
+	if(TotalIntegral <= 0.)
+	  continue;
+	
+	Double_t PSDParameter = TailIntegral;
+	if(ADAQSettings->PSDYAxisTailTotal)
+	  PSDParameter /= TotalIntegral;
+	
+	if(Calibrate){
+	  if(SpectraCalibrationType[Channel] == zCalibrationFit)
+	    TotalIntegral = ADAQSettings->SpectraCalibrations[Channel]->Eval(TotalIntegral);
+	  else if(SpectraCalibrationType[Channel] == zCalibrationInterp)
+	    TotalIntegral = ADAQSettings->SpectraCalibrationData[Channel]->Eval(TotalIntegral);
+	}
+	
+	if(TotalIntegral <= ADAQSettings->PSDThreshold or
+	   TotalIntegral < Scan.BandMin or TotalIntegral >= Scan.BandMax)
+	  continue;
+	
+	if(PSDParameter < PSDMin or PSDParameter >= PSDMax)
+	  continue;
+
+	// Exclude pulses rejected by the PSD region exactly as when the
+	// PSD histogram is created with the candidate windows
+	if(UseRegion and ApplyPSDRegion(TotalIntegral, PSDParameter))
+	  continue;
+	
+	Int_t PSDBin = min(NumPSDBins-1, (Int_t)((PSDParameter - PSDMin) / PSDBinWidth));
+	
+	Counts[c*NumPSDBins + PSDBin]++;
+      }
+    }
   }
-#endif
+
+  // Fit each candidate's histogram with the jobs distributed across
+  // all available threads
+
+  vector<PSDFOMJob> Jobs(NumCandidates);
+  for(Int_t c=0; c<NumCandidates; c++){
+    PSDFOMJob &Job = Jobs[c];
+    Job.Low = Scan.BandMin;
+    Job.High = Scan.BandMax;
+    Job.BinWidth = PSDBinWidth;
+    Job.FOM = Job.FOMError = 0.;
+    Job.Valid = false;
+
+    Job.Centers.resize(NumPSDBins);
+    Job.Contents.assign(NumPSDBins, 0.);
+    for(Int_t p=0; p<NumPSDBins; p++){
+      Job.Centers[p] = PSDMin + (p + 0.5) * PSDBinWidth;
+      Job.Contents[p] = Counts[c*NumPSDBins + p];
+    }
+  }
+  
+  Int_t NumThreads = boost::thread::hardware_concurrency();
+  if(NumThreads < 1)
+    NumThreads = 1;
+  if(NumThreads > NumCandidates)
+    NumThreads = NumCandidates;
+  
+  boost::thread_group Threads;
+  for(Int_t t=0; t<NumThreads; t++)
+    Threads.create_thread(boost::bind(&AAComputation::ProcessPSDFOMJobs, this, &Jobs, t, NumThreads));
+  Threads.join_all();
+
+  for(Int_t c=0; c<NumCandidates; c++){
+    Candidates[c].FOM = Jobs[c].FOM;
+    Candidates[c].FOMError = Jobs[c].FOMError;
+    Candidates[c].Valid = Jobs[c].Valid;
+    if(Candidates[c].Valid)
+      PSDWindowCandidates.push_back(Candidates[c]);
+  }
+
+  // Rank the successfully evaluated candidates by figure-of-merit
+  sort(PSDWindowCandidates.begin(), PSDWindowCandidates.end(), ComparePSDWindowCandidates);
+  
+  return !PSDWindowCandidates.empty();
 }
 
 
-// Method used to find peaks in a pulse / energy spectrum
-void AAComputation::FindSpectrumPeaks()
+Bool_t AAComputation::ComparePSDWindowCandidates(const PSDWindowCandidateStruct &A,
+						 const PSDWindowCandidateStruct &B)
 {
-  /*
-  int SpectrumNumPeaks = SpectrumNumPeaks_NEL->GetEntry()->GetIntNumber();
-  int SpectrumSigma = SpectrumSigma_NEL->GetEntry()->GetIntNumber();
-  int SpectrumResolution = SpectrumResolution_NEL->GetEntry()->GetNumber();
-  
-  TSpectrum *SpectrumPeakFinder = new TSpectrum(SpectrumNumPeaks);
+  return A.FOM > B.FOM;
+}
 
-  int SpectrumPeaks = SpectrumPeakFinder->Search(Spectrum_H, SpectrumSigma, "goff", SpectrumResolution);
-  float *PeakPosX = SpectrumPeakFinder->GetPositionX();
-  float *PeakPosY = SpectrumPeakFinder->GetPositionY();
+
+// Method to output the PSD figure-of-merit scan. Text files contain
+// one row per band with the band center, band half width, FOM, and
+// FOM error; ROOT files contain the TGraphErrors named 'PSDFOMScan'
+Bool_t AAComputation::SavePSDFOMScanData(string FileName, string FileExtension)
+{
+  if(!PSDFOMScanExists)
+    return false;
+
+  string FullFileName = FileName + FileExtension;
   
-  for(int peak=0; peak<SpectrumPeaks; peak++){
-    TMarker *PeakMarker = new TMarker(PeakPosX[peak],
-				      PeakPosY[peak]+50,
-				      peak);
-    PeakMarker->SetMarkerColor(2);
-    PeakMarker->SetMarkerStyle(23);
-    PeakMarker->SetMarkerSize(2.0);
-    PeakMarker->Draw();
+  if(FileExtension == ".dat" or FileExtension == ".csv"){
+    
+    ofstream ScanOutput(FullFileName.c_str(), ofstream::trunc);
+    
+    string separator;
+    if(FileExtension == ".dat")
+      separator = "\t";
+    else if(FileExtension == ".csv")
+      separator = ",";
+
+    ScanOutput << "#BandCenter" << separator << "BandHalfWidth" << separator
+	       << "FOM" << separator << "FOMError" << endl;
+
+    for(Int_t p=0; p<PSDFOMScan_GE->GetN(); p++)
+      ScanOutput << PSDFOMScan_GE->GetX()[p] << separator
+		 << PSDFOMScan_GE->GetEX()[p] << separator
+		 << PSDFOMScan_GE->GetY()[p] << separator
+		 << PSDFOMScan_GE->GetEY()[p]
+		 << endl;
+    
+    ScanOutput.close();
+
+    return true;
   }
-  Canvas_EC->GetCanvas()->Update();
-  */
+  else if(FileExtension == ".root"){
+    
+    TFile *ScanOutput = new TFile(FullFileName.c_str(), "recreate");
+    PSDFOMScan_GE->Write("PSDFOMScan");
+    ScanOutput->Close();
+    
+    return true;
+  }
+  
+  return false;
 }
 
 
-void AAComputation::CreatePSDHistogramSlice(int XPixel, int YPixel)
+Bool_t AAComputation::CreatePSDHistogramSlice(int XPixel, int YPixel)
 {
   // pixel coordinates: refers to an (X,Y) position on the canvas
   //                    using X and Y pixel IDs. The (0,0) pixel is in
@@ -3742,60 +6179,230 @@ void AAComputation::CreatePSDHistogramSlice(int XPixel, int YPixel)
     gPad->SetUniqueID(YPixel);
   }
 
-  ////////////////////////////////////////
-  // Draw the TH1D PSDHistogram_H slice //
-  ////////////////////////////////////////
-  // A 1D histogram representing the slice along X (or Y) at the value
-  // specified by the cursor position on the canvas will be drawn in a
-  // separate canvas to enable continual selection of slices. The PSD
-  // histogram slice canvas is kept open until the user turns off
-  // histogram slicing to enable smooth plotting
+  ////////////////////////////////////////
+  // Draw the TH1D PSDHistogram_H slice //
+  ////////////////////////////////////////
+  // A 1D histogram representing the slice along X (or Y) at the value
+  // specified by the cursor position on the canvas will be drawn in a
+  // separate canvas to enable continual selection of slices. The PSD
+  // histogram slice canvas is kept open until the user turns off
+  // histogram slicing to enable smooth plotting
+
+
+  // The projections of every bin were cached when the PSD histogram
+  // was created such that a slice is only a copy of the cached bin
+  // contents into the slice histogram. The slice is left untouched
+  // (and false is returned) while the cursor remains within a bin
+
+  TAxis *SliceAxis = NULL;
+  Int_t Axis = -1, Bin = -1;
+
+  // Create a slice at a specific "X" (total pulse integral) value,
+  // i.e. create a 1D histogram of the "Y" (tail pulse integrals)
+  // values at a specific value of "X" (total pulse integral).
+  if(ADAQSettings->PSDXSlice){
+    Axis = 0;
+    Bin = PSDHistogram_H->GetXaxis()->FindFixBin(gPad->PadtoX(XPos));
+    SliceAxis = PSDHistogram_H->GetYaxis();
+  }
+  
+  // Create a slice at a specific "Y" (tail pulse integral) value,
+  // i.e. create a 1D histogram of the "X" (total pulse integrals)
+  // values at a specific value of "Y" (tail pulse integral).
+  else{
+    Axis = 1;
+    Bin = PSDHistogram_H->GetYaxis()->FindFixBin(gPad->PadtoY(YPos));
+    SliceAxis = PSDHistogram_H->GetXaxis();
+  }
+
+  if(PSDHistogramSliceExists and Axis == PSDSliceAxis and Bin == PSDSliceBin)
+    return false;
+
+  const Int_t NumCellsX = PSDHistogram_H->GetNbinsX() + 2;
+  const Int_t NumCellsY = PSDHistogram_H->GetNbinsY() + 2;
+  
+  if(PSDXSliceCache.size() != (size_t)(NumCellsX * NumCellsY))
+    CreatePSDSliceCache();
+  
+  // The slice histogram is only recreated when the sliced axis changes
+  
+  if(!PSDHistogramSliceExists or Axis != PSDSliceAxis){
+    delete PSDHistogramSlice_H;
+    
+    PSDHistogramSlice_H = new TH1D("PSDHistogramSlice_H", "PSDHistogramSlice_H",
+				   SliceAxis->GetNbins(),
+				   SliceAxis->GetXmin(),
+				   SliceAxis->GetXmax());
+    PSDHistogramSlice_H->SetDirectory(0);
+    PSDHistogramSlice_H->GetXaxis()->SetTitle(SliceAxis->GetTitle());
+  }
+
+  if(Axis == 0)
+    PSDHistogramSlice_H->SetContent(&PSDXSliceCache[Bin * NumCellsY]);
+  else
+    PSDHistogramSlice_H->SetContent(&PSDYSliceCache[Bin * NumCellsX]);
+  
+  PSDHistogramSlice_H->ResetStats();
+  PSDHistogramSlice_H->SetEntries(PSDHistogramSlice_H->Integral(0, SliceAxis->GetNbins()+1));
+
+  PSDSliceAxis = Axis;
+  PSDSliceBin = Bin;
+  PSDHistogramSliceExists = true;
+
+  return true;
+}
+
+
+// Method to store the contents of every X and Y slice of the PSD
+// histogram. The X slices are the (strided) columns of the TH2F bin
+// array and are transposed such that each slice is contiguous
+void AAComputation::CreatePSDSliceCache()
+{
+  // Force the next slice to be copied from the new cache
+  PSDSliceAxis = PSDSliceBin = -1;
+
+  // Slicing is only available from the GUI
+  if(!SequentialArchitecture)
+    return;
+  
+  const Int_t NumCellsX = PSDHistogram_H->GetNbinsX() + 2;
+  const Int_t NumCellsY = PSDHistogram_H->GetNbinsY() + 2;
+  const Float_t *Contents = PSDHistogram_H->GetArray();
+
+  PSDXSliceCache.resize(NumCellsX * NumCellsY);
+  PSDYSliceCache.resize(NumCellsX * NumCellsY);
+  
+  for(Int_t y=0; y<NumCellsY; y++){
+    for(Int_t x=0; x<NumCellsX; x++){
+      Double_t Content = Contents[x + y*NumCellsX];
+      PSDXSliceCache[x*NumCellsY + y] = Content;
+      PSDYSliceCache[y*NumCellsX + x] = Content;
+    }
+  }
+}
+
+
+// Method to request the figure-of-merit fit of the present PSD
+// histogram slice. The slice and fit windows are copied into a job
+// such that the fit may run while the cursor continues to move. If a
+// fit is already running, the job replaces any earlier queued job,
+// which is thereby dropped without being fit
+void AAComputation::RequestPSDSliceFit()
+{
+  if(!PSDHistogramSliceExists)
+    return;
+
+  PSDSliceFitJob Job;
+  Job.Axis = PSDSliceAxis;
+  Job.Bin = PSDSliceBin;
+  
+  Job.LowerWindow.Min = ADAQSettings->PSDLowerFOMFitMin;
+  Job.LowerWindow.Max = ADAQSettings->PSDLowerFOMFitMax;
+  Job.LowerWindow.NumPeaks = 1;
+  Job.LowerWindow.Background = zNoFitBackground;
+
+  Job.UpperWindow.Min = ADAQSettings->PSDUpperFOMFitMin;
+  Job.UpperWindow.Max = ADAQSettings->PSDUpperFOMFitMax;
+  Job.UpperWindow.NumPeaks = 1;
+  Job.UpperWindow.Background = zNoFitBackground;
+
+  // Nothing to do if the latest request was for the same fit
+  
+  const PSDSliceFitJob &Latest = (PSDSliceFitQueued ? QueuedPSDSliceFit :
+				  PSDSliceFitThread ? ActivePSDSliceFit : PSDSliceFit);
+  
+  if(Latest.Request == PSDSliceFitRequests and
+     Latest.Axis == Job.Axis and Latest.Bin == Job.Bin and
+     Latest.LowerWindow.Min == Job.LowerWindow.Min and
+     Latest.LowerWindow.Max == Job.LowerWindow.Max and
+     Latest.UpperWindow.Min == Job.UpperWindow.Min and
+     Latest.UpperWindow.Max == Job.UpperWindow.Max)
+    return;
+
+  const Int_t NumBins = PSDHistogramSlice_H->GetNbinsX();
+  
+  Job.BinWidth = PSDHistogramSlice_H->GetXaxis()->GetBinWidth(1);
+  Job.Centers.resize(NumBins);
+  Job.Contents.resize(NumBins);
+  for(Int_t bin=1; bin<=NumBins; bin++){
+    Job.Centers[bin-1] = PSDHistogramSlice_H->GetXaxis()->GetBinCenter(bin);
+    Job.Contents[bin-1] = PSDHistogramSlice_H->GetBinContent(bin);
+  }
+
+  Job.FOM = 0.;
+  Job.Valid = false;
+  Job.Request = ++PSDSliceFitRequests;
+
+  if(PSDSliceFitThread){
+    QueuedPSDSliceFit = Job;
+    PSDSliceFitQueued = true;
+  }
+  else{
+    ActivePSDSliceFit = Job;
+    StartPSDSliceFitThread();
+  }
+}
+
 
+void AAComputation::StartPSDSliceFitThread()
+{
+  PSDSliceFitDone.store(false);
+  PSDSliceFitThread = new boost::thread(&AAComputation::ProcessPSDSliceFitJob, this);
+}
 
-  // An integer to determine which bin in the TH2F PSDHistogram_H
-  // object should be sliced
-  int PSDSliceBin = -1;
 
-  // The 1D histogram slice object
-  TH1D *PSDSlice_H = 0;
+// Method to collect a finished slice fit on the GUI thread. The
+// result is kept only if no newer request has been made since the
+// fit was started; otherwise it is stale and the queued request (if
+// any) is started in its place
+Bool_t AAComputation::UpdatePSDSliceFit()
+{
+  if(!PSDSliceFitThread or !PSDSliceFitDone.load())
+    return false;
 
-  string HistogramTitle, XAxisTitle;
+  PSDSliceFitThread->join();
+  delete PSDSliceFitThread;
+  PSDSliceFitThread = NULL;
 
-  // Create a slice at a specific "X" (total pulse integral) value,
-  // i.e. create a 1D histogram of the "Y" (tail pulse integrals)
-  // values at a specific value of "X" (total pulse integral).
-  if(ADAQSettings->PSDXSlice){
-    PSDSliceBin = PSDHistogram_H->GetXaxis()->FindBin(gPad->PadtoX(XPos));
-    PSDSlice_H = PSDHistogram_H->ProjectionY("",PSDSliceBin,PSDSliceBin);
-    
-    stringstream ss;
-    ss << "PSDHistogram X slice at " << XPos << " ADC";
-    HistogramTitle = ss.str();
-    
-    XAxisTitle = PSDHistogram_H->GetYaxis()->GetTitle();
+  Bool_t Current = (ActivePSDSliceFit.Request == PSDSliceFitRequests);
+  
+  if(Current)
+    PSDSliceFit = ActivePSDSliceFit;
+  
+  if(PSDSliceFitQueued){
+    ActivePSDSliceFit = QueuedPSDSliceFit;
+    PSDSliceFitQueued = false;
+    StartPSDSliceFitThread();
   }
   
-  // Create a slice at a specific "Y" (tail pulse integral) value,
-  // i.e. create a 1D histogram of the "X" (total pulse integrals)
-  // values at a specific value of "Y" (tail pulse integral).
-  else{
-    PSDSliceBin = PSDHistogram_H->GetYaxis()->FindBin(gPad->PadtoY(YPos));
-    PSDSlice_H = PSDHistogram_H->ProjectionX("",PSDSliceBin,PSDSliceBin);
+  return Current;
+}
 
-    stringstream ss;
-    ss << "PSDHistogram Y slice at " << YPos << " ADC";
-    HistogramTitle = ss.str();
-    
-    XAxisTitle = PSDHistogram_H->GetXaxis()->GetTitle();
-  }
 
-  // Save the histogram  to a class member TH1F object
+// Method run by the slice fit thread to fit the lower (typically
+// gamma / electron) and upper (typically neutron / proton) groups of
+// the slice with a Gaussian each and compute the figure-of-merit
+void AAComputation::ProcessPSDSliceFitJob()
+{
+  PSDSliceFitJob &Job = ActivePSDSliceFit;
+  
+  AASpectrumFitter Fitter;
+  
+  vector<SpectrumFitResultStruct> Lower = Fitter.Fit(Job.Centers, Job.Contents, Job.BinWidth, Job.LowerWindow);
+  vector<SpectrumFitResultStruct> Upper = Fitter.Fit(Job.Centers, Job.Contents, Job.BinWidth, Job.UpperWindow);
 
-  if(PSDHistogramSliceExists)
-    delete PSDHistogramSlice_H;
+  if(Lower.size() == 1 and Upper.size() == 1){
+    Job.Lower = Lower[0];
+    Job.Upper = Upper[0];
+    
+    Double_t LowerFWHM = Job.Lower.Sigma * 2.35;
+    Double_t UpperFWHM = Job.Upper.Sigma * 2.35;
+    
+    Job.FOM = (Job.Upper.Mean - Job.Lower.Mean) / (UpperFWHM + LowerFWHM);
+    Job.Valid = true;
+  }
   
-  PSDHistogramSlice_H = (TH1D *)PSDSlice_H->Clone("PSDHistogramSlice_H");
-  PSDHistogramSliceExists = true;
+  PSDSliceFitDone.store(true);
 }
 
 
@@ -3811,55 +6418,398 @@ void AAComputation::CreateASIMSpectrum()
 			ADAQSettings->SpectrumMinBin,
 			ADAQSettings->SpectrumMaxBin);
   
-  // Get the name of the ASIM event tree to be analyzed as specified
-  // by the associated combo box setting.
-  TString ASIMEventTreeName = ADAQSettings->ASIMEventTreeName;
-  TTree *ASIMEventTree = (TTree *)ASIMEventTreeList->FindObject(ASIMEventTreeName);
+  // Get the catalog information of the ASIM event tree to be
+  // analyzed as specified by the associated combo box setting
+  string ASIMEventTreeName = ADAQSettings->ASIMEventTreeName;
+
+  ASIMEventTreeInfo *Info = NULL;
+  vector<ASIMEventTreeInfo>::iterator It;
+  for(It=ASIMEventTreeCatalog.begin(); It!=ASIMEventTreeCatalog.end(); It++)
+    if((*It).Name == ASIMEventTreeName)
+      Info = &(*It);
   
   // Bail out if the TTree cannot be found!
-  if(ASIMEventTree == NULL){
+  if(Info == NULL){
     cout << "Warning: The TTree named '" << ASIMEventTreeName << "' cannot be found!\n"
 	 << endl;
     return;
   }
   
-  // Set the branch address of the ASIM event
-  ASIMEventTree->SetBranchAddress("ASIMEventBranch", &ASIMEvt);
-  
+  // Only the single ASIMEvent data member required for the selected
+  // spectrum type is read from the (split) event branch
+  string Member;
+  if(ADAQSettings->ASIMSpectrumTypeEnergy)
+    Member = "EnergyDep";
+  else if(ADAQSettings->ASIMSpectrumTypePhotonsCreated)
+    Member = "PhotonsCreated";
+  else if(ADAQSettings->ASIMSpectrumTypePhotonsDetected)
+    Member = "PhotonsDetected";
+
   // When the user selected an ASIM EventTree via the combo box, the
   // ADAQSettings::WaveformsToHistogram NEL is updated to reflect the
   // total number of events contained within the TTree. This enables
   // the user to select a smaller number than the total entries via
   // this value without exceeding the maximum
-  int MaxEntriesToPlot = ADAQSettings->WaveformsToHistogram;
+  Long64_t MaxEntriesToPlot = ADAQSettings->WaveformsToHistogram;
+  
+  // The entries are divided into contiguous ranges that are each
+  // histogrammed by a separate thread. Each thread opens its own
+  // handle to the ASIM file and fills its own array of bin contents,
+  // which are summed into the spectrum once all threads complete
+  
+  Int_t NumThreads = boost::thread::hardware_concurrency();
+  if(NumThreads < 1)
+    NumThreads = 1;
+  if(MaxEntriesToPlot < NumThreads)
+    NumThreads = (MaxEntriesToPlot > 0) ? MaxEntriesToPlot : 1;
+  
+  CalibrationLookupStruct Calibration = CreateCalibrationLookup(ADAQSettings->WaveformChannel);
+
+  vector<ASIMSpectrumJob> Jobs(NumThreads);
+  for(Int_t t=0; t<NumThreads; t++){
+    Jobs[t].FileName = ASIMFiles[Info->FileIndex]->GetName();
+    Jobs[t].KeyName = Info->KeyName;
+    Jobs[t].Member = Member;
+    Jobs[t].First = (MaxEntriesToPlot * t) / NumThreads;
+    Jobs[t].Last = (MaxEntriesToPlot * (t+1)) / NumThreads;
+    Jobs[t].MinThresh = ADAQSettings->SpectrumMinThresh;
+    Jobs[t].MaxThresh = ADAQSettings->SpectrumMaxThresh;
+    Jobs[t].Calibration = Calibration;
+    Jobs[t].Axis = Spectrum_H->GetXaxis();
+    Jobs[t].Counts.assign(Spectrum_H->GetNbinsX()+2, 0.);
+    Jobs[t].Fills = 0;
+  }
+
+  // ROOT I/O from more than one thread requires the global locks
+  ROOT::EnableThreadSafety();
+  
+  boost::thread_group Threads;
+  for(Int_t t=0; t<NumThreads; t++)
+    Threads.create_thread(boost::bind(&AAComputation::ProcessASIMSpectrumJob, this, &Jobs[t]));
+  Threads.join_all();
+  
+  // Merge the threads' bin contents into the spectrum counts
+
+  SpectrumCounts.Initialize(ADAQSettings->SpectrumNumBins,
+			    ADAQSettings->SpectrumMinBin,
+			    ADAQSettings->SpectrumMaxBin);
+  
+  for(Int_t t=0; t<NumThreads; t++){
+    for(Int_t bin=0; bin<SpectrumCounts.GetNcells(); bin++)
+      SpectrumCounts.AddBinContent(bin, llround(Jobs[t].Counts[bin]));
+    SpectrumCounts.AddEntries(Jobs[t].Fills);
+  }
+
+  SpectrumCounts.CopyToHistogram(Spectrum_H);
+  
+  SpectrumExists = true;
+  SpectrumVersion++;
+}
+
 
-  for(int entry=0; entry<MaxEntriesToPlot; entry++){
+// Method to create spectra from multiple ASIM event trees in a
+// single pass. The names of the event trees to be histogrammed are
+// passed in; an empty vector results in all cataloged event trees
+// being histogrammed. All spectra share the same binning, thresholds
+// and calibration. Each event tree is histogrammed in its entirety
+// by a single thread with the trees distributed across all available
+// threads, which is efficient when many trees (one per detector or
+// volume) are present in the ASIM file(s)
+vector<TH1F *> AAComputation::CreateASIMSpectra(vector<string> Names)
+{
+  for(size_t s=0; s<ASIMSpectra_H.size(); s++)
+    delete ASIMSpectra_H[s];
+  ASIMSpectra_H.clear();
+  ASIMSpectraExist = false;
+  
+  if(Names.empty())
+    Names = GetASIMEventTreeNames();
+  
+  string Member;
+  if(ADAQSettings->ASIMSpectrumTypeEnergy)
+    Member = "EnergyDep";
+  else if(ADAQSettings->ASIMSpectrumTypePhotonsCreated)
+    Member = "PhotonsCreated";
+  else if(ADAQSettings->ASIMSpectrumTypePhotonsDetected)
+    Member = "PhotonsDetected";
+  
+  CalibrationLookupStruct Calibration = CreateCalibrationLookup(ADAQSettings->WaveformChannel);
+  
+  vector<ASIMSpectrumJob> Jobs;
+  
+  vector<string>::iterator It;
+  for(It=Names.begin(); It!=Names.end(); It++){
+    
+    ASIMEventTreeInfo *Info = NULL;
+    vector<ASIMEventTreeInfo>::iterator ItC;
+    for(ItC=ASIMEventTreeCatalog.begin(); ItC!=ASIMEventTreeCatalog.end(); ItC++)
+      if((*ItC).Name == (*It))
+	Info = &(*ItC);
+    
+    if(Info == NULL){
+      cout << "Warning: The TTree named '" << (*It) << "' cannot be found!\n"
+	   << endl;
+      continue;
+    }
     
-    ASIMEventTree->GetEvent(entry);
+    TH1F *Spectrum = new TH1F(("ASIMSpectrum_" + (*It)).c_str(), (*It).c_str(),
+			      ADAQSettings->SpectrumNumBins,
+			      ADAQSettings->SpectrumMinBin,
+			      ADAQSettings->SpectrumMaxBin);
+    Spectrum->SetDirectory(0);
+    ASIMSpectra_H.push_back(Spectrum);
+    
+    ASIMSpectrumJob Job;
+    Job.FileName = ASIMFiles[Info->FileIndex]->GetName();
+    Job.KeyName = Info->KeyName;
+    Job.Member = Member;
+    Job.First = 0;
+    Job.Last = -1;
+    Job.MinThresh = ADAQSettings->SpectrumMinThresh;
+    Job.MaxThresh = ADAQSettings->SpectrumMaxThresh;
+    Job.Calibration = Calibration;
+    Job.Axis = Spectrum->GetXaxis();
+    Job.Counts.assign(Spectrum->GetNbinsX()+2, 0.);
+    Job.Fills = 0;
+    Jobs.push_back(Job);
+  }
+  
+  if(Jobs.empty())
+    return ASIMSpectra_H;
+  
+  Int_t NumThreads = boost::thread::hardware_concurrency();
+  if(NumThreads < 1)
+    NumThreads = 1;
+  if(NumThreads > (Int_t)Jobs.size())
+    NumThreads = Jobs.size();
+  
+  ROOT::EnableThreadSafety();
+  
+  boost::thread_group Threads;
+  for(Int_t t=0; t<NumThreads; t++)
+    Threads.create_thread(boost::bind(&AAComputation::ProcessASIMSpectrumJobs, this, &Jobs, t, NumThreads));
+  Threads.join_all();
+  
+  for(size_t s=0; s<Jobs.size(); s++){
+    for(Int_t bin=0; bin<ASIMSpectra_H[s]->GetNbinsX()+2; bin++)
+      ASIMSpectra_H[s]->SetBinContent(bin, Jobs[s].Counts[bin]);
+    ASIMSpectra_H[s]->ResetStats();
+    ASIMSpectra_H[s]->SetEntries(Jobs[s].Fills);
+  }
+  
+  ASIMSpectraExist = true;
+  
+  return ASIMSpectra_H;
+}
+
+
+// Method run by each thread during multi-tree ASIM spectra creation
+// to process every Stride-th job beginning from Start
+void AAComputation::ProcessASIMSpectrumJobs(vector<ASIMSpectrumJob> *Jobs, Int_t Start, Int_t Stride)
+{
+  for(size_t j=Start; j<Jobs->size(); j+=Stride)
+    ProcessASIMSpectrumJob(&(*Jobs)[j]);
+}
 
-    double Quantity = 0.;
-    if(ADAQSettings->ASIMSpectrumTypeEnergy)
-      Quantity = ASIMEvt->GetEnergyDep();
-    else if(ADAQSettings->ASIMSpectrumTypePhotonsCreated)
-      Quantity = ASIMEvt->GetPhotonsCreated();
-    else if(ADAQSettings->ASIMSpectrumTypePhotonsDetected)
-      Quantity = ASIMEvt->GetPhotonsDetected();
 
-    if(ADAQSettings->UseSpectraCalibrations[ADAQSettings->WaveformChannel]){
-      if(SpectraCalibrationType[ADAQSettings->WaveformChannel] == zCalibrationFit)
-	Quantity = SpectraCalibrations[ADAQSettings->WaveformChannel]->Eval(Quantity);
-      else if(SpectraCalibrationType[ADAQSettings->WaveformChannel] == zCalibrationInterp)
-	Quantity = SpectraCalibrationData[ADAQSettings->WaveformChannel]->Eval(Quantity);
+// Method run by each thread during ASIM spectrum creation to
+// histogram a contiguous range of event tree entries
+void AAComputation::ProcessASIMSpectrumJob(ASIMSpectrumJob *Job)
+{
+  TFile *File = new TFile(Job->FileName.c_str(), "read");
+  TTree *Tree = NULL;
+  if(File->IsOpen())
+    Tree = (TTree *)File->Get(Job->KeyName.c_str());
+  
+  if(Tree){
+    ASIMEvent *Event = new ASIMEvent;
+    Tree->SetBranchAddress("ASIMEventBranch", &Event);
+    
+    // If the event branch is split then only enable the sub-branch
+    // of the required data member such that the remaining members
+    // (including the potentially large photon time vectors) are not
+    // read from file. Unsplit branches must be read in their entirety
+    if(Tree->GetBranch(Job->Member.c_str())){
+      Tree->SetBranchStatus("*", 0);
+      Tree->SetBranchStatus(Job->Member.c_str(), 1);
+    }
+    
+    // A negative last entry indicates the entire tree
+    Long64_t Last = (Job->Last < 0) ? Tree->GetEntries() : Job->Last;
+    
+    for(Long64_t entry=Job->First; entry<Last; entry++){
+      
+      Tree->GetEntry(entry);
+      
+      Double_t Quantity = 0.;
+      if(Job->Member == "EnergyDep")
+	Quantity = Event->GetEnergyDep();
+      else if(Job->Member == "PhotonsCreated")
+	Quantity = Event->GetPhotonsCreated();
+      else if(Job->Member == "PhotonsDetected")
+	Quantity = Event->GetPhotonsDetected();
+      
+      Quantity = Job->Calibration.Eval(Quantity);
+      
+      if(Quantity > Job->MinThresh and
+	 Quantity < Job->MaxThresh){
+	Job->Counts[Job->Axis->FindFixBin(Quantity)] += 1.;
+	Job->Fills++;
+      }
     }
+    
+    Tree->ResetBranchAddresses();
+    delete Event;
+  }
+  
+  File->Close();
+  delete File;
+}
 
-    if(Quantity > ADAQSettings->SpectrumMinThresh and
-       Quantity < ADAQSettings->SpectrumMaxThresh)
-      Spectrum_H->Fill(Quantity);
+
+// Method to convert the entire (calibrated) spectrum from electron
+// equivalent energy [MeVee] into the energy of the incident particle
+// specified by the EnergyConversionType enumerator. The edges of each
+// source bin are converted using the AAInterpolation response tables
+// and the bin contents are distributed over the target bins in
+// proportion to the overlap of the converted source bin with each
+// target bin. Counts are therefore conserved and the spectral density
+// is correctly transformed by the Jacobian of the (nonlinear)
+// conversion. The source bins are divided amongst multiple threads.
+Bool_t AAComputation::CreateConvertedSpectrum(Int_t Type)
+{
+  AAInterpolation *InterpolationMgr = AAInterpolation::GetInstance();
+  
+  if(!SpectrumExists or !InterpolationMgr)
+    return false;
+
+  TH1F *Source_H = Spectrum_H;
+  if(ADAQSettings->FindBackground and ADAQSettings->PlotLessBackground){
+    UpdateSpectrumProduct(zSpectrumBackgroundProduct);
+    Source_H = SpectrumDeconvolved_H;
   }
-  SpectrumExists = true;
+
+  const Int_t NumBins = Source_H->GetNbinsX();
+  
+  // The converted bin edges are monotonic since the response tables
+  // are monotonic; negative energies are unphysical and excluded
+  vector<Double_t> Edges = InterpolationMgr->ConvertBinEdges(Source_H, Type);
+  
+  Double_t Min = (Edges[0] > 0.) ? Edges[0] : 0.;
+  Double_t Max = Edges[NumBins];
+
+  if(Max <= Min)
+    return false;
+
+  string Title, XTitle;
+  if(Type == zGammaEnergy){
+    Title = "Gamma energy spectrum";
+    XTitle = "Gamma energy [MeV]";
+  }
+  else if(Type == zProtonEnergy){
+    Title = "Proton energy spectrum";
+    XTitle = "Proton energy [MeV]";
+  }
+  else if(Type == zAlphaEnergy){
+    Title = "Alpha energy spectrum";
+    XTitle = "Alpha energy [MeV]";
+  }
+  else if(Type == zCarbonEnergy){
+    Title = "Carbon energy spectrum";
+    XTitle = "Carbon energy [GeV]";
+  }
+  
+  // The histogram allocated at construction is replaced as well
+  delete ConvertedSpectrum_H;
+  
+  ConvertedSpectrum_H = new TH1F("ConvertedSpectrum_H", Title.c_str(), NumBins, Min, Max);
+  ConvertedSpectrum_H->GetXaxis()->SetTitle(XTitle.c_str());
+  ConvertedSpectrum_H->GetYaxis()->SetTitle("Counts");
+  
+  Int_t NumThreads = boost::thread::hardware_concurrency();
+  if(NumThreads < 1)
+    NumThreads = 1;
+  if(NumThreads > NumBins)
+    NumThreads = NumBins;
+  
+  vector<SpectrumConversionJob> Jobs(NumThreads);
+  for(Int_t t=0; t<NumThreads; t++){
+    Jobs[t].FirstBin = 1 + (NumBins * t) / NumThreads;
+    Jobs[t].LastBin = (NumBins * (t+1)) / NumThreads;
+    Jobs[t].Source = Source_H;
+    Jobs[t].Edges = &Edges;
+    Jobs[t].Axis = ConvertedSpectrum_H->GetXaxis();
+    Jobs[t].Counts.assign(NumBins+2, 0.);
+  }
+  
+  boost::thread_group Threads;
+  for(Int_t t=0; t<NumThreads; t++)
+    Threads.create_thread(boost::bind(&AAComputation::ProcessSpectrumConversionJob, this, &Jobs[t]));
+  Threads.join_all();
+  
+  Double_t Entries = 0.;
+  for(Int_t bin=0; bin<NumBins+2; bin++){
+    Double_t Content = 0.;
+    for(Int_t t=0; t<NumThreads; t++)
+      Content += Jobs[t].Counts[bin];
+    ConvertedSpectrum_H->SetBinContent(bin, Content);
+    Entries += Content;
+  }
+  
+  ConvertedSpectrum_H->ResetStats();
+  ConvertedSpectrum_H->SetEntries(Entries);
+  
+  ConvertedSpectrumExists = true;
+
+  return true;
 }
 
 
+// Method run by each thread during spectrum conversion to remap a
+// contiguous range of source bins onto the converted energy axis
+void AAComputation::ProcessSpectrumConversionJob(SpectrumConversionJob *Job)
+{
+  const Int_t NumBins = Job->Axis->GetNbins();
+  const Double_t AxisMin = Job->Axis->GetXmin();
+  const Double_t AxisMax = Job->Axis->GetXmax();
+  
+  for(Int_t bin=Job->FirstBin; bin<=Job->LastBin; bin++){
+    
+    Double_t Content = Job->Source->GetBinContent(bin);
+    if(Content == 0.)
+      continue;
+    
+    Double_t Lower = (*Job->Edges)[bin-1];
+    Double_t Upper = (*Job->Edges)[bin];
+    Double_t Width = Upper - Lower;
+    
+    Int_t FirstTarget = Job->Axis->FindFixBin(Lower);
+    Int_t LastTarget = Job->Axis->FindFixBin(Upper);
+    
+    // A source bin that maps entirely into a single target bin (or
+    // collapses to a point) deposits its entire contents there
+    if(FirstTarget == LastTarget or Width <= 0.){
+      Job->Counts[FirstTarget] += Content;
+      continue;
+    }
+    
+    for(Int_t target=FirstTarget; target<=LastTarget; target++){
+      
+      // The under/overflow bins extend to -/+ infinity
+      Double_t TargetLower = (target == 0) ? Lower : Job->Axis->GetBinLowEdge(target);
+      Double_t TargetUpper = (target == NumBins+1) ? Upper : Job->Axis->GetBinUpEdge(target);
+      if(target == 0)
+	TargetUpper = AxisMin;
+      if(target == NumBins+1)
+	TargetLower = AxisMax;
+      
+      Double_t Overlap = min(Upper, TargetUpper) - max(Lower, TargetLower);
+      if(Overlap > 0.)
+	Job->Counts[target] += Content * Overlap / Width;
+    }
+  }
+}
+
 void AAComputation::AnalyzeWaveform(TH1F *Histogram_H)
 {
   WaveformAnalysisHeight = Histogram_H->GetBinContent(Histogram_H->GetMaximumBin());
@@ -3879,3 +6829,345 @@ Bool_t AAComputation::RejectPSD(Int_t Channel, Int_t Waveform)
   CalculatePSDIntegrals(false);
   return PeakInfoVec[0].PSDFilterFlag;
 }
+
+
+// Method to build the waveform summary index. The index stores a
+// compact summary (height, area, PSD integrals, etc) of every entry
+// in the ADAQ TTree on the present channel so that the waveforms
+// satisfying a selection criterion can be located without
+// recomputing each waveform in turn. The index is built once in a
+// separate thread that opens its own handle to the ADAQ file such
+// that the GUI remains fully usable during the build
+void AAComputation::BuildWaveformIndex()
+{
+  if(!ADAQFileLoaded)
+    return;
+  
+  {
+    boost::lock_guard<boost::mutex> Lock(WaveformIndexMutex);
+    
+    if(WaveformIndexBuilding)
+      return;
+    
+    WaveformIndexKey Key = CreateWaveformIndexKey();
+    if(WaveformIndexReady and WaveformIndexKeyMatches(Key))
+      return;
+    
+    WaveformIndexReady = false;
+    WaveformIndexBuilding = true;
+  }
+
+  // Store the trigger thresholds for determining which channels
+  // triggered. Note that legacy files were created exclusively with
+  // the 8 channel V1720 digitizer
+  vector<Int_t> Triggers;
+  if(ADAQLegacyFileLoaded){
+    for(Int_t ch=0; ch<8; ch++)
+      Triggers.push_back(ADAQMeasParams->TriggerThreshold[ch]);
+  }
+  else{
+    for(Int_t ch=0; ch<ARI->GetDGNumChannels(); ch++)
+      Triggers.push_back(ARI->GetTrigger()[ch]);
+  }
+
+  // ROOT I/O from more than one thread requires the global locks
+  ROOT::EnableThreadSafety();
+  
+  if(WaveformIndexThread){
+    WaveformIndexThread->join();
+    delete WaveformIndexThread;
+  }
+
+  WaveformIndexCancelled.store(false);
+  
+  WaveformIndexThread = new boost::thread(&AAComputation::BuildWaveformIndexWorker,
+					  this,
+					  CreateWaveformIndexKey(),
+					  Triggers,
+					  ADAQLegacyFileLoaded);
+}
+
+
+void AAComputation::BuildWaveformIndexWorker(WaveformIndexKey Key,
+					     vector<Int_t> Triggers,
+					     Bool_t Legacy)
+{
+  vector<WaveformSummaryStruct> Index;
+  
+  TFile *IndexFile = new TFile(Key.FileName.c_str(), "read");
+  TTree *IndexTree = NULL;
+  if(IndexFile->IsOpen())
+    IndexTree = (TTree *)IndexFile->Get("WaveformTree");
+
+  if(IndexTree){
+    
+    // Only the waveform branches are needed for the summaries so
+    // disable all others to minimize the amount of data read
+    IndexTree->SetBranchStatus("*", 0);
+    
+    Int_t NumChannels = Triggers.size();
+    vector<vector<Int_t> *> Voltages(NumChannels, (vector<Int_t> *)0);
+    
+    for(Int_t ch=0; ch<NumChannels; ch++){
+      stringstream SS;
+      if(Legacy)
+	SS << "VoltageInADC_Ch" << ch;
+      else
+	SS << "WaveformCh" << ch;
+      
+      if(IndexTree->GetBranch(SS.str().c_str())){
+	IndexTree->SetBranchStatus(SS.str().c_str(), 1);
+	IndexTree->SetBranchAddress(SS.str().c_str(), &Voltages[ch]);
+      }
+    }
+    
+    Long64_t Entries = IndexTree->GetEntries();
+    Index.resize(Entries);
+
+    vector<Double_t> Voltage;
+    
+    for(Long64_t entry=0; entry<Entries; entry++){
+
+      if(WaveformIndexCancelled.load(memory_order_relaxed))
+	break;
+      
+      IndexTree->GetEntry(entry);
+      
+      WaveformSummaryStruct &Summary = Index[entry];
+      
+      // Determine which channels crossed their trigger threshold
+      for(Int_t ch=0; ch<NumChannels; ch++){
+	if(!Voltages[ch] or Voltages[ch]->empty())
+	  continue;
+	
+	if(Key.Polarity > 0){
+	  if(*max_element(Voltages[ch]->begin(), Voltages[ch]->end()) >= Triggers[ch])
+	    Summary.TriggeredChannels |= (1 << ch);
+	}
+	else{
+	  if(*min_element(Voltages[ch]->begin(), Voltages[ch]->end()) <= Triggers[ch])
+	    Summary.TriggeredChannels |= (1 << ch);
+	}
+      }
+
+      // The remaining summary values are computed on the analysis
+      // channel using the same conventions as RejectPSD(), i.e. a
+      // baseline-subtracted waveform with the "whole waveform" peak
+      
+      if(Key.Channel >= NumChannels or !Voltages[Key.Channel])
+	continue;
+
+      vector<Int_t> *RawVoltage = Voltages[Key.Channel];
+      Int_t Size = RawVoltage->size();
+      
+      if(Size < 2 or Size < Key.BaselineRegionMax)
+	continue;
+
+      Double_t Baseline = 0.;
+      Int_t BaselineRegionLength = Key.BaselineRegionMax - Key.BaselineRegionMin;
+      for(Int_t sample=Key.BaselineRegionMin; sample<Key.BaselineRegionMax; sample++)
+	Baseline += ((*RawVoltage)[sample]*1.0/BaselineRegionLength);
+
+      Voltage.resize(Size);
+      for(Int_t sample=0; sample<Size; sample++)
+	Voltage[sample] = Key.Polarity * ((*RawVoltage)[sample] - Baseline);
+      
+      // Note that the first sample is the underflow bin of the TH1F
+      // waveform and is therefore excluded from the maximum search
+      Int_t Peak = max_element(Voltage.begin()+1, Voltage.end()) - Voltage.begin();
+      
+      Summary.MaxHeight = Voltage[Peak];
+
+      Double_t Area = 0.;
+      for(Int_t sample=0; sample<Size; sample++)
+	Area += Voltage[sample];
+      Summary.Area = Area;
+
+      Int_t NumPeaks = 0;
+      for(Int_t sample=1; sample<Size; sample++)
+	if(Voltage[sample-1] < Key.Floor and Voltage[sample] >= Key.Floor)
+	  NumPeaks++;
+      Summary.NumPeaks = NumPeaks;
+      
+      Summary.InAnalysisRegion = (Peak >= Key.AnalysisRegionMin and
+				  Peak <= Key.AnalysisRegionMax);
+      
+      // Compute the PSD integrals with inclusive limits that are
+      // bounded by the waveform in the same manner as TH1::Integral()
+      Int_t Limits[2][2] = {{Peak + Key.PSDTotalStart, Peak + Key.PSDTotalStop},
+			    {Peak + Key.PSDTailStart, Peak + Key.PSDTailStop}};
+      Double_t Integrals[2] = {0., 0.};
+      
+      for(Int_t i=0; i<2; i++){
+	Int_t Lower = max(Limits[i][0], 0);
+	Int_t Upper = min(Limits[i][1], Size-1);
+	for(Int_t sample=Lower; sample<=Upper; sample++)
+	  Integrals[i] += Voltage[sample];
+      }
+      
+      Summary.PSDTotal = Integrals[0];
+      Summary.PSDTail = Integrals[1];
+    }
+  }
+  
+  IndexFile->Close();
+  delete IndexFile;
+
+  boost::lock_guard<boost::mutex> Lock(WaveformIndexMutex);
+  WaveformIndex.swap(Index);
+  WaveformIndexSettings = Key;
+  // The partial index of a cancelled build is never used
+  WaveformIndexReady = (IndexTree != NULL and !WaveformIndexCancelled.load());
+  WaveformIndexBuilding = false;
+}
+
+
+AAComputation::WaveformIndexKey AAComputation::CreateWaveformIndexKey()
+{
+  WaveformIndexKey Key;
+  Key.FileName = ADAQFileName;
+  Key.Channel = ADAQSettings->WaveformChannel;
+  Key.Polarity = ADAQSettings->WaveformPolarity;
+  Key.Floor = ADAQSettings->Floor;
+  Key.BaselineRegionMin = ADAQSettings->BaselineRegionMin;
+  Key.BaselineRegionMax = ADAQSettings->BaselineRegionMax;
+  Key.AnalysisRegionMin = ADAQSettings->AnalysisRegionMin;
+  Key.AnalysisRegionMax = ADAQSettings->AnalysisRegionMax;
+  Key.PSDTotalStart = ADAQSettings->PSDTotalStart;
+  Key.PSDTotalStop = ADAQSettings->PSDTotalStop;
+  Key.PSDTailStart = ADAQSettings->PSDTailStart;
+  Key.PSDTailStop = ADAQSettings->PSDTailStop;
+  return Key;
+}
+
+
+Bool_t AAComputation::WaveformIndexKeyMatches(WaveformIndexKey &Key)
+{
+  return (Key.FileName == WaveformIndexSettings.FileName and
+	  Key.Channel == WaveformIndexSettings.Channel and
+	  Key.Polarity == WaveformIndexSettings.Polarity and
+	  Key.Floor == WaveformIndexSettings.Floor and
+	  Key.BaselineRegionMin == WaveformIndexSettings.BaselineRegionMin and
+	  Key.BaselineRegionMax == WaveformIndexSettings.BaselineRegionMax and
+	  Key.AnalysisRegionMin == WaveformIndexSettings.AnalysisRegionMin and
+	  Key.AnalysisRegionMax == WaveformIndexSettings.AnalysisRegionMax and
+	  Key.PSDTotalStart == WaveformIndexSettings.PSDTotalStart and
+	  Key.PSDTotalStop == WaveformIndexSettings.PSDTotalStop and
+	  Key.PSDTailStart == WaveformIndexSettings.PSDTailStart and
+	  Key.PSDTailStop == WaveformIndexSettings.PSDTailStop);
+}
+
+
+// The index is valid only if it has been completely built with the
+// same settings as are presently selected by the user
+Bool_t AAComputation::GetWaveformIndexValid()
+{
+  boost::lock_guard<boost::mutex> Lock(WaveformIndexMutex);
+  WaveformIndexKey Key = CreateWaveformIndexKey();
+  return (WaveformIndexReady and WaveformIndexKeyMatches(Key));
+}
+
+
+Bool_t AAComputation::GetWaveformIndexBuilding()
+{
+  boost::lock_guard<boost::mutex> Lock(WaveformIndexMutex);
+  return WaveformIndexBuilding;
+}
+
+
+// Method to stop a waveform index build at the next entry and to
+// join the index thread, e.g. before the application exits
+void AAComputation::CancelWaveformIndex()
+{
+  WaveformIndexCancelled.store(true);
+  
+  if(WaveformIndexThread){
+    WaveformIndexThread->join();
+    delete WaveformIndexThread;
+    WaveformIndexThread = NULL;
+  }
+}
+
+
+// Apply the same PSD integral transformations and PSD region as
+// CalculatePSDIntegrals() to an indexed waveform. The return
+// convention is true : accept waveform; false : reject waveform
+Bool_t AAComputation::IndexedWaveformPassesPSD(WaveformSummaryStruct &Summary)
+{
+  Int_t Channel = ADAQSettings->WaveformChannel;
+
+  if(!Summary.InAnalysisRegion or !ADAQSettings->UsePSDRegions[Channel])
+    return true;
+  
+  Double_t TotalIntegral = Summary.PSDTotal;
+  Double_t TailIntegral = Summary.PSDTail;
+
+  if(ADAQSettings->PSDYAxisTailTotal)
+    TailIntegral /= TotalIntegral;
+  
+  if(ADAQSettings->PSDXAxisEnergy and ADAQSettings->UseSpectraCalibrations[Channel]){
+    if(SpectraCalibrationType[Channel] == zCalibrationFit)
+      TotalIntegral = ADAQSettings->SpectraCalibrations[Channel]->Eval(TotalIntegral);
+    else if(SpectraCalibrationType[Channel] == zCalibrationInterp)
+      TotalIntegral = ADAQSettings->SpectraCalibrationData[Channel]->Eval(TotalIntegral);
+  }
+  
+  return !ApplyPSDRegion(TotalIntegral, TailIntegral);
+}
+
+
+// Return the first waveform at or after 'Start' that is accepted by
+// the present PSD region or -1 if no such waveform exists
+Int_t AAComputation::FindNextPSDWaveform(Int_t Start)
+{
+  boost::lock_guard<boost::mutex> Lock(WaveformIndexMutex);
+  
+  WaveformIndexKey Key = CreateWaveformIndexKey();
+  if(!WaveformIndexReady or !WaveformIndexKeyMatches(Key))
+    return -1;
+  
+  Int_t Entries = WaveformIndex.size();
+  for(Int_t entry=max(Start,0); entry<Entries; entry++)
+    if(IndexedWaveformPassesPSD(WaveformIndex[entry]))
+      return entry;
+  
+  return -1;
+}
+
+
+// Return the first waveform at or after 'Start' whose maximum height
+// lies within [Min, Max] or -1 if no such waveform exists
+Int_t AAComputation::FindNextWaveformInHeightRange(Int_t Start, Double_t Min, Double_t Max)
+{
+  boost::lock_guard<boost::mutex> Lock(WaveformIndexMutex);
+  
+  WaveformIndexKey Key = CreateWaveformIndexKey();
+  if(!WaveformIndexReady or !WaveformIndexKeyMatches(Key))
+    return -1;
+
+  Int_t Entries = WaveformIndex.size();
+  for(Int_t entry=max(Start,0); entry<Entries; entry++)
+    if(WaveformIndex[entry].MaxHeight >= Min and WaveformIndex[entry].MaxHeight <= Max)
+      return entry;
+  
+  return -1;
+}
+
+
+vector<Int_t> AAComputation::FindWaveformsInHeightRange(Double_t Min, Double_t Max)
+{
+  vector<Int_t> Matches;
+
+  boost::lock_guard<boost::mutex> Lock(WaveformIndexMutex);
+
+  WaveformIndexKey Key = CreateWaveformIndexKey();
+  if(!WaveformIndexReady or !WaveformIndexKeyMatches(Key))
+    return Matches;
+
+  Int_t Entries = WaveformIndex.size();
+  for(Int_t entry=0; entry<Entries; entry++)
+    if(WaveformIndex[entry].MaxHeight >= Min and WaveformIndex[entry].MaxHeight <= Max)
+      Matches.push_back(entry);
+
+  return Matches;
+}
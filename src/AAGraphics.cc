@@ -63,17 +63,22 @@ AAGraphics *AAGraphics::GetInstance()
 
 
 AAGraphics::AAGraphics()
-  : Trigger_L(new TLine), Floor_L(new TLine), ZSCeiling_L(new TLine),
+  : Spectrum_H(NULL), SpectrumBackground_H(NULL), SpectrumOverplot_H(NULL),
+    SpectrumOverlayFrame_H(NULL), SpectrumOverlay_L(NULL),
+    Trigger_L(new TLine), Floor_L(new TLine), ZSCeiling_L(new TLine),
     Analysis_B(new TBox), Baseline_B(new TBox), 
     LPeakDelimiter_L(new TLine), RPeakDelimiter_L(new TLine), IntegrationRegion_B(new TBox),
     PSDTotal_B(new TBox), PSDPeak_L(new TLine), PSDTail_L0(new TLine), PSDTail_L1(new TLine),
     HCalibration_L(new TLine), VCalibration_L(new TLine), CalibrationBoundingBox_B(new TBox),
     EALine_L(new TLine), EABox_B(new TBox), DerivativeReference_L(new TLine),
     PSDRegionProgress_G(new TGraph),
+    WaveformLOD_G(new TGraph), PSDHistogramLOD_H(NULL),
     CanvasContentType(zEmpty), 
     WaveformColor(kBlue), WaveformLineWidth(1), WaveformMarkerSize(1.),
     SpectrumLineColor(kBlue), SpectrumLineWidth(2), 
-    SpectrumFillColor(kRed), SpectrumFillStyle(3002), PSDFigureOfMerit(0.)
+    SpectrumFillColor(kRed), SpectrumFillStyle(3002),
+    PSDLowerFOMFit_F(new TF1("PSDLowerFOMFit", "gaus", 0, 1)),
+    PSDUpperFOMFit_F(new TF1("PSDUpperFOMFit", "gaus", 0, 1))
 {
   if(TheGraphicsManager)
     cout << "\nERROR! TheGraphicsManager was constructed twice\n" << endl;
@@ -314,8 +319,35 @@ void AAGraphics::PlotWaveform(int Color)
     DrawString = "P";
   else if(ADAQSettings->WaveformBoth)
     DrawString = "CP";
+
+  // Waveforms with many more samples in the visible range than there
+  // are pixels across the canvas (e.g. long zero suppressed or
+  // despliced records) are drawn as a min/max decimated graph over
+  // the histogram axes. Since the decimation is recomputed for the
+  // visible range, full resolution is restored as the user zooms in
+  
+  Int_t FirstBin = Waveform_H->GetXaxis()->GetFirst();
+  Int_t LastBin = Waveform_H->GetXaxis()->GetLast();
+  Int_t Columns = GetCanvasPixelsX();
+
+  Bool_t Decimated = (LastBin-FirstBin+1 > WaveformDecimationFactor*Columns);
   
-  Waveform_H->Draw(DrawString.c_str());
+  string GraphDrawString = (DrawString == "") ? "L" : DrawString;
+  
+  if(Decimated){
+    DecimateWaveform(Waveform_H, FirstBin, LastBin, Columns);
+    
+    WaveformLOD_G->SetLineColor(WaveformColor);
+    WaveformLOD_G->SetLineWidth(ADAQSettings->WaveformLineWidth);
+    WaveformLOD_G->SetMarkerStyle(24);
+    WaveformLOD_G->SetMarkerSize(ADAQSettings->WaveformMarkerSize);
+    WaveformLOD_G->SetMarkerColor(WaveformColor);
+
+    Waveform_H->Draw("AXIS");
+    WaveformLOD_G->Draw(GraphDrawString.c_str());
+  }
+  else
+    Waveform_H->Draw(DrawString.c_str());
     
   if(ADAQSettings->PlotZeroSuppressionCeiling)
     ZSCeiling_L->DrawLine(XMin,
@@ -382,9 +414,16 @@ void AAGraphics::PlotWaveform(int Color)
 	Waveform_H->SetLineColor(kRed);
       else
 	Waveform_H->SetLineColor(kGreen+2);
-      
-      string NewDrawString = DrawString + " SAME";
-      Waveform_H->Draw(DrawString.c_str());
+
+      if(Decimated){
+	WaveformLOD_G->SetLineColor(Waveform_H->GetLineColor());
+	Waveform_H->Draw("AXIS");
+	WaveformLOD_G->Draw(GraphDrawString.c_str());
+      }
+      else{
+	string NewDrawString = DrawString + " SAME";
+	Waveform_H->Draw(DrawString.c_str());
+      }
     }
     
     if(ADAQSettings->FindPeaks){
@@ -483,13 +522,23 @@ void AAGraphics::PlotWaveform(int Color)
 
 void AAGraphics::PlotSpectrum()
 {
+  // Bring the background and integral products up to date; each is
+  // only recomputed if its settings have changed since it was last
+  // computed, which is typically not the case when replotting
+  if(ADAQSettings->FindBackground)
+    ComputationMgr->UpdateSpectrumProduct(zSpectrumBackgroundProduct);
+  
+  if(ADAQSettings->SpectrumFindIntegral or ADAQSettings->SpectrumUseGaussianFit)
+    ComputationMgr->UpdateSpectrumProduct(zSpectrumIntegralProduct);
+
+  
   //////////////////////////////////
   // Determine main spectrum to plot
 
   if(ADAQSettings->FindBackground and ADAQSettings->PlotLessBackground)
-    Spectrum_H = ComputationMgr->GetSpectrumWithoutBackground();
+    CopyForDisplay(ComputationMgr->GetSpectrumWithoutBackground(), Spectrum_H);
   else
-    Spectrum_H = ComputationMgr->GetSpectrum();
+    CopyForDisplay(ComputationMgr->GetSpectrum(), Spectrum_H);
 
   if(!Spectrum_H)
     return;
@@ -634,7 +683,7 @@ void AAGraphics::PlotSpectrum()
   // Overplot a thin curve on the error bars to help the user's eye
   // make sense of what is typically difficult-to-interpret data
   if(ADAQSettings->SpectrumError){
-    TH1F *SpectrumOverplot_H = (TH1F *)Spectrum_H->Clone("SpectrumOverplot_H");
+    CopyForDisplay(Spectrum_H, SpectrumOverplot_H);
     SpectrumOverplot_H->SetLineColor(SpectrumLineColor);
     SpectrumOverplot_H->SetLineWidth(1);
     SpectrumOverplot_H->Draw("C SAME");
@@ -643,7 +692,7 @@ void AAGraphics::PlotSpectrum()
   ////////////////////////////////////////////
   // Overlay the background spectra if desired
   if(ADAQSettings->FindBackground and ADAQSettings->PlotWithBackground){
-    TH1F *SpectrumBackground_H = ComputationMgr->GetSpectrumBackground();
+    CopyForDisplay(ComputationMgr->GetSpectrumBackground(), SpectrumBackground_H);
     SpectrumBackground_H->GetXaxis()->SetRangeUser(XMin, XMax);
     SpectrumBackground_H->Draw("C SAME");
   }
@@ -683,6 +732,110 @@ void AAGraphics::PlotSpectrum()
 }
 
 
+// Method to copy a computed spectrum into a display histogram that is
+// owned by the graphics manager and may be freely restyled. Each
+// display histogram is allocated once; thereafter only its contents
+// and attributes are overwritten such that replotting neither
+// allocates nor leaks a copy of the spectrum
+void AAGraphics::CopyForDisplay(const TH1F *Source, TH1F *&Display)
+{
+  if(!Display)
+    Display = new TH1F;
+  
+  Source->Copy(*Display);
+  Display->SetDirectory(0);
+}
+
+
+// Methods to return the width and height [pixels] of the frame
+// within the canvas margins into which histograms are drawn
+Int_t AAGraphics::GetCanvasPixelsX()
+{
+  return max(1, Int_t(TheCanvas->GetWw() * (1 - TheCanvas->GetLeftMargin() - TheCanvas->GetRightMargin())));
+}
+
+
+Int_t AAGraphics::GetCanvasPixelsY()
+{
+  return max(1, Int_t(TheCanvas->GetWh() * (1 - TheCanvas->GetTopMargin() - TheCanvas->GetBottomMargin())));
+}
+
+
+// Method to reduce the visible bins of a waveform to the minimum and
+// maximum sample within each pixel column of the canvas, stored in
+// the order in which they occur such that peaks, edges, and noise
+// excursions are preserved exactly as the full waveform would appear
+void AAGraphics::DecimateWaveform(TH1F *Waveform_H, Int_t FirstBin, Int_t LastBin, Int_t Columns)
+{
+  const Float_t *Contents = Waveform_H->GetArray();
+  const Int_t NumBins = LastBin - FirstBin + 1;
+  
+  WaveformLOD_G->Set(2*Columns);
+  
+  Int_t Point = 0;
+  for(Int_t c=0; c<Columns; c++){
+    Int_t Start = FirstBin + Int_t((Long64_t)NumBins * c / Columns);
+    Int_t End = FirstBin + Int_t((Long64_t)NumBins * (c+1) / Columns);
+    
+    if(End <= Start)
+      continue;
+    
+    Int_t MinBin = Start, MaxBin = Start;
+    for(Int_t bin=Start+1; bin<End; bin++){
+      if(Contents[bin] < Contents[MinBin])
+	MinBin = bin;
+      else if(Contents[bin] > Contents[MaxBin])
+	MaxBin = bin;
+    }
+    
+    Int_t First = min(MinBin, MaxBin);
+    Int_t Second = max(MinBin, MaxBin);
+    
+    WaveformLOD_G->SetPoint(Point++, Waveform_H->GetBinCenter(First), Contents[First]);
+    if(Second != First)
+      WaveformLOD_G->SetPoint(Point++, Waveform_H->GetBinCenter(Second), Contents[Second]);
+  }
+  
+  WaveformLOD_G->Set(Point);
+}
+
+
+// Method to return a rebinned copy of a PSD histogram for display if
+// the visible range contains more bins than there are canvas pixels
+// in either direction; otherwise the histogram itself is returned.
+// Adjacent bins are summed (as with TH2::Rebin2D) such that the
+// display copy holds at most about one bin per pixel. Since the
+// rebinning is recomputed for the visible range on every plot, full
+// resolution is restored as the user zooms in
+TH2F *AAGraphics::RebinForDisplay(TH2F *PSDHistogram_H)
+{
+  TAxis *XAxis = PSDHistogram_H->GetXaxis();
+  TAxis *YAxis = PSDHistogram_H->GetYaxis();
+  
+  Int_t GroupX = max(1, (XAxis->GetLast() - XAxis->GetFirst() + 1) / GetCanvasPixelsX());
+  Int_t GroupY = max(1, (YAxis->GetLast() - YAxis->GetFirst() + 1) / GetCanvasPixelsY());
+  
+  if(GroupX == 1 and GroupY == 1)
+    return PSDHistogram_H;
+
+  // The previous display copy may still be drawn on the canvas
+  if(PSDHistogramLOD_H){
+    TheCanvas->GetListOfPrimitives()->Remove(PSDHistogramLOD_H);
+    delete PSDHistogramLOD_H;
+  }
+  
+  PSDHistogramLOD_H = (TH2F *)PSDHistogram_H->Rebin2D(GroupX, GroupY, "PSDHistogramLOD_H");
+  PSDHistogramLOD_H->SetDirectory(0);
+  
+  PSDHistogramLOD_H->GetXaxis()->SetRangeUser(XAxis->GetBinLowEdge(XAxis->GetFirst()),
+					      XAxis->GetBinUpEdge(XAxis->GetLast()));
+  PSDHistogramLOD_H->GetYaxis()->SetRangeUser(YAxis->GetBinLowEdge(YAxis->GetFirst()),
+					      YAxis->GetBinUpEdge(YAxis->GetLast()));
+  
+  return PSDHistogramLOD_H;
+}
+
+
 // Method to extract the digitized data on the specified data channel
 // and store it into a TH1F object as a "raw" waveform. Note that the
 // baseline must be calculated in this method even though it is not
@@ -715,6 +868,10 @@ void AAGraphics::PlotPSDHistogram()
   Double_t YMin = PSDHistogram_H->GetYaxis()->GetXmax() * (1-ADAQSettings->YAxisMax);
   Double_t YMax = PSDHistogram_H->GetYaxis()->GetXmax() * (1-ADAQSettings->YAxisMin);
   PSDHistogram_H->GetYaxis()->SetRangeUser(YMin, YMax);
+
+  // Draw a coarser copy of the PSD histogram if the visible range
+  // contains more bins than there are pixels across the canvas
+  PSDHistogram_H = RebinForDisplay(PSDHistogram_H);
   
   string Title, XTitle, YTitle, ZTitle, PaletteTitle;
 
@@ -814,9 +971,187 @@ void AAGraphics::PlotPSDHistogram()
 }
 
 
+// Method to overlay the spectra created from multiple ASIM event
+// trees, each in a distinct color and identified in a legend
+void AAGraphics::PlotASIMSpectra()
+{
+  string XTitle;
+  if(ADAQSettings->ASIMSpectrumTypeEnergy)
+    XTitle = "Energy deposited [MeV]";
+  else if(ADAQSettings->ASIMSpectrumTypePhotonsCreated)
+    XTitle = "Visible photons created [#]";
+  else if(ADAQSettings->ASIMSpectrumTypePhotonsDetected)
+    XTitle = "Visible photons detected [#]";
+
+  PlotSpectrumOverlay(ComputationMgr->GetASIMSpectra(), "ASIM Spectra", XTitle);
+}
+
+
+// Method to overlay the spectra created during a settings sweep, one
+// per variant of the waveform extraction parameters
+void AAGraphics::PlotSettingsSweepSpectra()
+{
+  string XTitle;
+  if(ComputationMgr->GetUseSpectraCalibrations()[ADAQSettings->WaveformChannel])
+    XTitle = "Energy deposited [" + ADAQSettings->CalibrationUnit + "]";
+  else if(ADAQSettings->ADAQSpectrumTypePAS)
+    XTitle = "Pulse area [ADC]";
+  else if(ADAQSettings->ADAQSpectrumTypePHS)
+    XTitle = "Pulse height [ADC]";
+
+  PlotSpectrumOverlay(ComputationMgr->GetSettingsSweepSpectra(), "Settings Sweep Spectra", XTitle);
+}
+
+
+// Method to overlay a set of spectra with identical binning, each in
+// a distinct color and identified in a legend by its title
+void AAGraphics::PlotSpectrumOverlay(vector<TH1F *> Spectra, string Title, string XTitle)
+{
+  if(Spectra.empty())
+    return;
+  
+  Double_t XMinBin = ADAQSettings->SpectrumMinBin;
+  Double_t XMaxBin = ADAQSettings->SpectrumMaxBin;
+  Double_t Range = XMaxBin - XMinBin;
+
+  Double_t XMin = XMinBin + (Range * ADAQSettings->XAxisMin);
+  Double_t XMax = XMinBin + (Range * ADAQSettings->XAxisMax);
+  
+  // The y-axis range is set from the largest bin content of all
+  // spectra such that every spectrum is fully visible
+  Double_t Maximum = 0.;
+  for(size_t s=0; s<Spectra.size(); s++)
+    if(Spectra[s]->GetMaximum() > Maximum)
+      Maximum = Spectra[s]->GetMaximum();
+  
+  Double_t YMin = 0.;
+  if(ADAQSettings->CanvasYAxisLog and ADAQSettings->YAxisMax==1)
+    YMin = 1.0;
+  else
+    YMin = Maximum * (1-ADAQSettings->YAxisMax);
+  Double_t YMax = Maximum * (1-ADAQSettings->YAxisMin) * 1.05;
+  
+  gPad->SetGrid(ADAQSettings->CanvasGrid, ADAQSettings->CanvasGrid);
+  gPad->SetLogx(ADAQSettings->CanvasXAxisLog);
+  gPad->SetLogy(ADAQSettings->CanvasYAxisLog);
+
+  TheCanvas->SetLeftMargin(0.13);
+  TheCanvas->SetBottomMargin(0.12);
+  TheCanvas->SetRightMargin(0.05);
+  
+  // The frame and legend of the previous overlay are removed from
+  // the canvas and deleted before being recreated
+  if(SpectrumOverlayFrame_H){
+    TheCanvas->GetListOfPrimitives()->Remove(SpectrumOverlayFrame_H);
+    delete SpectrumOverlayFrame_H;
+  }
+  
+  if(SpectrumOverlay_L){
+    TheCanvas->GetListOfPrimitives()->Remove(SpectrumOverlay_L);
+    delete SpectrumOverlay_L;
+  }
+  
+  // An empty clone of the first spectrum serves as the frame that
+  // carries the plot title and axes such that the titles of the
+  // spectra themselves (used in the legend) are preserved
+  SpectrumOverlayFrame_H = (TH1F *)Spectra[0]->Clone("SpectrumOverlayFrame_H");
+  SpectrumOverlayFrame_H->SetDirectory(0);
+  TH1F *Frame_H = SpectrumOverlayFrame_H;
+  Frame_H->Reset();
+  Frame_H->SetStats(false);
+  Frame_H->SetTitle(Title.c_str());
+  Frame_H->GetXaxis()->SetRangeUser(XMin, XMax);
+  Frame_H->SetMinimum(YMin);
+  Frame_H->SetMaximum(YMax);
+  
+  Frame_H->GetXaxis()->SetTitle(XTitle.c_str());
+  Frame_H->GetXaxis()->SetTitleSize(ADAQSettings->XSize);
+  Frame_H->GetXaxis()->SetLabelSize(ADAQSettings->XSize);
+  Frame_H->GetXaxis()->SetTitleOffset(ADAQSettings->XOffset);
+  Frame_H->GetXaxis()->CenterTitle();
+  Frame_H->GetXaxis()->SetNdivisions(ADAQSettings->XDivs, true);
+  
+  Frame_H->GetYaxis()->SetTitle("Counts");
+  Frame_H->GetYaxis()->SetTitleSize(ADAQSettings->YSize);
+  Frame_H->GetYaxis()->SetLabelSize(ADAQSettings->YSize);
+  Frame_H->GetYaxis()->SetTitleOffset(ADAQSettings->YOffset);
+  Frame_H->GetYaxis()->CenterTitle();
+  Frame_H->GetYaxis()->SetNdivisions(ADAQSettings->YDivs, true);
+  
+  Frame_H->Draw("HIST");
+  
+  SpectrumOverlay_L = new TLegend(0.65, 0.6, 0.93, 0.9);
+  
+  for(size_t s=0; s<Spectra.size(); s++){
+
+    // Cycle through the basic ROOT colors, replacing yellow (5),
+    // which is nearly invisible on the white canvas, with orange
+    Int_t Color = (s % 9) + 1;
+    if(Color == 5)
+      Color = kOrange+7;
+    
+    Spectra[s]->SetStats(false);
+    Spectra[s]->SetLineColor(Color);
+    Spectra[s]->SetLineWidth(ADAQSettings->SpectrumLineWidth);
+    Spectra[s]->SetFillStyle(4000);
+    Spectra[s]->Draw("HIST SAME");
+    
+    SpectrumOverlay_L->AddEntry(Spectra[s], Spectra[s]->GetTitle(), "L");
+  }
+  
+  SpectrumOverlay_L->Draw();
+  
+  TheCanvas->Update();
+  
+  CanvasContentType = zSpectrum;
+}
+
+// Method to plot the spectrum that has been converted from electron
+// equivalent energy into the energy of an incident particle. The
+// axis titles are set during the conversion
+void AAGraphics::PlotConvertedSpectrum()
+{
+  if(!ComputationMgr->GetConvertedSpectrumExists())
+    return;
+
+  TH1F *Converted_H = ComputationMgr->GetConvertedSpectrum();
+  
+  gPad->SetGrid(ADAQSettings->CanvasGrid, ADAQSettings->CanvasGrid);
+  gPad->SetLogx(ADAQSettings->CanvasXAxisLog);
+  gPad->SetLogy(ADAQSettings->CanvasYAxisLog);
+
+  TheCanvas->SetLeftMargin(0.13);
+  TheCanvas->SetBottomMargin(0.12);
+  TheCanvas->SetRightMargin(0.05);
+
+  Converted_H->SetStats(ADAQSettings->HistogramStats);
+  
+  Converted_H->GetXaxis()->SetTitleSize(ADAQSettings->XSize);
+  Converted_H->GetXaxis()->SetLabelSize(ADAQSettings->XSize);
+  Converted_H->GetXaxis()->SetTitleOffset(ADAQSettings->XOffset);
+  Converted_H->GetXaxis()->CenterTitle();
+  Converted_H->GetXaxis()->SetNdivisions(ADAQSettings->XDivs, true);
+
+  Converted_H->GetYaxis()->SetTitleSize(ADAQSettings->YSize);
+  Converted_H->GetYaxis()->SetLabelSize(ADAQSettings->YSize);
+  Converted_H->GetYaxis()->SetTitleOffset(ADAQSettings->YOffset);
+  Converted_H->GetYaxis()->CenterTitle();
+  Converted_H->GetYaxis()->SetNdivisions(ADAQSettings->YDivs, true);
+
+  Converted_H->SetLineColor(SpectrumLineColor);
+  Converted_H->SetLineWidth(ADAQSettings->SpectrumLineWidth);
+  Converted_H->SetFillStyle(4000);
+  Converted_H->Draw("HIST");
+  
+  TheCanvas->Update();
+  
+  CanvasContentType = zSpectrum;
+}
+
 void AAGraphics::PlotSpectrumDerivative()
 {
-  TGraph *SpectrumDerivative_G = ComputationMgr->CalculateSpectrumDerivative();
+  ComputationMgr->UpdateSpectrumProduct(zSpectrumDerivativeProduct);
+  TGraph *SpectrumDerivative_G = ComputationMgr->GetSpectrumDerivative();
   
   string Title, XTitle, YTitle;
   
@@ -1207,9 +1542,10 @@ void AAGraphics::PlotPSDHistogramSlice(int XPixel, int YPixel)
   // Get the list of current canvas objects
   TCanvas *PSDSlice_C = (TCanvas *)gROOT->GetListOfCanvases()->FindObject(SliceCanvasName.c_str());
 
-  // If the canvas then delete the contents to prevent memory leaks
+  // If the canvas exists then clear the previous slice and fits; the
+  // slice histogram and fit functions are owned elsewhere and reused
   if(PSDSlice_C)
-    delete PSDSlice_C->GetPrimitive(SliceHistogramName.c_str());
+    PSDSlice_C->Clear();
   
   // ... otherwise, create a new canvas
   else{
@@ -1289,60 +1625,154 @@ void AAGraphics::PlotPSDHistogramSlice(int XPixel, int YPixel)
   PSDHistogramSlice_H->SetLineWidth(2);
   PSDHistogramSlice_H->Draw("");
   
-  // Because the PSD histogram slice only exists temporarily within
-  // this method, we need to perform the fitting here (rather than in
-  // the AAComputation class) and store the results within the
-  // AAGraphics class for later access
+  // Update the standalone canvas
+  PSDSlice_C->Update();
+
+  gPad->GetCanvas()->FeedbackMode(kFALSE);
   
-  if(ADAQSettings->PSDCalculateFOM){
+  // Reset the main embedded canvas to active
+  TheCanvas->cd();
+}
 
-    // Fit the lower gaussian (typically gamma / electron group)
 
-    TF1 *LowerFOMFit = new TF1("LowerFOMFit",
-			       "gaus",
-			       ADAQSettings->PSDLowerFOMFitMin,
-			       ADAQSettings->PSDLowerFOMFitMax);
-    LowerFOMFit->SetLineColor(kGreen+2);
-    LowerFOMFit->SetLineWidth(2);
+// Method to draw the lower and upper Gaussians of the figure-of-merit
+// fit of the PSD histogram slice once the fit has been collected from
+// the fitting thread. The Gaussians are drawn over the present slice
+// in the standalone slice canvas
+void AAGraphics::PlotPSDHistogramSliceFits()
+{
+  TCanvas *PSDSlice_C = (TCanvas *)gROOT->GetListOfCanvases()->FindObject("PSDSlice_C");
+  if(!PSDSlice_C)
+    return;
+  
+  TList *Primitives = PSDSlice_C->GetListOfPrimitives();
+  Primitives->Remove(PSDLowerFOMFit_F);
+  Primitives->Remove(PSDUpperFOMFit_F);
 
-    PSDHistogramSlice_H->Fit("LowerFOMFit", "RNQ");
+  if(ComputationMgr->GetPSDSliceFitValid()){
+    
+    // Fit the lower gaussian (typically gamma / electron group)
 
-    LowerFOMFit->Draw("SAME");
+    const SpectrumFitResultStruct &Lower = ComputationMgr->GetPSDSliceLowerFit();
+    
+    PSDLowerFOMFit_F->SetRange(Lower.WindowMin, Lower.WindowMax);
+    PSDLowerFOMFit_F->SetParameters(Lower.Const, Lower.Mean, Lower.Sigma);
+    PSDLowerFOMFit_F->SetLineColor(kGreen+2);
+    PSDLowerFOMFit_F->SetLineWidth(2);
     
     // Fit the upper gaussian (typically neutron / proton group)
     
-    TF1 *UpperFOMFit = new TF1("UpperFOMFit",
-			       "gaus",
-			       ADAQSettings->PSDUpperFOMFitMin,
-			       ADAQSettings->PSDUpperFOMFitMax);
-    UpperFOMFit->SetLineColor(kRed);
-    UpperFOMFit->SetLineWidth(2);
+    const SpectrumFitResultStruct &Upper = ComputationMgr->GetPSDSliceUpperFit();
+    
+    PSDUpperFOMFit_F->SetRange(Upper.WindowMin, Upper.WindowMax);
+    PSDUpperFOMFit_F->SetParameters(Upper.Const, Upper.Mean, Upper.Sigma);
+    PSDUpperFOMFit_F->SetLineColor(kRed);
+    PSDUpperFOMFit_F->SetLineWidth(2);
+
+    PSDSlice_C->cd();
+    PSDLowerFOMFit_F->Draw("SAME");
+    PSDUpperFOMFit_F->Draw("SAME");
+  }
+  
+  PSDSlice_C->Modified();
+  PSDSlice_C->Update();
+  
+  // Reset the main embedded canvas to active
+  TheCanvas->cd();
+}
 
-    PSDHistogramSlice_H->Fit("UpperFOMFit", "RNQ");
 
-    UpperFOMFit->Draw("SAME");
+void AAGraphics::PlotPSDFOMScan()
+{
+  if(!ComputationMgr->GetPSDFOMScanExists())
+    return;
 
-    // Calculate the PSD figure-of-merit (FOM)
+  TGraphErrors *PSDFOMScan_GE = ComputationMgr->GetPSDFOMScan();
 
-    Double_t LowerMean = LowerFOMFit->GetParameter(1);
-    Double_t LowerFWHM = LowerFOMFit->GetParameter(2) * 2.35;
-    
-    Double_t UpperMean = UpperFOMFit->GetParameter(1);
-    Double_t UpperFWHM = UpperFOMFit->GetParameter(2) * 2.35;
+  // The FOM scan is drawn in a standalone canvas such that the PSD
+  // histogram remains displayed in the embedded canvas
+  
+  string ScanCanvasName = "PSDFOMScan_C";
+  
+  TCanvas *PSDFOMScan_C = (TCanvas *)gROOT->GetListOfCanvases()->FindObject(ScanCanvasName.c_str());
 
-    PSDFigureOfMerit = (UpperMean - LowerMean) / (UpperFWHM + LowerFWHM);
+  if(!PSDFOMScan_C){
+    PSDFOMScan_C = new TCanvas(ScanCanvasName.c_str(), "PSD Figure of Merit Scan", 700, 500, 600, 400);
+    PSDFOMScan_C->SetGrid(ADAQSettings->CanvasGrid, ADAQSettings->CanvasGrid);
+    PSDFOMScan_C->SetLeftMargin(0.13);
+    PSDFOMScan_C->SetBottomMargin(0.13);
   }
+  PSDFOMScan_C->cd();
+
+  string XTitle;
+  if(ADAQSettings->PSDXAxisEnergy)
+    XTitle = "PSD total integral [" + ADAQSettings->CalibrationUnit + "ee]";
+  else
+    XTitle = "PSD total integral [ADC]";
   
-  // Update the standalone canvas
-  PSDSlice_C->Update();
+  PSDFOMScan_GE->SetTitle("PSD figure of merit");
+  
+  PSDFOMScan_GE->GetXaxis()->SetTitle(XTitle.c_str());
+  PSDFOMScan_GE->GetXaxis()->SetTitleSize(0.06);
+  PSDFOMScan_GE->GetXaxis()->SetTitleOffset(1.1);
+  PSDFOMScan_GE->GetXaxis()->SetLabelSize(0.06);
+  PSDFOMScan_GE->GetXaxis()->SetNdivisions(505);
+  PSDFOMScan_GE->GetXaxis()->CenterTitle();
 
-  gPad->GetCanvas()->FeedbackMode(kFALSE);
+  PSDFOMScan_GE->GetYaxis()->SetTitle("Figure of merit");
+  PSDFOMScan_GE->GetYaxis()->SetTitleSize(0.06);
+  PSDFOMScan_GE->GetYaxis()->SetTitleOffset(1.1);
+  PSDFOMScan_GE->GetYaxis()->SetLabelSize(0.06);
+  PSDFOMScan_GE->GetYaxis()->SetNdivisions(505);
+  PSDFOMScan_GE->GetYaxis()->CenterTitle();
+
+  PSDFOMScan_GE->SetMarkerStyle(20);
+  PSDFOMScan_GE->SetMarkerSize(1.0);
+  PSDFOMScan_GE->SetMarkerColor(kBlue);
+  PSDFOMScan_GE->SetLineColor(kBlue);
+  PSDFOMScan_GE->SetLineWidth(2);
+  PSDFOMScan_GE->Draw("AP");
+
+  PSDFOMScan_C->Update();
   
   // Reset the main embedded canvas to active
   TheCanvas->cd();
 }
 
 
+// Method to draw the partially accumulated spectrum or PSD histogram
+// while waveforms are processed in the background thread. Only the
+// basic styling is applied since the snapshot is replaced by the
+// complete spectrum or PSD histogram once processing has finished
+void AAGraphics::PlotProcessingSnapshot()
+{
+  TH1 *Snapshot_H = ComputationMgr->GetProcessingSnapshot();
+  if(!Snapshot_H)
+    return;
+
+  TheCanvas->cd();
+  
+  gPad->SetGrid(ADAQSettings->CanvasGrid, ADAQSettings->CanvasGrid);
+  gPad->SetLogx(ADAQSettings->CanvasXAxisLog);
+  gPad->SetLogy(ADAQSettings->CanvasYAxisLog);
+
+  if(Snapshot_H->GetDimension() == 2){
+    gPad->SetLogz(ADAQSettings->CanvasZAxisLog);
+    Snapshot_H->Draw(ADAQSettings->PSDPlotType.c_str());
+  }
+  else{
+    Snapshot_H->SetLineColor(SpectrumLineColor);
+    Snapshot_H->SetLineWidth(ADAQSettings->SpectrumLineWidth);
+    Snapshot_H->Draw("HIST");
+  }
+  
+  TheCanvas->Update();
+
+  // The snapshot is not a valid target for the canvas sliders
+  CanvasContentType = zEmpty;
+}
+
+
 void AAGraphics::SetWaveformColor()
 {
   ColorToSet = zWaveformColor;
@@ -0,0 +1,165 @@
+/////////////////////////////////////////////////////////////////////////////////
+//                                                                             //
+//                            Copyright (C) 2012-2023                          //
+//                  Zachary Seth Hartwig : All rights reserved                 //
+//                                                                             //
+//      The ADAQAnalysis source code is licensed under the GNU GPL v3.0.       //
+//      You have the right to modify and/or redistribute this source code      //
+//      under the terms specified in the license, which is found online        //
+//      at http://www.gnu.org/licenses or at $ADAQANALYSIS/License.txt.        //
+//                                                                             //
+/////////////////////////////////////////////////////////////////////////////////
+
+/////////////////////////////////////////////////////////////////////////////////
+//
+// name: AAHistogramAccumulator.cc
+// date: 18 Oct 26
+// auth: Zach Hartwig
+// mail: hartwig@psfc.mit.edu
+//
+// desc: The AAHistogramAccumulator class accumulates counts into a
+//       1D or 2D histogram with 64-bit integer bins that may be
+//       filled concurrently from multiple threads.
+//
+/////////////////////////////////////////////////////////////////////////////////
+
+// ROOT
+#include <TAxis.h>
+
+// C++
+#include <cmath>
+
+// ADAQAnalysis
+#include "AAHistogramAccumulator.hh"
+
+
+AAHistogramAccumulator::AAHistogramAccumulator()
+  : Dimension(0), NumBinsX(0), NumBinsY(0), NumCells(0),
+    MinX(0.), MaxX(0.), MinY(0.), MaxY(0.),
+    Bins(NULL), Entries(0)
+{;}
+
+
+AAHistogramAccumulator::~AAHistogramAccumulator()
+{
+  delete [] Bins;
+}
+
+
+void AAHistogramAccumulator::Initialize(Int_t NX, Double_t XMin, Double_t XMax)
+{
+  Dimension = 1;
+  NumBinsX = NX;
+  MinX = XMin;
+  MaxX = XMax;
+  NumBinsY = 0;
+  MinY = MaxY = 0.;
+
+  Allocate();
+}
+
+
+void AAHistogramAccumulator::Initialize(Int_t NX, Double_t XMin, Double_t XMax,
+					Int_t NY, Double_t YMin, Double_t YMax)
+{
+  Dimension = 2;
+  NumBinsX = NX;
+  MinX = XMin;
+  MaxX = XMax;
+  NumBinsY = NY;
+  MinY = YMin;
+  MaxY = YMax;
+
+  Allocate();
+}
+
+
+// Method to take the binning and (rounded) bin contents from an
+// existing histogram, such as one read back from a ROOT file
+void AAHistogramAccumulator::Initialize(const TH1 *Histogram)
+{
+  const TAxis *XAxis = Histogram->GetXaxis();
+  const TAxis *YAxis = Histogram->GetYaxis();
+
+  if(Histogram->GetDimension() == 2)
+    Initialize(XAxis->GetNbins(), XAxis->GetXmin(), XAxis->GetXmax(),
+	       YAxis->GetNbins(), YAxis->GetXmin(), YAxis->GetXmax());
+  else
+    Initialize(XAxis->GetNbins(), XAxis->GetXmin(), XAxis->GetXmax());
+
+  for(Int_t bin=0; bin<NumCells; bin++)
+    Bins[bin].store(llround(Histogram->GetBinContent(bin)), memory_order_relaxed);
+
+  Entries.store(llround(Histogram->GetEntries()), memory_order_relaxed);
+}
+
+
+void AAHistogramAccumulator::Allocate()
+{
+  NumCells = (Dimension == 2) ? (NumBinsX+2) * (NumBinsY+2) : NumBinsX+2;
+
+  delete [] Bins;
+  Bins = new atomic<Long64_t>[NumCells];
+
+  Reset();
+}
+
+
+void AAHistogramAccumulator::Reset()
+{
+  for(Int_t bin=0; bin<NumCells; bin++)
+    Bins[bin].store(0, memory_order_relaxed);
+
+  Entries.store(0, memory_order_relaxed);
+}
+
+
+void AAHistogramAccumulator::Add(const AAHistogramAccumulator &Other)
+{
+  for(Int_t bin=0; bin<NumCells and bin<Other.NumCells; bin++)
+    AddBinContent(bin, Other.GetBinContent(bin));
+
+  AddEntries(Other.GetEntries());
+}
+
+
+void AAHistogramAccumulator::CopyTo(Double_t *Array) const
+{
+  for(Int_t bin=0; bin<NumCells; bin++)
+    Array[bin] = GetBinContent(bin);
+}
+
+
+TH1D *AAHistogramAccumulator::CreateTH1D(string Name, string Title) const
+{
+  TH1D *Histogram = new TH1D(Name.c_str(), Title.c_str(), NumBinsX, MinX, MaxX);
+  CopyToHistogram(Histogram);
+  return Histogram;
+}
+
+
+TH2D *AAHistogramAccumulator::CreateTH2D(string Name, string Title) const
+{
+  TH2D *Histogram = new TH2D(Name.c_str(), Title.c_str(),
+			     NumBinsX, MinX, MaxX,
+			     NumBinsY, MinY, MaxY);
+  CopyToHistogram(Histogram);
+  return Histogram;
+}
+
+
+// Method to set the bin contents of a histogram from the counts. The
+// global bin numbering of the TH1/TH2 classes matches that of the
+// accumulator. The statistics are recomputed from the bin contents
+// and the number of entries is set to the number of fills
+void AAHistogramAccumulator::CopyToHistogram(TH1 *Histogram) const
+{
+  if(Histogram->GetNcells() != NumCells)
+    return;
+
+  for(Int_t bin=0; bin<NumCells; bin++)
+    Histogram->SetBinContent(bin, GetBinContent(bin));
+
+  Histogram->ResetStats();
+  Histogram->SetEntries(GetEntries());
+}
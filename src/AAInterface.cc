@@ -36,11 +36,14 @@
 #include <TGButtonGroup.h>
 #include <TFile.h>
 #include <TGText.h>
+#include <TSystem.h>
 
 // C++
 #include <iostream>
+#include <iomanip>
 #include <sstream>
 #include <string>
+#include <chrono>
 using namespace std;
 
 // Boost
@@ -64,6 +67,13 @@ using namespace std;
 #include "AAVersion.hh"
 
 
+// The startup stages and the times [ms] since program start at which
+// they completed (see AAInterface::AddStartupTime())
+static const chrono::steady_clock::time_point StartupStart = chrono::steady_clock::now();
+static vector<string> StartupStages;
+static vector<Double_t> StartupTimes;
+
+
 AAInterface::AAInterface(string CmdLineArg)
   : TGMainFrame(gClient->GetRoot()),
     NumDataChannels(16), NumProcessors(boost::thread::hardware_concurrency()),
@@ -73,10 +83,15 @@ AAInterface::AAInterface(string CmdLineArg)
     DataDirectory(getenv("PWD")), PrintDirectory(getenv("HOME")),
     DesplicedDirectory(getenv("HOME")), HistogramDirectory(getenv("HOME")),
     ADAQFileLoaded(false), ASIMFileLoaded(false), EnableInterface(false),
+    SnapshotWaveforms(0), SnapshotTime(0),
+    StartupReported(false),
     ColorMgr(new TColor), RndmMgr(new TRandom3)
 {
   SetCleanup(kDeepCleanup);
 
+  for(int tab=0; tab<zNumOptionsTabs; tab++)
+    OptionsTabFilled[tab] = false;
+
   // Allow env. variable to control small version of GUI
   if(getenv("ADAQANALYSIS_SMALL")!=NULL){
     CanvasX = 500;
@@ -97,6 +112,8 @@ AAInterface::AAInterface(string CmdLineArg)
   ProcessingSlots = new AAProcessingSlots(this);
   NontabSlots = new AANontabSlots(this);
 
+  AddStartupTime("Slot handlers");
+
   // Set the fore- and background colors
   ThemeForegroundColor = ColorMgr->Number2Pixel(18);
   ThemeBackgroundColor = ColorMgr->Number2Pixel(22);
@@ -169,6 +186,8 @@ AAInterface::AAInterface(string CmdLineArg)
     }
     else
       CreateMessageBox("Could not find an acceptable file to open. Please try again.","Stop");
+
+    AddStartupTime("Command line file");
   }
 
   // Initial the AASettings data member
@@ -181,11 +200,17 @@ AAInterface::AAInterface(string CmdLineArg)
 
   // Ensure the interface window closes properly when the "x" is clicked
   Connect("CloseWindow()", "AANontabSlots", NontabSlots, "HandleTerminate()");
+
+  // The timer fires once the event loop has started, i.e. after the
+  // window has been exposed and painted for the first time
+  TTimer::SingleShot(0, "AANontabSlots", NontabSlots, "HandleStartupTimer()");
 }
 
 
 AAInterface::~AAInterface()
 {
+  delete ProcessingTimer;
+  delete PSDSliceFitTimer;
   delete ADAQSettings;
   delete NontabSlots;
   delete ProcessingSlots;
@@ -216,6 +241,7 @@ void AAInterface::CreateTheMainFrames()
 
   MenuFile->AddEntry("Load spectrum ...", MenuFileLoadSpectrum_ID);
   MenuFile->AddEntry("Load PSD histogram ...", MenuFileLoadPSDHistogram_ID);
+  MenuFile->AddEntry("Batch fit spectra ...", MenuFileBatchFitSpectra_ID);
   
   MenuFile->AddSeparator();
 
@@ -225,11 +251,15 @@ void AAInterface::CreateTheMainFrames()
   SaveSpectrumSubMenu->AddEntry("&raw", MenuFileSaveSpectrum_ID);
   SaveSpectrumSubMenu->AddEntry("&background", MenuFileSaveSpectrumBackground_ID);
   SaveSpectrumSubMenu->AddEntry("&derivative", MenuFileSaveSpectrumDerivative_ID);
+  SaveSpectrumSubMenu->AddEntry("&ASIM event trees", MenuFileSaveASIMSpectra_ID);
+  SaveSpectrumSubMenu->AddEntry("Settings s&weep", MenuFileSaveSettingsSweep_ID);
+  SaveSpectrumSubMenu->AddEntry("&converted", MenuFileSaveConvertedSpectrum_ID);
   MenuFile->AddPopup("Save &spectrum ...", SaveSpectrumSubMenu);
   
   TGPopupMenu *SavePSDSubMenu = new TGPopupMenu(gClient->GetRoot());
   SavePSDSubMenu->AddEntry("histo&gram", MenuFileSavePSDHistogram_ID);
   SavePSDSubMenu->AddEntry("sli&ce", MenuFileSavePSDHistogramSlice_ID);
+  SavePSDSubMenu->AddEntry("&FOM scan", MenuFileSavePSDFOMScan_ID);
   MenuFile->AddPopup("Save &PSD ...",SavePSDSubMenu);
 
   TGPopupMenu *SaveCalibrationSubMenu = new TGPopupMenu(gClient->GetRoot());
@@ -318,14 +348,17 @@ void AAInterface::CreateTheMainFrames()
   ProcessingOptions_CF->Resize(TabFrameWidth, TabFrameLength);
   ProcessingOptions_CF->ChangeOptions(ProcessingOptions_CF->GetOptions() | kFixedSize);
 
-  FillWaveformFrame();
-  FillSpectrumFrame();
-  FillAnalysisFrame();
-  FillPSDFrame();
-  FillGraphicsFrame();
-  FillProcessingFrame();
+  OptionsTabs_T->Connect("Selected(Int_t)", "AANontabSlots", NontabSlots, "HandleOptionsTabs(int)");
+
+  AddStartupTime("Main frames");
+
+  // Fill only the initially displayed tab (see FillOptionsTab())
+  FillOptionsTab(zWaveformTab);
+  
   FillCanvasFrame();
 
+  AddStartupTime("Canvas frame");
+
   //////////////////////////////////////
   // Finalize options and map windows //
   //////////////////////////////////////
@@ -344,6 +377,8 @@ void AAInterface::CreateTheMainFrames()
   MapSubwindows();
   Resize(TotalX, TotalY);
   MapWindow();
+
+  AddStartupTime("Window mapped");
 }
 
 
@@ -693,6 +728,12 @@ void AAInterface::FillSpectrumFrame()
   SpectrumNumBins_NEL->GetEntry()->SetNumAttr(TGNumberFormat::kNEANonNegative);
   SpectrumNumBins_NEL->GetEntry()->SetNumber(100);
 
+  // Process all waveforms in a random order of file clusters such
+  // that the spectrum may be previewed at any point during processing
+  SpectrumFrame_VF->AddFrame(SpectrumPreview_CB = new TGCheckButton(SpectrumFrame_VF, "Preview (all waveforms, random cluster order)", -1),
+			     new TGLayoutHints(kLHintsNormal, LOffset,0,0,5));
+  SpectrumPreview_CB->SetState(kButtonUp);
+
   SpectrumFrame_VF->AddFrame(new TGLabel(SpectrumFrame_VF, "Limits"),
 			     new TGLayoutHints(kLHintsNormal, LOffset,0,0,0));
   
@@ -828,6 +869,23 @@ void AAInterface::FillSpectrumFrame()
   ASIMEventTree_CB->Resize(120,20);
   ASIMEventTree_CB->SetEnabled(false);
   ASIMEventTree_CB->Connect("Selected(int,int)", "AASpectrumSlots", SpectrumSlots, "HandleComboBoxes(int,int)");
+
+  // Create spectra for the selected event trees (or all event trees
+  // if none are selected) in a single pass
+  ASIMEventTree_VF->AddFrame(new TGLabel(ASIMEventTree_VF, "Trees (none = all)"),
+			     new TGLayoutHints(kLHintsNormal, 0,0,10,0));
+  
+  ASIMEventTree_VF->AddFrame(ASIMEventTrees_LB = new TGListBox(ASIMEventTree_VF, ASIMEventTrees_LB_ID),
+			     new TGLayoutHints(kLHintsNormal, 0,0,0,0));
+  ASIMEventTrees_LB->SetMultipleSelections(true);
+  ASIMEventTrees_LB->Resize(120,60);
+  
+  ASIMEventTree_VF->AddFrame(CreateASIMSpectra_TB = new TGTextButton(ASIMEventTree_VF, "Create spectra", CreateASIMSpectra_TB_ID),
+			     new TGLayoutHints(kLHintsNormal, 0,0,5,0));
+  CreateASIMSpectra_TB->Connect("Clicked()", "AASpectrumSlots", SpectrumSlots, "HandleTextButtons()");
+  CreateASIMSpectra_TB->Resize(120,25);
+  CreateASIMSpectra_TB->ChangeOptions(CreateASIMSpectra_TB->GetOptions() | kFixedSize);
+  CreateASIMSpectra_TB->SetState(kButtonDisabled);
   
 
   //////////////////////////////
@@ -993,6 +1051,126 @@ void AAInterface::FillSpectrumFrame()
   TGHorizontalFrame *SpectrumCalibration_HF3 = new TGHorizontalFrame(SpectrumCalibration_GF);
   SpectrumCalibration_GF->AddFrame(SpectrumCalibration_HF3);
 
+  ////////////////////////////
+  // Gain drift correction
+
+  TGGroupFrame *GainDrift_GF = new TGGroupFrame(SpectrumFrame_VF, "Gain drift correction", kVerticalFrame);
+  SpectrumFrame_VF->AddFrame(GainDrift_GF, new TGLayoutHints(kLHintsLeft, 15,5,10,0));
+
+  GainDrift_GF->AddFrame(GainDriftSlices_NEL = new ADAQNumberEntryWithLabel(GainDrift_GF, "Number of slices", -1),
+			 new TGLayoutHints(kLHintsLeft,0,0,5,0));
+  GainDriftSlices_NEL->GetEntry()->SetNumStyle(TGNumberFormat::kNESInteger);
+  GainDriftSlices_NEL->GetEntry()->SetNumAttr(TGNumberFormat::kNEAPositive);
+  GainDriftSlices_NEL->GetEntry()->SetNumber(20);
+  GainDriftSlices_NEL->GetEntry()->Resize(80,20);
+  
+  // Each reference is a peak or edge within a window of uncalibrated
+  // pulse units [ADC] that is tracked across the slices
+
+  for(Int_t r=0; r<NumGainDriftRefs; r++){
+    stringstream ss;
+    ss << "Ref. " << (r+1);
+
+    TGHorizontalFrame *GainDriftRef_HF = new TGHorizontalFrame(GainDrift_GF);
+    GainDrift_GF->AddFrame(GainDriftRef_HF, new TGLayoutHints(kLHintsNormal, 0,0,0,0));
+
+    GainDriftRef_HF->AddFrame(GainDriftRefType_CBL[r] = new ADAQComboBoxWithLabel(GainDriftRef_HF, ss.str(), -1),
+			      new TGLayoutHints(kLHintsLeft,0,5,5,0));
+    GainDriftRefType_CBL[r]->GetComboBox()->Resize(60,20);
+    GainDriftRefType_CBL[r]->GetComboBox()->AddEntry("None",0);
+    GainDriftRefType_CBL[r]->GetComboBox()->AddEntry("Peak",1);
+    GainDriftRefType_CBL[r]->GetComboBox()->AddEntry("Edge",2);
+    GainDriftRefType_CBL[r]->GetComboBox()->Select((r == 0) ? 1 : 0);
+
+    GainDriftRef_HF->AddFrame(GainDriftRefMin_NEL[r] = new ADAQNumberEntryWithLabel(GainDriftRef_HF, "", -1),
+			      new TGLayoutHints(kLHintsLeft,0,5,5,0));
+    GainDriftRefMin_NEL[r]->GetEntry()->SetNumStyle(TGNumberFormat::kNESReal);
+    GainDriftRefMin_NEL[r]->GetEntry()->SetNumAttr(TGNumberFormat::kNEANonNegative);
+    GainDriftRefMin_NEL[r]->GetEntry()->SetNumber(0.);
+    GainDriftRefMin_NEL[r]->GetEntry()->Resize(60,20);
+
+    GainDriftRef_HF->AddFrame(GainDriftRefMax_NEL[r] = new ADAQNumberEntryWithLabel(GainDriftRef_HF, "ADC", -1),
+			      new TGLayoutHints(kLHintsLeft,0,0,5,0));
+    GainDriftRefMax_NEL[r]->GetEntry()->SetNumStyle(TGNumberFormat::kNESReal);
+    GainDriftRefMax_NEL[r]->GetEntry()->SetNumAttr(TGNumberFormat::kNEANonNegative);
+    GainDriftRefMax_NEL[r]->GetEntry()->SetNumber(0.);
+    GainDriftRefMax_NEL[r]->GetEntry()->Resize(60,20);
+  }
+  
+  GainDrift_GF->AddFrame(GainDriftApply_CB = new TGCheckButton(GainDrift_GF, "Apply to spectrum", -1),
+			 new TGLayoutHints(kLHintsLeft,0,0,5,0));
+  GainDriftApply_CB->SetState(kButtonDisabled);
+
+  TGHorizontalFrame *GainDrift_HF = new TGHorizontalFrame(GainDrift_GF);
+  GainDrift_GF->AddFrame(GainDrift_HF);
+
+  GainDrift_HF->AddFrame(GainDriftCompute_TB = new TGTextButton(GainDrift_HF, "Compute", GainDriftCompute_TB_ID),
+			 new TGLayoutHints(kLHintsNormal, 5,5,5,5));
+  GainDriftCompute_TB->Connect("Clicked()", "AASpectrumSlots", SpectrumSlots, "HandleTextButtons()");
+  GainDriftCompute_TB->Resize(100,25);
+  GainDriftCompute_TB->ChangeOptions(GainDriftCompute_TB->GetOptions() | kFixedSize);
+  GainDriftCompute_TB->SetState(kButtonDisabled);
+
+  GainDrift_HF->AddFrame(GainDriftSave_TB = new TGTextButton(GainDrift_HF, "Save table", GainDriftSave_TB_ID),
+			 new TGLayoutHints(kLHintsNormal, 0,0,5,5));
+  GainDriftSave_TB->Connect("Clicked()", "AASpectrumSlots", SpectrumSlots, "HandleTextButtons()");
+  GainDriftSave_TB->Resize(100,25);
+  GainDriftSave_TB->ChangeOptions(GainDriftSave_TB->GetOptions() | kFixedSize);
+  GainDriftSave_TB->SetState(kButtonDisabled);
+
+  ////////////////////////////
+  // Settings sweep
+
+  // A single waveform extraction parameter is stepped between the
+  // minimum and maximum values with all other parameters held at
+  // their present settings; one spectrum is created per step
+
+  TGGroupFrame *SettingsSweep_GF = new TGGroupFrame(SpectrumFrame_VF, "Settings sweep", kVerticalFrame);
+  SpectrumFrame_VF->AddFrame(SettingsSweep_GF, new TGLayoutHints(kLHintsLeft, 15,5,10,0));
+
+  SettingsSweep_GF->AddFrame(SettingsSweepParameter_CBL = new ADAQComboBoxWithLabel(SettingsSweep_GF, "Parameter", -1),
+			     new TGLayoutHints(kLHintsLeft,0,0,5,0));
+  SettingsSweepParameter_CBL->GetComboBox()->Resize(120,20);
+  SettingsSweepParameter_CBL->GetComboBox()->AddEntry("Floor",0);
+  SettingsSweepParameter_CBL->GetComboBox()->AddEntry("Sigma",1);
+  SettingsSweepParameter_CBL->GetComboBox()->AddEntry("Resolution",2);
+  SettingsSweepParameter_CBL->GetComboBox()->AddEntry("Baseline min.",3);
+  SettingsSweepParameter_CBL->GetComboBox()->AddEntry("Baseline max.",4);
+  SettingsSweepParameter_CBL->GetComboBox()->AddEntry("Analysis min.",5);
+  SettingsSweepParameter_CBL->GetComboBox()->AddEntry("Analysis max.",6);
+  SettingsSweepParameter_CBL->GetComboBox()->Select(0);
+
+  TGHorizontalFrame *SettingsSweep_HF = new TGHorizontalFrame(SettingsSweep_GF);
+  SettingsSweep_GF->AddFrame(SettingsSweep_HF, new TGLayoutHints(kLHintsNormal, 0,0,0,0));
+
+  SettingsSweep_HF->AddFrame(SettingsSweepMin_NEL = new ADAQNumberEntryWithLabel(SettingsSweep_HF, "Min", -1),
+			     new TGLayoutHints(kLHintsLeft,0,5,5,0));
+  SettingsSweepMin_NEL->GetEntry()->SetNumStyle(TGNumberFormat::kNESReal);
+  SettingsSweepMin_NEL->GetEntry()->SetNumAttr(TGNumberFormat::kNEANonNegative);
+  SettingsSweepMin_NEL->GetEntry()->SetNumber(10);
+  SettingsSweepMin_NEL->GetEntry()->Resize(55,20);
+
+  SettingsSweep_HF->AddFrame(SettingsSweepMax_NEL = new ADAQNumberEntryWithLabel(SettingsSweep_HF, "Max", -1),
+			     new TGLayoutHints(kLHintsLeft,0,5,5,0));
+  SettingsSweepMax_NEL->GetEntry()->SetNumStyle(TGNumberFormat::kNESReal);
+  SettingsSweepMax_NEL->GetEntry()->SetNumAttr(TGNumberFormat::kNEANonNegative);
+  SettingsSweepMax_NEL->GetEntry()->SetNumber(100);
+  SettingsSweepMax_NEL->GetEntry()->Resize(55,20);
+
+  SettingsSweep_HF->AddFrame(SettingsSweepSteps_NEL = new ADAQNumberEntryWithLabel(SettingsSweep_HF, "Steps", -1),
+			     new TGLayoutHints(kLHintsLeft,0,0,5,0));
+  SettingsSweepSteps_NEL->GetEntry()->SetNumStyle(TGNumberFormat::kNESInteger);
+  SettingsSweepSteps_NEL->GetEntry()->SetNumAttr(TGNumberFormat::kNEAPositive);
+  SettingsSweepSteps_NEL->GetEntry()->SetNumber(5);
+  SettingsSweepSteps_NEL->GetEntry()->Resize(40,20);
+
+  SettingsSweep_GF->AddFrame(SettingsSweep_TB = new TGTextButton(SettingsSweep_GF, "Run sweep", SettingsSweep_TB_ID),
+			     new TGLayoutHints(kLHintsNormal, 5,5,5,5));
+  SettingsSweep_TB->Connect("Clicked()", "AASpectrumSlots", SpectrumSlots, "HandleTextButtons()");
+  SettingsSweep_TB->Resize(100,25);
+  SettingsSweep_TB->ChangeOptions(SettingsSweep_TB->GetOptions() | kFixedSize);
+  SettingsSweep_TB->SetState(kButtonDisabled);
+
   /////////////////////////
   // Create spectrum button
   
@@ -1380,6 +1558,26 @@ void AAInterface::FillAnalysisFrame()
   EACarbonEnergy_NEL->GetEntry()->Resize(70,20);
   EACarbonEnergy_NEL->GetEntry()->Connect("ValueSet(long)", "AAAnalysisSlots", AnalysisSlots, "HandleNumberEntries()");
   EACarbonEnergy_NEL->GetEntry()->SetState(false);
+
+  // Conversion of the entire spectrum into particle energy
+  TGHorizontalFrame *EA_HF1 = new TGHorizontalFrame(EA_GF);
+  EA_GF->AddFrame(EA_HF1, new TGLayoutHints(kLHintsNormal, 5,5,5,5));
+
+  EA_HF1->AddFrame(EAConvertType_CBL = new ADAQComboBoxWithLabel(EA_HF1, "", -1),
+		   new TGLayoutHints(kLHintsNormal, 0,5,2,0));
+  EAConvertType_CBL->GetComboBox()->AddEntry("Proton", 0);
+  EAConvertType_CBL->GetComboBox()->AddEntry("Alpha", 1);
+  EAConvertType_CBL->GetComboBox()->AddEntry("Carbon", 2);
+  EAConvertType_CBL->GetComboBox()->Select(0);
+  EAConvertType_CBL->GetComboBox()->Resize(80,20);
+  EAConvertType_CBL->GetComboBox()->SetEnabled(false);
+
+  EA_HF1->AddFrame(EAConvertSpectrum_TB = new TGTextButton(EA_HF1, "Convert spectrum", EAConvertSpectrum_TB_ID),
+		   new TGLayoutHints(kLHintsNormal, 5,0,0,0));
+  EAConvertSpectrum_TB->Connect("Clicked()", "AAAnalysisSlots", AnalysisSlots, "HandleTextButtons()");
+  EAConvertSpectrum_TB->Resize(120,25);
+  EAConvertSpectrum_TB->ChangeOptions(EAConvertSpectrum_TB->GetOptions() | kFixedSize);
+  EAConvertSpectrum_TB->SetState(kButtonDisabled);
 }
 
 
@@ -1784,6 +1982,119 @@ void AAInterface::FillPSDFrame()
   PSDFigureOfMerit_NEFL->GetEntry()->Resize(75, 20);
   PSDFigureOfMerit_NEFL->GetEntry()->SetBackgroundColor(ColorMgr->Number2Pixel(19));
   PSDFigureOfMerit_NEFL->GetEntry()->SetState(false);
+
+  // Figure-of-merit scan across the PSD histogram X axis
+  
+  PSDSlicing_GF->AddFrame(new TGLabel(PSDSlicing_GF, "FOM scan bands (0 = every X bin)"),
+			  new TGLayoutHints(kLHintsLeft, 15,5,10,0));
+
+  PSDSlicing_GF->AddFrame(PSDFOMScanBands_NEL = new ADAQNumberEntryWithLabel(PSDSlicing_GF, "Number of bands", -1),
+			  new TGLayoutHints(kLHintsNormal, 15,0,5,0));
+  PSDFOMScanBands_NEL->GetEntry()->SetNumStyle(TGNumberFormat::kNESInteger);
+  PSDFOMScanBands_NEL->GetEntry()->SetNumAttr(TGNumberFormat::kNEANonNegative);
+  PSDFOMScanBands_NEL->GetEntry()->SetNumber(10);
+  
+  TGHorizontalFrame *PSDFOM_HF2 = new TGHorizontalFrame(PSDSlicing_GF);
+  PSDSlicing_GF->AddFrame(PSDFOM_HF2, new TGLayoutHints(kLHintsNormal, 15,0,0,0));
+
+  PSDFOM_HF2->AddFrame(PSDFOMScanMin_NEL = new ADAQNumberEntryWithLabel(PSDFOM_HF2, "Minimum  ", -1),
+		       new TGLayoutHints(kLHintsLeft, 0,0,5,0));
+  PSDFOMScanMin_NEL->GetEntry()->SetNumStyle(TGNumberFormat::kNESReal);
+  PSDFOMScanMin_NEL->GetEntry()->SetNumAttr(TGNumberFormat::kNEANonNegative);
+  PSDFOMScanMin_NEL->GetEntry()->SetNumber(0);
+  
+  PSDFOM_HF2->AddFrame(PSDFOMScanMax_NEL = new ADAQNumberEntryWithLabel(PSDFOM_HF2, "Maximum  ", -1),
+		       new TGLayoutHints(kLHintsLeft, 0,0,5,0));
+  PSDFOMScanMax_NEL->GetEntry()->SetNumStyle(TGNumberFormat::kNESReal);
+  PSDFOMScanMax_NEL->GetEntry()->SetNumAttr(TGNumberFormat::kNEANonNegative);
+  PSDFOMScanMax_NEL->GetEntry()->SetNumber(20000);
+
+  PSDSlicing_GF->AddFrame(PSDFOMScan_TB = new TGTextButton(PSDSlicing_GF, "Scan FOM", PSDFOMScan_TB_ID),
+			  new TGLayoutHints(kLHintsNormal, 15,5,10,5));
+  PSDFOMScan_TB->Connect("Clicked()", "AAPSDSlots", ProcessingSlots, "HandleTextButtons()");
+  PSDFOMScan_TB->Resize(150,30);
+  PSDFOMScan_TB->ChangeOptions(PSDFOMScan_TB->GetOptions() | kFixedSize);
+  PSDFOMScan_TB->SetState(kButtonDisabled);
+
+  ////////////////////////////
+  // PSD window optimization
+  
+  TGGroupFrame *PSDOptimize_GF = new TGGroupFrame(PSDFrame_VF, "PSD window optimization", kVerticalFrame);
+  PSDFrame_VF->AddFrame(PSDOptimize_GF, new TGLayoutHints(kLHintsCenterX | kLHintsExpandX, 5,5,10,5));
+
+  PSDOptimize_GF->AddFrame(new TGLabel(PSDOptimize_GF, "Total stop (min, max, steps)"),
+			   new TGLayoutHints(kLHintsLeft, 0,5,5,0));
+
+  TGHorizontalFrame *PSDOptimize_HF0 = new TGHorizontalFrame(PSDOptimize_GF);
+  PSDOptimize_GF->AddFrame(PSDOptimize_HF0, new TGLayoutHints(kLHintsNormal, 0,0,0,0));
+
+  PSDOptimize_HF0->AddFrame(PSDOptimizeTotalStopMin_NEL = new ADAQNumberEntryWithLabel(PSDOptimize_HF0, "", -1),
+			    new TGLayoutHints(kLHintsLeft, 0,5,5,0));
+  PSDOptimizeTotalStopMin_NEL->GetEntry()->SetNumStyle(TGNumberFormat::kNESInteger);
+  PSDOptimizeTotalStopMin_NEL->GetEntry()->SetNumber(50);
+  PSDOptimizeTotalStopMin_NEL->GetEntry()->Resize(50,20);
+
+  PSDOptimize_HF0->AddFrame(PSDOptimizeTotalStopMax_NEL = new ADAQNumberEntryWithLabel(PSDOptimize_HF0, "", -1),
+			    new TGLayoutHints(kLHintsLeft, 0,5,5,0));
+  PSDOptimizeTotalStopMax_NEL->GetEntry()->SetNumStyle(TGNumberFormat::kNESInteger);
+  PSDOptimizeTotalStopMax_NEL->GetEntry()->SetNumber(200);
+  PSDOptimizeTotalStopMax_NEL->GetEntry()->Resize(50,20);
+
+  PSDOptimize_HF0->AddFrame(PSDOptimizeTotalStopSteps_NEL = new ADAQNumberEntryWithLabel(PSDOptimize_HF0, "", -1),
+			    new TGLayoutHints(kLHintsLeft, 0,0,5,0));
+  PSDOptimizeTotalStopSteps_NEL->GetEntry()->SetNumStyle(TGNumberFormat::kNESInteger);
+  PSDOptimizeTotalStopSteps_NEL->GetEntry()->SetNumAttr(TGNumberFormat::kNEAPositive);
+  PSDOptimizeTotalStopSteps_NEL->GetEntry()->SetNumber(20);
+  PSDOptimizeTotalStopSteps_NEL->GetEntry()->Resize(50,20);
+
+  PSDOptimize_GF->AddFrame(new TGLabel(PSDOptimize_GF, "Tail start (min, max, steps)"),
+			   new TGLayoutHints(kLHintsLeft, 0,5,5,0));
+
+  TGHorizontalFrame *PSDOptimize_HF1 = new TGHorizontalFrame(PSDOptimize_GF);
+  PSDOptimize_GF->AddFrame(PSDOptimize_HF1, new TGLayoutHints(kLHintsNormal, 0,0,0,0));
+
+  PSDOptimize_HF1->AddFrame(PSDOptimizeTailStartMin_NEL = new ADAQNumberEntryWithLabel(PSDOptimize_HF1, "", -1),
+			    new TGLayoutHints(kLHintsLeft, 0,5,5,0));
+  PSDOptimizeTailStartMin_NEL->GetEntry()->SetNumStyle(TGNumberFormat::kNESInteger);
+  PSDOptimizeTailStartMin_NEL->GetEntry()->SetNumber(2);
+  PSDOptimizeTailStartMin_NEL->GetEntry()->Resize(50,20);
+
+  PSDOptimize_HF1->AddFrame(PSDOptimizeTailStartMax_NEL = new ADAQNumberEntryWithLabel(PSDOptimize_HF1, "", -1),
+			    new TGLayoutHints(kLHintsLeft, 0,5,5,0));
+  PSDOptimizeTailStartMax_NEL->GetEntry()->SetNumStyle(TGNumberFormat::kNESInteger);
+  PSDOptimizeTailStartMax_NEL->GetEntry()->SetNumber(40);
+  PSDOptimizeTailStartMax_NEL->GetEntry()->Resize(50,20);
+
+  PSDOptimize_HF1->AddFrame(PSDOptimizeTailStartSteps_NEL = new ADAQNumberEntryWithLabel(PSDOptimize_HF1, "", -1),
+			    new TGLayoutHints(kLHintsLeft, 0,0,5,0));
+  PSDOptimizeTailStartSteps_NEL->GetEntry()->SetNumStyle(TGNumberFormat::kNESInteger);
+  PSDOptimizeTailStartSteps_NEL->GetEntry()->SetNumAttr(TGNumberFormat::kNEAPositive);
+  PSDOptimizeTailStartSteps_NEL->GetEntry()->SetNumber(20);
+  PSDOptimizeTailStartSteps_NEL->GetEntry()->Resize(50,20);
+
+  PSDOptimize_GF->AddFrame(new TGLabel(PSDOptimize_GF, "FOM band of total integral"),
+			   new TGLayoutHints(kLHintsLeft, 0,5,5,0));
+
+  TGHorizontalFrame *PSDOptimize_HF2 = new TGHorizontalFrame(PSDOptimize_GF);
+  PSDOptimize_GF->AddFrame(PSDOptimize_HF2, new TGLayoutHints(kLHintsNormal, 0,0,0,0));
+
+  PSDOptimize_HF2->AddFrame(PSDOptimizeBandMin_NEL = new ADAQNumberEntryWithLabel(PSDOptimize_HF2, "Minimum  ", -1),
+			    new TGLayoutHints(kLHintsLeft, 0,0,5,0));
+  PSDOptimizeBandMin_NEL->GetEntry()->SetNumStyle(TGNumberFormat::kNESReal);
+  PSDOptimizeBandMin_NEL->GetEntry()->SetNumAttr(TGNumberFormat::kNEANonNegative);
+  PSDOptimizeBandMin_NEL->GetEntry()->SetNumber(1000);
+
+  PSDOptimize_HF2->AddFrame(PSDOptimizeBandMax_NEL = new ADAQNumberEntryWithLabel(PSDOptimize_HF2, "Maximum  ", -1),
+			    new TGLayoutHints(kLHintsLeft, 0,0,5,0));
+  PSDOptimizeBandMax_NEL->GetEntry()->SetNumStyle(TGNumberFormat::kNESReal);
+  PSDOptimizeBandMax_NEL->GetEntry()->SetNumAttr(TGNumberFormat::kNEANonNegative);
+  PSDOptimizeBandMax_NEL->GetEntry()->SetNumber(20000);
+
+  PSDOptimize_GF->AddFrame(PSDOptimizeWindows_TB = new TGTextButton(PSDOptimize_GF, "Optimize windows", PSDOptimizeWindows_TB_ID),
+			   new TGLayoutHints(kLHintsNormal, 0,5,10,5));
+  PSDOptimizeWindows_TB->Connect("Clicked()", "AAPSDSlots", ProcessingSlots, "HandleTextButtons()");
+  PSDOptimizeWindows_TB->Resize(150,30);
+  PSDOptimizeWindows_TB->ChangeOptions(PSDOptimizeWindows_TB->GetOptions() | kFixedSize);
 }
 
 
@@ -2228,6 +2539,66 @@ void AAInterface::FillProcessingFrame()
   UpdateFreq_NEL->GetEntry()->SetLimitValues(1,100);
   UpdateFreq_NEL->GetEntry()->SetNumber(2);
 
+  ProcessingOptions_GF->AddFrame(PulseStorePrecision_CBL = new ADAQComboBoxWithLabel(ProcessingOptions_GF, "Pulse value storage", -1),
+				 new TGLayoutHints(kLHintsNormal, 0,0,5,0));
+  PulseStorePrecision_CBL->GetComboBox()->AddEntry("Double (64-bit)", zPulseStoreDouble);
+  PulseStorePrecision_CBL->GetComboBox()->AddEntry("Float (32-bit)", zPulseStoreFloat);
+  PulseStorePrecision_CBL->GetComboBox()->AddEntry("Quantized (16-bit)", zPulseStoreQuantized);
+  PulseStorePrecision_CBL->GetComboBox()->Select(zPulseStoreDouble);
+  
+  ProcessingOptions_GF->AddFrame(PulseStoreSpillToDisk_CB = new TGCheckButton(ProcessingOptions_GF, "Spill pulse values to disk", -1),
+				 new TGLayoutHints(kLHintsNormal, 0,0,5,0));
+  PulseStoreSpillToDisk_CB->SetState(kButtonUp);
+
+  ProcessingOptions_GF->AddFrame(ProgressiveDisplay_CBL = new ADAQComboBoxWithLabel(ProcessingOptions_GF, "Live display", -1),
+				 new TGLayoutHints(kLHintsNormal, 0,0,5,0));
+  ProgressiveDisplay_CBL->GetComboBox()->AddEntry("Off", zProgressiveDisplayOff);
+  ProgressiveDisplay_CBL->GetComboBox()->AddEntry("Every N waveforms", zProgressiveDisplayWaveforms);
+  ProgressiveDisplay_CBL->GetComboBox()->AddEntry("Every N seconds", zProgressiveDisplaySeconds);
+  ProgressiveDisplay_CBL->GetComboBox()->Select(zProgressiveDisplaySeconds);
+
+  ProcessingOptions_GF->AddFrame(ProgressiveDisplayInterval_NEL = new ADAQNumberEntryWithLabel(ProcessingOptions_GF, "Live display interval (N)", -1),
+				 new TGLayoutHints(kLHintsNormal, 0,0,5,0));
+  ProgressiveDisplayInterval_NEL->GetEntry()->SetNumStyle(TGNumberFormat::kNESReal);
+  ProgressiveDisplayInterval_NEL->GetEntry()->SetNumAttr(TGNumberFormat::kNEAPositive);
+  ProgressiveDisplayInterval_NEL->GetEntry()->SetNumber(5);
+
+
+  /////////////////////
+  // Processing metrics
+
+  // The rates and the share of the processing time spent in each
+  // stage of the waveform processing loop, which are updated while
+  // a spectrum or PSD histogram is being processed
+  
+  TGGroupFrame *ProcessingMetrics_GF = new TGGroupFrame(ProcessingFrame_VF, "Processing metrics", kVerticalFrame);
+  ProcessingFrame_VF->AddFrame(ProcessingMetrics_GF, new TGLayoutHints(kLHintsLeft, 5,5,5,5));
+
+  ProcessingMetrics_GF->AddFrame(ProcessingWaveformRate_NEFL = new ADAQNumberEntryFieldWithLabel(ProcessingMetrics_GF, "Waveforms / s", -1),
+				 new TGLayoutHints(kLHintsNormal, 0,0,5,0));
+  ProcessingMetrics_GF->AddFrame(ProcessingPulseRate_NEFL = new ADAQNumberEntryFieldWithLabel(ProcessingMetrics_GF, "Pulses / s", -1),
+				 new TGLayoutHints(kLHintsNormal, 0,0,0,0));
+  ProcessingMetrics_GF->AddFrame(ProcessingDataRead_NEFL = new ADAQNumberEntryFieldWithLabel(ProcessingMetrics_GF, "Data read (MB)", -1),
+				 new TGLayoutHints(kLHintsNormal, 0,0,0,5));
+
+  for(Int_t s=0; s<zNumProcessingStages; s++){
+    string Label = AAProcessingMetrics::GetStageName(s) + " (%)";
+    ProcessingMetrics_GF->AddFrame(ProcessingStageShare_NEFL[s] = new ADAQNumberEntryFieldWithLabel(ProcessingMetrics_GF, Label.c_str(), -1),
+				   new TGLayoutHints(kLHintsNormal, 0,0,0,0));
+  }
+  
+  ADAQNumberEntryFieldWithLabel *ProcessingMetrics_NEFL[3] = {ProcessingWaveformRate_NEFL,
+							       ProcessingPulseRate_NEFL,
+							       ProcessingDataRead_NEFL};
+  
+  for(Int_t i=0; i<3+zNumProcessingStages; i++){
+    TGNumberEntryField *Entry = (i<3) ? ProcessingMetrics_NEFL[i]->GetEntry() : ProcessingStageShare_NEFL[i-3]->GetEntry();
+    Entry->SetFormat(TGNumberFormat::kNESRealOne, TGNumberFormat::kNEANonNegative);
+    Entry->Resize(80,20);
+    Entry->SetState(true);
+    Entry->SetBackgroundColor(ColorMgr->Number2Pixel(19));
+  }
+
 
   // Despliced file creation options
   
@@ -2424,11 +2795,139 @@ void AAInterface::FillCanvasFrame()
   Quit_TB->SetForegroundColor(ColorMgr->Number2Pixel(0));
   Quit_TB->ChangeOptions(Quit_TB->GetOptions() | kFixedSize);
   Quit_TB->Connect("Clicked()", "AANontabSlots", NontabSlots, "HandleTerminate()");
+
+  SubCanvas_HF->AddFrame(CancelProcessing_TB = new TGTextButton(SubCanvas_HF, "Cancel", CancelProcessing_TB_ID),
+			 new TGLayoutHints(kLHintsRight, 5,5,0,5));
+  CancelProcessing_TB->Resize(80, 40);
+  CancelProcessing_TB->ChangeOptions(CancelProcessing_TB->GetOptions() | kFixedSize);
+  CancelProcessing_TB->Connect("Clicked()", "AANontabSlots", NontabSlots, "HandleCancelProcessing()");
+  CancelProcessing_TB->SetState(kButtonDisabled);
+
+  // The timer is started when a waveform processing job is run in
+  // the background thread and polls the job for progress
+  ProcessingTimer = new TTimer(200);
+  ProcessingTimer->Connect("Timeout()", "AANontabSlots", NontabSlots, "HandleProcessingTimer()");
+
+  // The timer is started when a PSD histogram slice fit is requested
+  // and collects the fit once the fitting thread has finished
+  PSDSliceFitTimer = new TTimer(50);
+  PSDSliceFitTimer->Connect("Timeout()", "AANontabSlots", NontabSlots, "HandlePSDSliceFitTimer()");
+}
+
+
+// Method to fill an options tab with its widgets. Tabs filled after
+// the main window has been mapped must have their new widgets mapped
+// and laid out explicitly
+void AAInterface::FillOptionsTab(int Tab)
+{
+  if(Tab < 0 or Tab >= zNumOptionsTabs or OptionsTabFilled[Tab])
+    return;
+
+  chrono::steady_clock::time_point Start = chrono::steady_clock::now();
+  
+  const char *TabNames[zNumOptionsTabs] = {"Waveform", "Spectrum", "Analysis",
+					   "PSD", "Graphics", "Processing"};
+  TGCompositeFrame *TabFrame = NULL;
+  
+  switch(Tab){
+  case zWaveformTab:
+    FillWaveformFrame();
+    TabFrame = WaveformOptions_CF;
+    break;
+
+  case zSpectrumTab:
+    FillSpectrumFrame();
+    TabFrame = SpectrumOptions_CF;
+    break;
+
+  case zAnalysisTab:
+    FillAnalysisFrame();
+    TabFrame = AnalysisOptions_CF;
+    break;
+
+  case zPSDTab:
+    FillPSDFrame();
+    TabFrame = PSDOptions_CF;
+    break;
+
+  case zGraphicsTab:
+    FillGraphicsFrame();
+    TabFrame = GraphicsOptions_CF;
+    break;
+
+  case zProcessingTab:
+    FillProcessingFrame();
+    TabFrame = ProcessingOptions_CF;
+    break;
+  }
+
+  OptionsTabFilled[Tab] = true;
+  
+  if(IsMapped()){
+    TabFrame->MapSubwindows();
+    TabFrame->Layout();
+  }
+
+  string Stage = string(TabNames[Tab]) + " tab";
+  
+  if(!StartupReported)
+    AddStartupTime(Stage);
+  else if(getenv("ADAQANALYSIS_TIMING") != NULL){
+    Double_t Elapsed = chrono::duration<Double_t, milli>(chrono::steady_clock::now() - Start).count();
+    cout << "ADAQAnalysis : " << Stage << " filled on first use in "
+	 << fixed << setprecision(1) << Elapsed << " ms" << endl;
+  }
+}
+
+
+void AAInterface::FillOptionsTabs()
+{
+  for(int tab=0; tab<zNumOptionsTabs; tab++)
+    FillOptionsTab(tab);
+}
+
+
+void AAInterface::AddStartupTime(string Stage)
+{
+  StartupStages.push_back(Stage);
+  StartupTimes.push_back(chrono::duration<Double_t, milli>(chrono::steady_clock::now() - StartupStart).count());
+}
+
+
+// Method to print the time spent in each startup stage and the total
+// time from program start to the first paint of the window
+void AAInterface::ReportStartupTimes()
+{
+  if(StartupReported)
+    return;
+  
+  StartupReported = true;
+
+  if(getenv("ADAQANALYSIS_TIMING") == NULL)
+    return;
+
+  cout << "\nADAQAnalysis startup timing [ms]\n"
+       << "  " << left << setw(24) << "Stage" << right << setw(10) << "Stage" << setw(10) << "Total" << "\n";
+  
+  for(size_t s=0; s<StartupStages.size(); s++){
+    Double_t Previous = (s == 0) ? 0. : StartupTimes[s-1];
+    cout << "  " << left << setw(24) << StartupStages[s] << right << fixed << setprecision(1)
+	 << setw(10) << StartupTimes[s] - Previous
+	 << setw(10) << StartupTimes[s] << "\n";
+  }
+  cout << endl;
 }
 
 
 void AAInterface::SaveSettings(bool SaveToFile)
 {
+  // The settings object is in use by the background processing
+  // thread and must not be replaced until the job has finished
+  if(ComputationMgr->GetProcessingActive())
+    return;
+
+  FillOptionsTabs();
+  
   delete ADAQSettings;
   ADAQSettings = new AASettings;
   
@@ -2486,6 +2985,7 @@ void AAInterface::SaveSettings(bool SaveToFile)
   // Values from "Spectrum" tabbed frame
 
   ADAQSettings->WaveformsToHistogram = WaveformsToHistogram_NEL->GetEntry()->GetIntNumber();
+  ADAQSettings->SpectrumPreview = SpectrumPreview_CB->IsDown();
   ADAQSettings->SpectrumNumBins = SpectrumNumBins_NEL->GetEntry()->GetIntNumber();
   ADAQSettings->SpectrumMinBin = SpectrumMinBin_NEL->GetEntry()->GetNumber();
   ADAQSettings->SpectrumMaxBin = SpectrumMaxBin_NEL->GetEntry()->GetNumber();
@@ -2507,6 +3007,9 @@ void AAInterface::SaveSettings(bool SaveToFile)
   ADAQSettings->CalibrationMax = SpectrumCalibrationMax_NEL->GetEntry()->GetNumber();
   ADAQSettings->CalibrationType = SpectrumCalibrationType_CBL->GetComboBox()->GetSelectedEntry()->GetTitle();
   ADAQSettings->CalibrationUnit = SpectrumCalibrationUnit_CBL->GetComboBox()->GetSelectedEntry()->GetTitle();;
+
+  ADAQSettings->UseGainDriftCorrection = GainDriftApply_CB->IsDown();
+  ADAQSettings->GainDriftSlices = GainDriftSlices_NEL->GetEntry()->GetIntNumber();
   
   
   //////////////////////////////////////////
@@ -2638,6 +3141,10 @@ void AAInterface::SaveSettings(bool SaveToFile)
 
   ADAQSettings->NumProcessors = NumProcessors_NEL->GetEntry()->GetIntNumber();
   ADAQSettings->UpdateFreq = UpdateFreq_NEL->GetEntry()->GetIntNumber();
+  ADAQSettings->PulseStorePrecision = PulseStorePrecision_CBL->GetComboBox()->GetSelected();
+  ADAQSettings->PulseStoreSpillToDisk = PulseStoreSpillToDisk_CB->IsDown();
+  ADAQSettings->ProgressiveDisplayMode = ProgressiveDisplay_CBL->GetComboBox()->GetSelected();
+  ADAQSettings->ProgressiveDisplayInterval = ProgressiveDisplayInterval_NEL->GetEntry()->GetNumber();
 
   ADAQSettings->WaveformsToDesplice = DesplicedWaveformNumber_NEL->GetEntry()->GetIntNumber();
   ADAQSettings->DesplicedWaveformBuffer = DesplicedWaveformBuffer_NEL->GetEntry()->GetIntNumber();
@@ -2692,6 +3199,103 @@ void AAInterface::SaveSettings(bool SaveToFile)
 }
 
 
+// Method to run a waveform processing job (see ProcessingJobType) in
+// the background thread. The interface is disabled, except for the
+// cancel button, until the processing timer detects that the job has
+// finished and calls FinishProcessing()
+void AAInterface::StartProcessing(int Job)
+{
+  // The job deletes and recreates the objects that may be presently
+  // drawn on the canvas, so the canvas is cleared beforehand
+  Canvas_EC->GetCanvas()->Clear();
+  Canvas_EC->GetCanvas()->Update();
+
+  if(!ComputationMgr->StartProcessingThread(Job))
+    return;
+
+  EnableInterface = false;
+
+  ProcessingProgress_PB->Reset();
+  ProcessingProgress_PB->SetBarColor(ColorMgr->Number2Pixel(33));
+  ProcessingProgress_PB->SetForegroundColor(ColorMgr->Number2Pixel(1));
+
+  CancelProcessing_TB->SetState(kButtonUp);
+
+  SnapshotWaveforms = 0;
+  SnapshotTime = (Long64_t)gSystem->Now();
+  
+  ProcessingTimer->TurnOn();
+}
+
+
+void AAInterface::FinishProcessing()
+{
+  if(!ComputationMgr->FinishProcessingThread())
+    return;
+  
+  ProcessingTimer->TurnOff();
+
+  CancelProcessing_TB->SetState(kButtonDisabled);
+
+  ProcessingProgress_PB->SetPosition(100);
+  ProcessingProgress_PB->SetBarColor(ColorMgr->Number2Pixel(32));
+  ProcessingProgress_PB->SetForegroundColor(ColorMgr->Number2Pixel(0));
+
+  EnableInterface = true;
+
+  UpdateProcessingMetrics();
+
+  switch(ComputationMgr->GetProcessingJob()){
+    
+  case zSpectrumProcessingJob:
+    if(ComputationMgr->GetSpectrumExists()){
+      GraphicsMgr->PlotSpectrum();
+      UpdateForSpectrumCreation();
+    }
+    break;
+
+  case zPSDHistogramProcessingJob:
+    if(ComputationMgr->GetPSDHistogramExists()){
+      GraphicsMgr->PlotPSDHistogram();
+      UpdateForPSDHistogramCreation();
+    }
+    break;
+
+  case zPSDWindowOptimizationJob:
+    if(ComputationMgr->GetPSDHistogramExists())
+      GraphicsMgr->PlotPSDHistogram();
+    UpdateForPSDWindowOptimization();
+    break;
+
+  case zSettingsSweepJob:
+    UpdateForSettingsSweep();
+    break;
+
+  default:
+    break;
+  }
+  
+  if(ComputationMgr->GetProcessingCancelled())
+    CreateMessageBox("Waveform processing was cancelled! The results contain only the waveforms processed before cancellation.","Asterisk");
+}
+
+
+void AAInterface::UpdateProcessingMetrics()
+{
+  if(!OptionsTabFilled[zProcessingTab])
+    return;
+
+  const AAProcessingMetrics *Metrics = ComputationMgr->GetProcessingMetrics();
+  
+  ProcessingWaveformRate_NEFL->GetEntry()->SetNumber(Metrics->GetWaveformRate());
+  ProcessingPulseRate_NEFL->GetEntry()->SetNumber(Metrics->GetPulseRate());
+  ProcessingDataRead_NEFL->GetEntry()->SetNumber(Metrics->GetBytes()/1.e6);
+
+  for(Int_t s=0; s<zNumProcessingStages; s++)
+    ProcessingStageShare_NEFL[s]->GetEntry()->SetNumber(Metrics->GetStageShare(s)*100);
+}
+
+
 // Creates a separate pop-up box with a message for the user. Function
 // is modular to allow flexibility in use.
 void AAInterface::CreateMessageBox(string Message, string IconName)
@@ -2739,6 +3343,8 @@ void AAInterface::CreateMessageBox(string Message, string IconName)
 // an ADAQ-formatted ROOT file
 void AAInterface::UpdateForADAQFile()
 {
+  FillOptionsTabs();
+
   // Get the current channel to be analyzed
   int Channel = ChannelSelector_CBL->GetComboBox()->GetSelected();
 
@@ -2880,6 +3486,9 @@ void AAInterface::UpdateForADAQFile()
   CreateSpectrum_TB->SetState(kButtonDisabled);
   ProcessSpectrum_TB->SetBackgroundColor(ColorMgr->Number2Pixel(36));
 
+  // Settings sweeps operate directly on the ADAQ waveforms
+  SettingsSweep_TB->SetState(kButtonUp);
+
   // Reset the PSD widgets to prevent accessing previous PSD histogram
   // CHECK THIS FOR PSDOVERHAUL : ZSH (10 APR 16)
   if(true){
@@ -2898,6 +3507,8 @@ void AAInterface::UpdateForADAQFile()
 // an ASIM-formatted ROOT file
 void AAInterface::UpdateForASIMFile()
 {
+  FillOptionsTabs();
+
   // Update header widgets appropriately
   FileName_TE->SetText(ASIMFileName.c_str());
   Waveforms_NEL->SetNumber(0);
@@ -2914,6 +3525,7 @@ void AAInterface::UpdateForASIMFile()
   ADAQSpectrumAlgorithmSMS_RB->SetState(kButtonDisabled);
   ADAQSpectrumAlgorithmPF_RB->SetState(kButtonDisabled);
   ADAQSpectrumAlgorithmWD_RB->SetState(kButtonDisabled);
+  SettingsSweep_TB->SetState(kButtonDisabled);
 
   if(ASIMSpectrumTypeEnergy_RB->IsDown()){
     ASIMSpectrumTypeEnergy_RB->SetEnabled(true);
@@ -2936,28 +3548,31 @@ void AAInterface::UpdateForASIMFile()
   else
     ASIMSpectrumTypePhotonsCreated_RB->SetEnabled(true);
 
-  TList *ASIMEventTreeList = ComputationMgr->GetASIMEventTreeList();
+  vector<string> ASIMEventTreeNames = ComputationMgr->GetASIMEventTreeNames();
 
   ASIMEventTree_CB->SetEnabled(true);
   ASIMEventTree_CB->RemoveAll();
+  ASIMEventTrees_LB->RemoveAll();
 
-  TIter It(ASIMEventTreeList);
-  TTree *EventTree = NULL;
-  int EventTreeID = 0;
+  // Add the event tree names to the combo box with integer ID. Note
+  // that only the first TTree is read from file (to obtain its total
+  // entries); the remaining trees are read only when selected
   int EventTreeEntries = 0;
-  while((EventTree = (TTree *)It.Next())){
-    // Add the event tree name to the combo box with integer ID
-    ASIMEventTree_CB->AddEntry(EventTree->GetName(), EventTreeID);
-
-    // Get the total entries in the first TTree
-    if(EventTreeID == 0)
-      EventTreeEntries = EventTree->GetEntries();
-
-    // Increment the integer ID
-    EventTreeID++;
+  for(size_t id=0; id<ASIMEventTreeNames.size(); id++){
+    ASIMEventTree_CB->AddEntry(ASIMEventTreeNames[id].c_str(), id);
+    ASIMEventTrees_LB->AddEntry(ASIMEventTreeNames[id].c_str(), id);
+
+    if(id == 0){
+      TTree *EventTree = ComputationMgr->GetASIMEventTree(ASIMEventTreeNames[id]);
+      if(EventTree)
+	EventTreeEntries = EventTree->GetEntries();
+    }
   }
 
   ASIMEventTree_CB->Select(0,false);
+  ASIMEventTrees_LB->Layout();
+
+  CreateASIMSpectra_TB->SetState(kButtonUp);
 
   Waveforms_NEL->SetNumber(EventTreeEntries);
   WaveformsToHistogram_NEL->GetEntry()->SetNumber(EventTreeEntries);
@@ -3013,6 +3628,10 @@ void AAInterface::UpdateForSpectrumCreation()
   // Activate the CreateSpectrum_TB button since processed waveform
   // values have been created and stored in vectors in AAComputation
   CreateSpectrum_TB->SetState(kButtonUp);
+
+  // Gain drift corrections may be computed from the stored values
+  if(ADAQFileLoaded)
+    GainDriftCompute_TB->SetState(kButtonUp);
   
   // Alert the user that waveforms have been processed by updating
   // the ProcessSpectrum_TB button color
@@ -3028,6 +3647,61 @@ void AAInterface::UpdateForPSDHistogramCreation()
   PSDEnableRegionCreation_CB->SetState(kButtonUp);
 
   PSDEnableHistogramSlicing_CB->SetState(kButtonUp);
+
+  PSDFOMScan_TB->SetState(kButtonUp);
+}
+
+
+// Method to report the PSD integration windows ranked by the
+// optimization job and to set the windows to the highest ranked
+void AAInterface::UpdateForPSDWindowOptimization()
+{
+  vector<PSDWindowCandidateStruct> Candidates = ComputationMgr->GetPSDWindowCandidates();
+  
+  if(Candidates.empty()){
+    CreateMessageBox("The PSD figure of merit could not be determined for any window!","Stop");
+    return;
+  }
+  
+  stringstream SS;
+  SS << "The highest ranked PSD integration windows are:\n\n";
+  for(size_t c=0; c<Candidates.size() and c<5; c++)
+    SS << "  Total [" << Candidates[c].TotalStart << ", " << Candidates[c].TotalStop << "]  "
+       << "Tail [" << Candidates[c].TailStart << ", " << Candidates[c].TailStop << "]  "
+       << "FOM = " << Candidates[c].FOM << " +/- " << Candidates[c].FOMError << "\n";
+  SS << "\nThe PSD integration windows have been set to the highest ranked.";
+  
+  PSDTotalStart_NEL->GetEntry()->SetNumber(Candidates[0].TotalStart);
+  PSDTotalStop_NEL->GetEntry()->SetNumber(Candidates[0].TotalStop);
+  PSDTailStart_NEL->GetEntry()->SetNumber(Candidates[0].TailStart);
+  PSDTailStop_NEL->GetEntry()->SetNumber(Candidates[0].TailStop);
+  
+  CreateMessageBox(SS.str(),"Asterisk");
+}
+
+
+// Method to plot the spectra of the settings sweep job and to report
+// the counts and processing time of each variant
+void AAInterface::UpdateForSettingsSweep()
+{
+  if(!ComputationMgr->GetSettingsSweepExists()){
+    CreateMessageBox("The settings sweep could not be run! Please check the baseline regions.","Stop");
+    return;
+  }
+  
+  GraphicsMgr->PlotSettingsSweepSpectra();
+  
+  vector<TH1F *> Spectra = ComputationMgr->GetSettingsSweepSpectra();
+  vector<Double_t> Times = ComputationMgr->GetSettingsSweepTimes();
+  
+  stringstream SS;
+  SS << "Settings sweep results:\n\n";
+  for(size_t v=0; v<Spectra.size(); v++)
+    SS << "  " << Spectra[v]->GetTitle() << "  : "
+       << Spectra[v]->GetEntries() << " counts in "
+       << Times[v] << " s\n";
+  
+  CreateMessageBox(SS.str(),"Asterisk");
 }
 
 
@@ -3112,6 +3786,8 @@ void AAInterface::SetEANeutronWidgetState(bool WidgetState, EButtonState ButtonS
   EAProtonEnergy_NEL->GetEntry()->SetState(WidgetState);
   EAAlphaEnergy_NEL->GetEntry()->SetState(WidgetState);
   EACarbonEnergy_NEL->GetEntry()->SetState(WidgetState);
+  EAConvertType_CBL->GetComboBox()->SetEnabled(WidgetState);
+  EAConvertSpectrum_TB->SetState(ButtonState);
 }
 
 
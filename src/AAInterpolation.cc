@@ -32,6 +32,7 @@
 // C++
 #include <iostream>
 #include <cmath>
+#include <algorithm>
 using namespace std;
 
 // ADAQAnalysis
@@ -48,7 +49,7 @@ AAInterpolation *AAInterpolation::GetInstance()
 
 AAInterpolation::AAInterpolation()
   : m_e(0.511), MeV2GeV(0.001), NumParticles(4),
-    ConversionFactor(1.)
+    ConversionFactor(1.), ResponsesConstructed(false)
 {
   if(TheInterpolationManager)
     cout << "\nError! TheInterpolationManager was constructed twice!\n" << endl;
@@ -70,8 +71,8 @@ AAInterpolation::AAInterpolation()
     Response.push_back(new TGraph);
     Inverse.push_back(new TGraph);
   }
-
-  ConstructResponses();
+  ResponseTables.resize(NumParticles);
+  InverseTables.resize(NumParticles);
 }
 
 
@@ -109,7 +110,103 @@ void AAInterpolation::ConstructResponses()
     // Construct the response and inversve functions
     Response[particle] = new TGraph(LightEntries, EnergyDep, &Light[particle][0]);
     Inverse[particle] = new TGraph(LightEntries, &Light[particle][0], EnergyDep);
+
+    // Construct the lookup tables used for all conversions. Note
+    // that TGraph::Eval(x,0,"S") constructs a new TSpline3 upon every
+    // call, which is far too slow for converting entire spectra
+    ResponseTables[particle].Construct(LightEntries, EnergyDep, &Light[particle][0]);
+    InverseTables[particle].Construct(LightEntries, &Light[particle][0], EnergyDep);
+  }
+
+  ResponsesConstructed = true;
+}
+
+
+void AAInterpolation::SetConversionFactor(double CF)
+{
+  if(CF == ConversionFactor)
+    return;
+  
+  ConversionFactor = CF;
+
+  // Rebuild only responses that have already been constructed
+  if(ResponsesConstructed)
+    ConstructResponses();
+}
+
+
+// Method to compute the knot slopes of a monotone piecewise cubic
+// Hermite interpolant through the data. Interior slopes are the
+// weighted harmonic mean of the adjacent secant slopes (zero at local
+// extrema), which guarantees that monotone data produces a monotone
+// interpolant without the overshoot of a natural cubic spline
+void AAInterpolation::ResponseTable::Construct(int N, const double *XData, const double *YData)
+{
+  X.assign(XData, XData+N);
+  Y.assign(YData, YData+N);
+  M.assign(N, 0.);
+
+  if(N < 2)
+    return;
+  
+  vector<double> H(N-1), Delta(N-1);
+  for(int i=0; i<N-1; i++){
+    H[i] = X[i+1] - X[i];
+    Delta[i] = (H[i] != 0.) ? (Y[i+1] - Y[i]) / H[i] : 0.;
+  }
+
+  M[0] = Delta[0];
+  M[N-1] = Delta[N-2];
+  
+  for(int i=1; i<N-1; i++){
+    if(Delta[i-1] * Delta[i] <= 0.)
+      M[i] = 0.;
+    else{
+      double W1 = 2*H[i] + H[i-1];
+      double W2 = H[i] + 2*H[i-1];
+      M[i] = (W1 + W2) / (W1/Delta[i-1] + W2/Delta[i]);
+    }
+  }
+}
+
+
+// Method to evaluate the lookup table. The Hint is the interval
+// index found by the previous evaluation; consecutive evaluations at
+// increasing values (e.g. histogram bin edges) therefore do not
+// require a search. Values beyond the table are linearly extrapolated
+double AAInterpolation::ResponseTable::Eval(double Value, int &Hint) const
+{
+  const int N = X.size();
+
+  if(N == 0)
+    return 0.;
+  else if(N == 1)
+    return Y[0];
+  
+  if(Value <= X[0])
+    return Y[0] + M[0] * (Value - X[0]);
+  else if(Value >= X[N-1])
+    return Y[N-1] + M[N-1] * (Value - X[N-1]);
+  
+  int k = Hint;
+  if(k < 0 or k > N-2 or Value < X[k]){
+    k = upper_bound(X.begin(), X.end(), Value) - X.begin() - 1;
+  }
+  else{
+    while(k < N-2 and Value >= X[k+1])
+      k++;
   }
+  Hint = k;
+  
+  double h = X[k+1] - X[k];
+  double t = (Value - X[k]) / h;
+  double t2 = t*t;
+  double t3 = t2*t;
+  
+  return ((2*t3 - 3*t2 + 1) * Y[k] +
+	  (t3 - 2*t2 + t) * h * M[k] +
+	  (-2*t3 + 3*t2) * Y[k+1] +
+	  (t3 - t2) * h * M[k+1]);
 }
 
 
@@ -117,8 +214,11 @@ void AAInterpolation::ConstructResponses()
 // deposited by the specified particle
 double AAInterpolation::GetElectronEnergy(double Energy, int Particle)
 {
-  double Light = Response[Particle]->Eval(Energy, 0, "S");
-  return Inverse[ELECTRON]->Eval(Light, 0, "S");
+  CheckResponses();
+
+  int RHint = 0, IHint = 0;
+  double Light = ResponseTables[Particle].Eval(Energy, RHint);
+  return InverseTables[ELECTRON].Eval(Light, IHint);
 }
 
 
@@ -133,22 +233,83 @@ double AAInterpolation::GetGammaEnergy(double EE)
 // Method to get the proton/neutron energy from EE energy
 double AAInterpolation::GetProtonEnergy(double EE)
 {
-  double Light = Response[ELECTRON]->Eval(EE, 0, "S");
-  return Inverse[PROTON]->Eval(Light, 0, "S");
+  CheckResponses();
+
+  int RHint = 0, IHint = 0;
+  return ConvertEnergy(EE, zProtonEnergy, RHint, IHint);
 }
 
 
 // Method to get the alpha energy from the EE energy
 double AAInterpolation::GetAlphaEnergy(double EE)
 {
-  double Light = Response[ELECTRON]->Eval(EE, 0, "S");
-  return Inverse[ALPHA]->Eval(Light, 0, "S");
+  CheckResponses();
+
+  int RHint = 0, IHint = 0;
+  return ConvertEnergy(EE, zAlphaEnergy, RHint, IHint);
 }
 
 
 // Method to get the carbon energy from the EE energy
 double AAInterpolation::GetCarbonEnergy(double EE)
 {
-  double Light = Response[ELECTRON]->Eval(EE, 0, "S");
-  return (Inverse[CARBON]->Eval(Light, 0, "S") * MeV2GeV);
+  CheckResponses();
+
+  int RHint = 0, IHint = 0;
+  return ConvertEnergy(EE, zCarbonEnergy, RHint, IHint);
+}
+
+
+// Method to convert a single EE energy into the specified energy
+// type using (and updating) the lookup table search hints
+double AAInterpolation::ConvertEnergy(double EE, int Type, int &RHint, int &IHint)
+{
+  if(Type == zGammaEnergy)
+    return GetGammaEnergy(EE);
+  
+  double Light = ResponseTables[ELECTRON].Eval(EE, RHint);
+  
+  if(Type == zProtonEnergy)
+    return InverseTables[PROTON].Eval(Light, IHint);
+  else if(Type == zAlphaEnergy)
+    return InverseTables[ALPHA].Eval(Light, IHint);
+  else if(Type == zCarbonEnergy)
+    return (InverseTables[CARBON].Eval(Light, IHint) * MeV2GeV);
+  else
+    return EE;
+}
+
+
+// Method to convert an array of N EE energies into the specified
+// energy type. Conversion is fastest for sorted input values
+void AAInterpolation::ConvertEnergies(const double *EE, double *Energies, int N, int Type)
+{
+  CheckResponses();
+
+  int RHint = 0, IHint = 0;
+  for(int i=0; i<N; i++)
+    Energies[i] = ConvertEnergy(EE[i], Type, RHint, IHint);
+}
+
+
+vector<double> AAInterpolation::ConvertEnergies(const vector<double> &EE, int Type)
+{
+  vector<double> Energies(EE.size(), 0.);
+  if(!EE.empty())
+    ConvertEnergies(&EE[0], &Energies[0], EE.size(), Type);
+  return Energies;
+}
+
+
+// Method to convert the N+1 bin edges of a histogram's x-axis, which
+// is assumed to be in units of EE energy, to the specified energy type
+vector<double> AAInterpolation::ConvertBinEdges(TH1 *Histogram, int Type)
+{
+  const int NumBins = Histogram->GetNbinsX();
+  
+  vector<double> Edges(NumBins+1, 0.);
+  for(int bin=1; bin<=NumBins+1; bin++)
+    Edges[bin-1] = Histogram->GetXaxis()->GetBinLowEdge(bin);
+  
+  return ConvertEnergies(Edges, Type);
 }
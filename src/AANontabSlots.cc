@@ -26,7 +26,9 @@
 
 // ROOT
 #include <TGFileDialog.h>
+#include <TObjString.h>
 #include <TApplication.h>
+#include <TSystem.h>
 
 // ADAQAnalysis
 #include "AANontabSlots.hh"
@@ -47,6 +49,13 @@ AANontabSlots::~AANontabSlots()
 {;}
 
 
+void AANontabSlots::HandleCancelProcessing()
+{
+  if(ComputationMgr->GetProcessingActive())
+    ComputationMgr->CancelProcessing();
+}
+
+
 void AANontabSlots::HandleCanvas(int EventID, int XPixel, int YPixel, TObject *Selected)
 {
   if(!TheInterface->EnableInterface)
@@ -93,12 +102,17 @@ void AANontabSlots::HandleCanvas(int EventID, int XPixel, int YPixel, TObject *S
       return;
     }
     else{
-      ComputationMgr->CreatePSDHistogramSlice(XPixel, YPixel);
-      GraphicsMgr->PlotPSDHistogramSlice(XPixel, YPixel);
+      // The slice is only redrawn when the cursor enters a new bin
+      if(ComputationMgr->CreatePSDHistogramSlice(XPixel, YPixel))
+	GraphicsMgr->PlotPSDHistogramSlice(XPixel, YPixel);
       
+      // The FOM fit runs in the background; the result is drawn and
+      // the FOM displayed by HandlePSDSliceFitTimer() when ready
       if(TheInterface->PSDCalculateFOM_CB->IsDown()){
-	Double_t FOM = GraphicsMgr->GetPSDFigureOfMerit();
-	TheInterface->PSDFigureOfMerit_NEFL->GetEntry()->SetNumber(FOM);
+	ComputationMgr->RequestPSDSliceFit();
+	
+	if(ComputationMgr->GetPSDSliceFitPending())
+	  TheInterface->PSDSliceFitTimer->TurnOn();
       }
     }
   }
@@ -220,7 +234,7 @@ void AANontabSlots::HandleDoubleSliders()
     break;
 
   case SpectrumIntegrationLimits_DHS_ID:
-    ComputationMgr->IntegrateSpectrum();
+    // The integral and fit are recomputed on demand by PlotSpectrum()
     GraphicsMgr->PlotSpectrum();
     
     if(TheInterface->SpectrumFindIntegral_CB->IsDown()){
@@ -294,6 +308,15 @@ void AANontabSlots::HandleDoubleSliders()
 
 void AANontabSlots::HandleMenu(int MenuID)
 {
+  // Files may not be opened or saved while waveforms are being
+  // processed in the background thread
+  if(ComputationMgr->GetProcessingActive() and MenuID != MenuFileExit_ID)
+    return;
+
+  // The file and settings actions read and set widgets in all tabs
+  if(MenuID != MenuFileExit_ID)
+    TheInterface->FillOptionsTabs();
+  
   switch(MenuID){
     
     // Action that enables the user to select a ROOT file with
@@ -328,6 +351,11 @@ void AANontabSlots::HandleMenu(int MenuID)
     TGFileInfo FileInformation;
     FileInformation.fFileTypes = FileTypes;
     FileInformation.fIniDir = StrDup(TheInterface->DataDirectory.c_str());
+
+    // Multiple ASIM files may be selected and loaded together
+    if(MenuID == MenuFileOpenASIM_ID)
+      FileInformation.SetMultipleSelection(true);
+    
     new TGFileDialog(gClient->GetRoot(), TheInterface, kFDOpen, &FileInformation);
     
     // If the selected file is not found...
@@ -362,8 +390,18 @@ void AANontabSlots::HandleMenu(int MenuID)
 	TheInterface->ASIMFileLoaded = false;
       }
       else if(MenuID == MenuFileOpenASIM_ID){
-	TheInterface->ASIMFileName = FileName;
-	TheInterface->ASIMFileLoaded = ComputationMgr->LoadASIMFile(FileName);
+	vector<string> FileNames;
+	if(FileInformation.fFileNamesList){
+	  TIter It(FileInformation.fFileNamesList);
+	  TObjString *OS;
+	  while((OS = (TObjString *)It.Next()))
+	    FileNames.push_back(OS->GetString().Data());
+	}
+	if(FileNames.empty())
+	  FileNames.push_back(FileName);
+	
+	TheInterface->ASIMFileName = FileNames[0];
+	TheInterface->ASIMFileLoaded = ComputationMgr->LoadASIMFiles(FileNames);
 
 	// Set whether or not the interface should be enabled
 	TheInterface->EnableInterface = TheInterface->ASIMFileLoaded;
@@ -447,12 +485,128 @@ void AANontabSlots::HandleMenu(int MenuID)
     TheInterface->CreateMessageBox("Loading a PSD histogram is not yet implemented!","Stop");
     break;
 
+    // Action that fits peaks in many spectra at once. The user selects
+    // one or more ROOT files containing a TH1F named 'Spectrum' (as
+    // saved by ADAQAnalysis), an optional text file of fit windows,
+    // and the file to which the fit results will be written
+  case MenuFileBatchFitSpectra_ID:{
+    
+    const char *SpectrumTypes[] = {"ROOT file", "*.root",
+				   0,           0};
+
+    TGFileInfo SpectrumInformation;
+    SpectrumInformation.fFileTypeIdx = 0;
+    SpectrumInformation.fFileTypes = SpectrumTypes;
+    SpectrumInformation.fIniDir = StrDup(TheInterface->HistogramDirectory.c_str());
+    SpectrumInformation.SetMultipleSelection(true);
+    
+    new TGFileDialog(gClient->GetRoot(), TheInterface, kFDOpen, &SpectrumInformation);
+    
+    if(SpectrumInformation.fFilename == NULL){
+      TheInterface->CreateMessageBox("No spectrum files were selected! Nothing will be fit!","Stop");
+      break;
+    }
+
+    vector<string> SpectrumFileNames;
+    if(SpectrumInformation.fFileNamesList){
+      TIter Next(SpectrumInformation.fFileNamesList);
+      TObjString *FileName;
+      while((FileName = (TObjString *)Next()))
+	SpectrumFileNames.push_back(FileName->GetString().Data());
+    }
+    if(SpectrumFileNames.empty())
+      SpectrumFileNames.push_back(SpectrumInformation.fFilename);
+
+    vector<TH1F *> Spectra;
+    vector<string> SpectrumNames;
+    for(size_t f=0; f<SpectrumFileNames.size(); f++){
+      TFile *F = new TFile(SpectrumFileNames[f].c_str(), "read");
+      TH1F *H = NULL;
+      if(F->IsOpen())
+	H = (TH1F *)F->Get("Spectrum");
+      if(H){
+	H->SetDirectory(0);
+	Spectra.push_back(H);
+	SpectrumNames.push_back(SpectrumFileNames[f]);
+      }
+      else
+	cout << "\nADAQAnalysis warning! No TH1F named 'Spectrum' was found in " << SpectrumFileNames[f] << "\n"
+	     << endl;
+      F->Close();
+      delete F;
+    }
+
+    if(Spectra.empty()){
+      TheInterface->CreateMessageBox("No TH1F objects named 'Spectrum' were found in the selected files!","Stop");
+      break;
+    }
+
+    // Fit windows are read from file if one is selected; otherwise
+    // the present spectrum analysis region is fit with one peak
+    const char *WindowTypes[] = {"Fit windows file", "*.dat",
+				 "All files",        "*",
+				 0,                  0};
+
+    TGFileInfo WindowInformation;
+    WindowInformation.fFileTypes = WindowTypes;
+    WindowInformation.fIniDir = StrDup(getenv("PWD"));
+
+    new TGFileDialog(gClient->GetRoot(), TheInterface, kFDOpen, &WindowInformation);
+
+    vector<SpectrumFitWindowStruct> Windows;
+    if(WindowInformation.fFilename != NULL)
+      Windows = ComputationMgr->ReadSpectrumFitWindowsFile(WindowInformation.fFilename);
+    else{
+      SpectrumFitWindowStruct Window;
+      Window.Min = TheInterface->SpectrumAnalysisLowerLimit_NEL->GetEntry()->GetNumber();
+      Window.Max = TheInterface->SpectrumAnalysisUpperLimit_NEL->GetEntry()->GetNumber();
+      Window.NumPeaks = 1;
+      Window.Background = zLinearFitBackground;
+      Windows.push_back(Window);
+    }
+
+    if(Windows.empty()){
+      TheInterface->CreateMessageBox("No valid fit windows were found in the selected file!","Stop");
+      break;
+    }
+
+    const char *ResultTypes[] = {"ADAQ spectrum analysis results file", "*.dat",
+				 "All files"            , "*.*",
+				 0, 0};
+
+    TGFileInfo ResultInformation;
+    ResultInformation.fFileTypes = ResultTypes;
+    ResultInformation.fIniDir = StrDup(getenv("PWD"));
+    ResultInformation.fFilename = StrDup("BatchFitResults.dat");
+
+    new TGFileDialog(gClient->GetRoot(), TheInterface, kFDSave, &ResultInformation);
+
+    if(ResultInformation.fFilename == NULL)
+      TheInterface->CreateMessageBox("No file was selected and, therefore, nothing will be fit!","Stop");
+    else{
+      Bool_t Success = ComputationMgr->BatchFitSpectra(Spectra, SpectrumNames, Windows, ResultInformation.fFilename);
+      if(Success)
+	TheInterface->CreateMessageBox("The batch fit results were successfully written to file.","Asterisk");
+      else
+	TheInterface->CreateMessageBox("There was an unknown error in batch fitting the spectra!","Stop");
+    }
+
+    for(size_t s=0; s<Spectra.size(); s++)
+      delete Spectra[s];
+    
+    break;
+  }
+
   case MenuFileSaveWaveform_ID:
   case MenuFileSaveSpectrum_ID:
   case MenuFileSaveSpectrumBackground_ID:
   case MenuFileSaveSpectrumDerivative_ID:
+  case MenuFileSaveASIMSpectra_ID:
+  case MenuFileSaveSettingsSweep_ID:
+  case MenuFileSaveConvertedSpectrum_ID:
   case MenuFileSavePSDHistogram_ID:
-  case MenuFileSavePSDHistogramSlice_ID:{
+  case MenuFileSavePSDHistogramSlice_ID:
+  case MenuFileSavePSDFOMScan_ID:{
 
     // Create character arrays that enable file type selection (.dat
     // files have data columns separated by spaces and .csv have data
@@ -468,12 +622,18 @@ void AANontabSlots::HandleMenu(int MenuID)
     FileInformation.fIniDir = StrDup(TheInterface->HistogramDirectory.c_str());
     if(MenuID == MenuFileSaveWaveform_ID)
       FileInformation.fFilename = StrDup("DefaultWaveform.root");
-    else if(MenuID == MenuFileSaveSpectrum_ID or MenuID == MenuFileSaveSpectrumBackground_ID or MenuID == MenuFileSaveSpectrumDerivative_ID)
+    else if(MenuID == MenuFileSaveSpectrum_ID or MenuID == MenuFileSaveSpectrumBackground_ID or MenuID == MenuFileSaveSpectrumDerivative_ID or MenuID == MenuFileSaveConvertedSpectrum_ID)
       FileInformation.fFilename = StrDup("DefaultSpectrum.root");
+    else if(MenuID == MenuFileSaveASIMSpectra_ID)
+      FileInformation.fFilename = StrDup("DefaultASIMSpectra.root");
+    else if(MenuID == MenuFileSaveSettingsSweep_ID)
+      FileInformation.fFilename = StrDup("DefaultSettingsSweep.root");
     else if(MenuID == MenuFileSavePSDHistogram_ID)
       FileInformation.fFilename = StrDup("DefaultPSDHistogram.root");
     else if(MenuID == MenuFileSavePSDHistogramSlice_ID)
       FileInformation.fFilename = StrDup("DefaultPSDHistogramSlice.root");
+    else if(MenuID == MenuFileSavePSDFOMScan_ID)
+      FileInformation.fFilename = StrDup("DefaultPSDFOMScan.root");
     
     new TGFileDialog(gClient->GetRoot(), TheInterface, kFDSave, &FileInformation);
     
@@ -548,6 +708,33 @@ void AANontabSlots::HandleMenu(int MenuID)
 	  Success = ComputationMgr->SaveHistogramData("SpectrumDerivative", FileName, FileExtension);
       }
 
+      else if(MenuID == MenuFileSaveConvertedSpectrum_ID){
+	if(!ComputationMgr->GetConvertedSpectrumExists()){
+	  TheInterface->CreateMessageBox("No converted spectrum has been created yet and, therefore, there is nothing to save!","Stop");
+	  break;
+	}
+	else
+	  Success = ComputationMgr->SaveHistogramData("ConvertedSpectrum", FileName, FileExtension);
+      }
+
+      else if(MenuID == MenuFileSaveASIMSpectra_ID){
+	if(!ComputationMgr->GetASIMSpectraExist()){
+	  TheInterface->CreateMessageBox("No ASIM event tree spectra have been created yet and, therefore, there is nothing to save!","Stop");
+	  break;
+	}
+	else
+	  Success = ComputationMgr->SaveHistogramData("ASIMSpectra", FileName, FileExtension);
+      }
+
+      else if(MenuID == MenuFileSaveSettingsSweep_ID){
+	if(!ComputationMgr->GetSettingsSweepExists()){
+	  TheInterface->CreateMessageBox("No settings sweep has been run yet and, therefore, there is nothing to save!","Stop");
+	  break;
+	}
+	else
+	  Success = ComputationMgr->SaveHistogramData("SettingsSweep", FileName, FileExtension);
+      }
+
       else if(MenuID == MenuFileSavePSDHistogram_ID){
 	if(!ComputationMgr->GetPSDHistogramExists()){
 	  TheInterface->CreateMessageBox("A PSD histogram has not been created yet and, therefore, there is nothing to save!","Stop");
@@ -570,6 +757,15 @@ void AANontabSlots::HandleMenu(int MenuID)
 	else
 	  Success = ComputationMgr->SaveHistogramData("PSDHistogramSlice", FileName, FileExtension);
       }
+
+      else if(MenuID == MenuFileSavePSDFOMScan_ID){
+	if(!ComputationMgr->GetPSDFOMScanExists()){
+	  TheInterface->CreateMessageBox("A PSD figure of merit scan has not been created yet and, therefore, there is nothing to save!","Stop");
+	  break;
+	}
+	else
+	  Success = ComputationMgr->SaveHistogramData("PSDFOMScan", FileName, FileExtension);
+      }
       
       if(Success){
 	if(FileExtension == ".dat")
@@ -717,7 +913,7 @@ void AANontabSlots::HandleMenu(int MenuID)
     // Action that enables the Quit_TB and File->Exit selections to
     // quit the ROOT application
   case MenuFileExit_ID:
-    gApplication->Terminate();
+    HandleTerminate();
     
   default:
     break;
@@ -725,10 +921,70 @@ void AANontabSlots::HandleMenu(int MenuID)
 }
 
 
+// Method to fill the widgets of an options tab when first selected
+void AANontabSlots::HandleOptionsTabs(int TabID)
+{
+  TheInterface->FillOptionsTab(TabID);
+}
+
+
+// Method to update the progress bar while a waveform processing job
+// runs in the background thread and to update the interface once the
+// job has finished; called periodically by the processing timer
+void AANontabSlots::HandleProcessingTimer()
+{
+  TheInterface->ProcessingProgress_PB->SetPosition(100 * ComputationMgr->GetProcessingFraction());
+  TheInterface->UpdateProcessingMetrics();
+  
+  if(!ComputationMgr->GetProcessingActive()){
+    TheInterface->FinishProcessing();
+    return;
+  }
+
+  // Draw the partially accumulated spectrum or PSD histogram at the
+  // interval (in waveforms or seconds) set in the processing tab
+
+  AASettings *ADAQSettings = TheInterface->ADAQSettings;
+  
+  Long64_t Waveforms = ComputationMgr->GetProcessingDone();
+  Long64_t Time = (Long64_t)gSystem->Now();
+  
+  Bool_t SnapshotDue = false;
+  if(ADAQSettings->ProgressiveDisplayMode == zProgressiveDisplayWaveforms)
+    SnapshotDue = (Waveforms - TheInterface->SnapshotWaveforms >= ADAQSettings->ProgressiveDisplayInterval);
+  else if(ADAQSettings->ProgressiveDisplayMode == zProgressiveDisplaySeconds)
+    SnapshotDue = (Time - TheInterface->SnapshotTime >= 1000 * ADAQSettings->ProgressiveDisplayInterval);
+
+  if(SnapshotDue and ComputationMgr->UpdateProcessingSnapshot()){
+    GraphicsMgr->PlotProcessingSnapshot();
+    
+    TheInterface->SnapshotWaveforms = Waveforms;
+    TheInterface->SnapshotTime = Time;
+  }
+}
+
+
+void AANontabSlots::HandlePSDSliceFitTimer()
+{
+  if(ComputationMgr->UpdatePSDSliceFit()){
+    GraphicsMgr->PlotPSDHistogramSliceFits();
+    
+    Double_t FOM = ComputationMgr->GetPSDSliceFOM();
+    TheInterface->PSDFigureOfMerit_NEFL->GetEntry()->SetNumber(FOM);
+  }
+  
+  if(!ComputationMgr->GetPSDSliceFitPending())
+    TheInterface->PSDSliceFitTimer->TurnOff();
+}
+
+
 void AANontabSlots::HandleSliders(int SliderPosition)
 {
   if(!TheInterface->ADAQFileLoaded or TheInterface->ASIMFileLoaded)
     return;
+
+  if(ComputationMgr->GetProcessingActive())
+    return;
   
   TheInterface->SaveSettings();
   
@@ -747,8 +1003,25 @@ void AANontabSlots::HandleSliders(int SliderPosition)
 }
 
 
+void AANontabSlots::HandleStartupTimer()
+{
+  TheInterface->AddStartupTime("First paint");
+  TheInterface->ReportStartupTimes();
+}
+
+
 void AANontabSlots::HandleTerminate()
-{ gApplication->Terminate(); }
+{
+  // Stop and join any background processing or index thread before
+  // exiting since both read the ADAQ file
+  ComputationMgr->CancelProcessing();
+  while(!ComputationMgr->FinishProcessingThread())
+    gSystem->Sleep(10);
+
+  ComputationMgr->CancelWaveformIndex();
+  
+  gApplication->Terminate();
+}
 
 
 void AANontabSlots::HandleTripleSliderPointer()
@@ -760,7 +1033,7 @@ void AANontabSlots::HandleTripleSliderPointer()
      GraphicsMgr->GetCanvasContentType() == zSpectrum){
 
     // Get the current spectrum
-    TH1F *Spectrum_H = ComputationMgr->GetSpectrum();
+    const TH1F *Spectrum_H = ComputationMgr->GetSpectrum();
 
     // Calculate the position along the X-axis of the pulse spectrum
     // (the "area" or "height" in ADC units) based on the current
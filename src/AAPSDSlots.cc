@@ -308,11 +308,10 @@ void AAPSDSlots::HandleTextButtons()
       // Sequential waveform processing
       if(TheInterface->ProcessingSeq_RB->IsDown()){
 	
-	if(TheInterface->ADAQFileLoaded)
-	  ComputationMgr->ProcessPSDHistogramWaveforms();
-	
-	if(ComputationMgr->GetPSDHistogramExists())
-	  GraphicsMgr->PlotPSDHistogram();
+	// The waveforms are processed in the background thread; the
+	// PSD histogram is plotted once the job has finished
+	TheInterface->StartProcessing(zPSDHistogramProcessingJob);
+	break;
       }
       
       // Parallel waveform processing
@@ -347,6 +346,53 @@ void AAPSDSlots::HandleTextButtons()
     break;
     
 
+  case PSDFOMScan_TB_ID:{
+
+    int NumBands = TheInterface->PSDFOMScanBands_NEL->GetEntry()->GetIntNumber();
+    double Min = TheInterface->PSDFOMScanMin_NEL->GetEntry()->GetNumber();
+    double Max = TheInterface->PSDFOMScanMax_NEL->GetEntry()->GetNumber();
+    
+    if(ComputationMgr->CreatePSDFOMScan(NumBands, Min, Max))
+      GraphicsMgr->PlotPSDFOMScan();
+    else
+      TheInterface->CreateMessageBox("The PSD figure of merit could not be determined in any band!","Stop");
+    
+    break;
+  }
+    
+
+  case PSDOptimizeWindows_TB_ID:{
+
+    if(!TheInterface->ADAQFileLoaded){
+      TheInterface->CreateMessageBox("PSD windows can only be optimized for ADAQ files!","Stop");
+      break;
+    }
+    
+    if(TheInterface->PSDAlgorithmWD_RB->IsDown()){
+      TheInterface->CreateMessageBox("PSD windows cannot be optimized using stored waveform data!","Stop");
+      break;
+    }
+    
+    PSDWindowScanStruct Scan;
+    Scan.TotalStart = TheInterface->PSDTotalStart_NEL->GetEntry()->GetIntNumber();
+    Scan.TotalStopMin = TheInterface->PSDOptimizeTotalStopMin_NEL->GetEntry()->GetIntNumber();
+    Scan.TotalStopMax = TheInterface->PSDOptimizeTotalStopMax_NEL->GetEntry()->GetIntNumber();
+    Scan.TotalStopSteps = TheInterface->PSDOptimizeTotalStopSteps_NEL->GetEntry()->GetIntNumber();
+    Scan.TailStartMin = TheInterface->PSDOptimizeTailStartMin_NEL->GetEntry()->GetIntNumber();
+    Scan.TailStartMax = TheInterface->PSDOptimizeTailStartMax_NEL->GetEntry()->GetIntNumber();
+    Scan.TailStartSteps = TheInterface->PSDOptimizeTailStartSteps_NEL->GetEntry()->GetIntNumber();
+    Scan.BandMin = TheInterface->PSDOptimizeBandMin_NEL->GetEntry()->GetNumber();
+    Scan.BandMax = TheInterface->PSDOptimizeBandMax_NEL->GetEntry()->GetNumber();
+
+    // The scan runs in the background thread; the results are
+    // reported by AAInterface::UpdateForPSDWindowOptimization()
+    ComputationMgr->SetPSDWindowScan(Scan);
+    TheInterface->StartProcessing(zPSDWindowOptimizationJob);
+    
+    break;
+  }
+    
+
   case PSDCreateRegion_TB_ID:
 
     if(TheInterface->ADAQFileLoaded){
@@ -0,0 +1,157 @@
+/////////////////////////////////////////////////////////////////////////////////
+//                                                                             //
+//                            Copyright (C) 2012-2023                          //
+//                  Zachary Seth Hartwig : All rights reserved                 //
+//                                                                             //
+//      The ADAQAnalysis source code is licensed under the GNU GPL v3.0.       //
+//      You have the right to modify and/or redistribute this source code      //
+//      under the terms specified in the license, which is found online        //
+//      at http://www.gnu.org/licenses or at $ADAQANALYSIS/License.txt.        //
+//                                                                             //
+/////////////////////////////////////////////////////////////////////////////////
+
+/////////////////////////////////////////////////////////////////////////////////
+//
+// name: AAProcessingMetrics.cc
+// date: 18 Oct 26
+// auth: Zach Hartwig
+// mail: hartwig@psfc.mit.edu
+//
+// desc: The AAProcessingMetrics class measures the time spent in each
+//       stage of the waveform processing loop and the rate at which
+//       waveforms and pulses are processed.
+//
+/////////////////////////////////////////////////////////////////////////////////
+
+// C++
+#include <sstream>
+#include <iomanip>
+
+// ADAQAnalysis
+#include "AAProcessingMetrics.hh"
+
+
+AAProcessingMetrics::AAProcessingMetrics()
+  : Active(false), StartTime(0), StopTime(0),
+    Waveforms(0), Pulses(0), Bytes(0),
+    LastTime(0), Current(zOtherStage)
+{
+  for(Int_t s=0; s<zNumProcessingStages; s++)
+    StageTimes[s].store(0, memory_order_relaxed);
+}
+
+
+AAProcessingMetrics::~AAProcessingMetrics()
+{;}
+
+
+void AAProcessingMetrics::Start()
+{
+  for(Int_t s=0; s<zNumProcessingStages; s++)
+    StageTimes[s].store(0, memory_order_relaxed);
+
+  Waveforms.store(0, memory_order_relaxed);
+  Pulses.store(0, memory_order_relaxed);
+  Bytes.store(0, memory_order_relaxed);
+
+  Current = zOtherStage;
+  LastTime = GetTime();
+  StartTime.store(LastTime, memory_order_relaxed);
+  StopTime.store(0, memory_order_relaxed);
+
+  Active.store(true, memory_order_relaxed);
+}
+
+
+void AAProcessingMetrics::Stop()
+{
+  if(!Active.load(memory_order_relaxed))
+    return;
+
+  Switch(zOtherStage);
+  StopTime.store(LastTime, memory_order_relaxed);
+
+  Active.store(false, memory_order_relaxed);
+}
+
+
+Double_t AAProcessingMetrics::GetElapsed() const
+{
+  Long64_t Start = StartTime.load(memory_order_relaxed);
+  if(Start == 0)
+    return 0.;
+
+  Long64_t Stop = StopTime.load(memory_order_relaxed);
+  if(Stop == 0)
+    Stop = GetTime();
+
+  return (Stop - Start) * 1.e-9;
+}
+
+
+Double_t AAProcessingMetrics::GetWaveformRate() const
+{
+  Double_t Elapsed = GetElapsed();
+  return (Elapsed > 0.) ? GetWaveforms() / Elapsed : 0.;
+}
+
+
+Double_t AAProcessingMetrics::GetPulseRate() const
+{
+  Double_t Elapsed = GetElapsed();
+  return (Elapsed > 0.) ? GetPulses() / Elapsed : 0.;
+}
+
+
+Double_t AAProcessingMetrics::GetStageTime(Int_t Stage) const
+{ return StageTimes[Stage].load(memory_order_relaxed) * 1.e-9; }
+
+
+Double_t AAProcessingMetrics::GetStageShare(Int_t Stage) const
+{
+  Long64_t Total = 0;
+  for(Int_t s=0; s<zNumProcessingStages; s++)
+    Total += StageTimes[s].load(memory_order_relaxed);
+
+  if(Total == 0)
+    return 0.;
+
+  return StageTimes[Stage].load(memory_order_relaxed) * 1. / Total;
+}
+
+
+string AAProcessingMetrics::GetStageName(Int_t Stage)
+{
+  switch(Stage){
+  case zReadStage: return "Entry read";
+  case zWaveformStage: return "Waveform build";
+  case zBaselineStage: return "Baseline";
+  case zPeakFindingStage: return "Peak finding";
+  case zLimitFindingStage: return "Limit finding";
+  case zIntegrationStage: return "Integration";
+  case zCalibrationStage: return "Calibration";
+  case zPSDRegionStage: return "PSD region";
+  case zFillStage: return "Histogram fill";
+  default: return "Other";
+  }
+}
+
+
+string AAProcessingMetrics::GetSummary() const
+{
+  stringstream SS;
+  SS << fixed << setprecision(1)
+     << "Waveforms processed : " << GetWaveforms()
+     << " (" << GetWaveformRate() << " / s)\n"
+     << "Pulses processed    : " << GetPulses()
+     << " (" << GetPulseRate() << " / s)\n"
+     << "Data read           : " << GetBytes()/1.e6 << " MB in "
+     << setprecision(2) << GetElapsed() << " s\n";
+
+  for(Int_t s=0; s<zNumProcessingStages; s++)
+    SS << "  " << left << setw(18) << GetStageName(s) << right
+       << setprecision(3) << setw(10) << GetStageTime(s) << " s"
+       << setprecision(1) << setw(8) << GetStageShare(s)*100 << " %\n";
+
+  return SS.str();
+}
@@ -217,7 +217,7 @@ void AAProcessingSlots::HandleTextButtons()
     
     // Sequential processing
     if(TheInterface->ProcessingSeq_RB->IsDown())
-      ComputationMgr->CreateDesplicedFile();
+      TheInterface->StartProcessing(zDesplicingProcessingJob);
     
     // Parallel processing
     else{
@@ -0,0 +1,237 @@
+/////////////////////////////////////////////////////////////////////////////////
+//                                                                             //
+//                            Copyright (C) 2012-2023                          //
+//                  Zachary Seth Hartwig : All rights reserved                 //
+//                                                                             //
+//      The ADAQAnalysis source code is licensed under the GNU GPL v3.0.       //
+//      You have the right to modify and/or redistribute this source code      //
+//      under the terms specified in the license, which is found online        //
+//      at http://www.gnu.org/licenses or at $ADAQANALYSIS/License.txt.        //
+//                                                                             //
+/////////////////////////////////////////////////////////////////////////////////
+
+/////////////////////////////////////////////////////////////////////////////////
+//
+// name: AAPulseStore.cc
+// date: 18 Oct 26
+// auth: Zach Hartwig
+// mail: hartwig@psfc.mit.edu
+//
+// desc: The AAPulseStore class provides bounded-memory storage for
+//       the per-pulse values (pulse heights, areas, PSD integrals)
+//       that are computed during waveform processing and later
+//       histogrammed. Values are stored in fixed-size chunks at a
+//       selectable precision and may be spilled to disk.
+//
+/////////////////////////////////////////////////////////////////////////////////
+
+// C++
+#include <iostream>
+#include <algorithm>
+#include <cstring>
+#include <cmath>
+using namespace std;
+
+// ADAQAnalysis
+#include "AAPulseStore.hh"
+
+
+AAPulseStore::AAPulseStore()
+  : Precision(zPulseStoreDouble), SpillToDisk(false),
+    NumValues(0), ChunkSize(65536), CacheChunk(-1), SpillFile(NULL)
+{
+  OpenChunk.reserve(ChunkSize);
+}
+
+
+AAPulseStore::~AAPulseStore()
+{
+  if(SpillFile)
+    fclose(SpillFile);
+}
+
+
+void AAPulseStore::Initialize(Int_t P, Bool_t S)
+{
+  clear();
+  Precision = P;
+  SpillToDisk = S;
+}
+
+
+void AAPulseStore::clear()
+{
+  lock_guard<mutex> Lock(CacheMutex);
+  
+  NumValues = 0;
+  OpenChunk.clear();
+  Chunks.clear();
+  Cache.clear();
+  CacheChunk = -1;
+
+  // The temporary backing file is automatically removed upon closing
+  if(SpillFile){
+    fclose(SpillFile);
+    SpillFile = NULL;
+  }
+}
+
+
+void AAPulseStore::push_back(Double_t Value)
+{
+  OpenChunk.push_back(Value);
+  NumValues++;
+
+  if(OpenChunk.size() == ChunkSize)
+    SealChunk();
+}
+
+
+// Method to encode the full open chunk at the specified precision,
+// store it as a sealed chunk, and (optionally) spill it to disk
+void AAPulseStore::SealChunk()
+{
+  PulseChunk Chunk;
+  Chunk.Size = OpenChunk.size();
+  Chunk.Minimum = 0.;
+  Chunk.Step = 1.;
+  Chunk.Spilled = false;
+  Chunk.Offset = 0;
+
+  if(Precision == zPulseStoreDouble){
+    Chunk.Data.resize(Chunk.Size * sizeof(Double_t));
+    memcpy(&Chunk.Data[0], &OpenChunk[0], Chunk.Data.size());
+  }
+  else if(Precision == zPulseStoreFloat){
+    Chunk.Data.resize(Chunk.Size * sizeof(Float_t));
+    Float_t *Values = (Float_t *)&Chunk.Data[0];
+    for(size_t i=0; i<Chunk.Size; i++)
+      Values[i] = OpenChunk[i];
+  }
+  else if(Precision == zPulseStoreQuantized){
+
+    // Values are quantized into 16-bit unsigned integers spanning the
+    // range of values within the chunk
+    Double_t Min = *min_element(OpenChunk.begin(), OpenChunk.end());
+    Double_t Max = *max_element(OpenChunk.begin(), OpenChunk.end());
+
+    Chunk.Minimum = Min;
+    Chunk.Step = (Max > Min) ? (Max - Min) / 65535. : 1.;
+
+    Chunk.Data.resize(Chunk.Size * sizeof(UShort_t));
+    UShort_t *Values = (UShort_t *)&Chunk.Data[0];
+    for(size_t i=0; i<Chunk.Size; i++)
+      Values[i] = (UShort_t)floor((OpenChunk[i] - Min) / Chunk.Step + 0.5);
+  }
+
+  if(SpillToDisk){
+    if(!SpillFile)
+      SpillFile = tmpfile();
+
+    if(SpillFile){
+      fseek(SpillFile, 0, SEEK_END);
+      Chunk.Offset = ftell(SpillFile);
+
+      if(fwrite(&Chunk.Data[0], 1, Chunk.Data.size(), SpillFile) == Chunk.Data.size()){
+	Chunk.Spilled = true;
+	vector<char>().swap(Chunk.Data);
+      }
+      else
+	cout << "\nADAQAnalysis warning! Pulse values could not be spilled to disk and will be kept in memory!\n"
+	     << endl;
+    }
+  }
+
+  Chunks.push_back(Chunk);
+  OpenChunk.clear();
+}
+
+
+// Method to decode a sealed chunk into the read cache
+void AAPulseStore::LoadChunk(size_t C) const
+{
+  const PulseChunk &Chunk = Chunks[C];
+
+  const char *Data = NULL;
+  vector<char> Buffer;
+
+  if(Chunk.Spilled){
+    size_t Width = sizeof(Double_t);
+    if(Precision == zPulseStoreFloat)
+      Width = sizeof(Float_t);
+    else if(Precision == zPulseStoreQuantized)
+      Width = sizeof(UShort_t);
+
+    Buffer.resize(Chunk.Size * Width);
+    fseek(SpillFile, Chunk.Offset, SEEK_SET);
+    if(fread(&Buffer[0], 1, Buffer.size(), SpillFile) != Buffer.size())
+      cout << "\nADAQAnalysis warning! Pulse values could not be read back from disk!\n"
+	   << endl;
+    Data = &Buffer[0];
+  }
+  else
+    Data = &Chunk.Data[0];
+
+  Cache.resize(Chunk.Size);
+
+  if(Precision == zPulseStoreDouble)
+    memcpy(&Cache[0], Data, Chunk.Size * sizeof(Double_t));
+
+  else if(Precision == zPulseStoreFloat){
+    const Float_t *Values = (const Float_t *)Data;
+    for(size_t i=0; i<Chunk.Size; i++)
+      Cache[i] = Values[i];
+  }
+  else if(Precision == zPulseStoreQuantized){
+    const UShort_t *Values = (const UShort_t *)Data;
+    for(size_t i=0; i<Chunk.Size; i++)
+      Cache[i] = Chunk.Minimum + Values[i] * Chunk.Step;
+  }
+
+  CacheChunk = C;
+}
+
+
+Double_t AAPulseStore::At(size_t Index) const
+{
+  lock_guard<mutex> Lock(CacheMutex);
+  return AtLocked(Index);
+}
+
+
+Double_t AAPulseStore::AtLocked(size_t Index) const
+{
+  size_t C = Index / ChunkSize;
+
+  // Values in the open chunk are accessed directly
+  if(C == Chunks.size())
+    return OpenChunk[Index - C*ChunkSize];
+
+  if((Int_t)C != CacheChunk)
+    LoadChunk(C);
+
+  return Cache[Index - C*ChunkSize];
+}
+
+
+// Copy all stored values into a contiguous array, which must have
+// been allocated with at least size() elements by the caller
+void AAPulseStore::CopyTo(Double_t *Values) const
+{
+  lock_guard<mutex> Lock(CacheMutex);
+  
+  for(size_t i=0; i<NumValues; i++)
+    Values[i] = AtLocked(i);
+}
+
+
+size_t AAPulseStore::GetMemoryUsage()
+{
+  size_t Bytes = (OpenChunk.capacity() + Cache.capacity()) * sizeof(Double_t);
+
+  vector<PulseChunk>::iterator It;
+  for(It=Chunks.begin(); It!=Chunks.end(); It++)
+    Bytes += (*It).Data.capacity();
+
+  return Bytes;
+}
@@ -0,0 +1,280 @@
+/////////////////////////////////////////////////////////////////////////////////
+//                                                                             //
+//                            Copyright (C) 2012-2023                          //
+//                  Zachary Seth Hartwig : All rights reserved                 //
+//                                                                             //
+//      The ADAQAnalysis source code is licensed under the GNU GPL v3.0.       //
+//      You have the right to modify and/or redistribute this source code      //
+//      under the terms specified in the license, which is found online        //
+//      at http://www.gnu.org/licenses or at $ADAQANALYSIS/License.txt.        //
+//                                                                             //
+/////////////////////////////////////////////////////////////////////////////////
+
+/////////////////////////////////////////////////////////////////////////////////
+//
+// name: AASpectrumBackground.cc
+// date: 18 Oct 26
+// auth: Zach Hartwig
+// mail: hartwig@psfc.mit.edu
+//
+// desc: The AASpectrumBackground class is a native implementation of
+//       the SNIP clipping algorithm used to estimate spectrum
+//       backgrounds with caching of the intermediate clipping passes.
+//
+/////////////////////////////////////////////////////////////////////////////////
+
+// C++
+#include <algorithm>
+#include <cmath>
+using namespace std;
+
+// ADAQAnalysis
+#include "AASpectrumBackground.hh"
+
+
+AASpectrumBackground::AASpectrumBackground()
+  : Direction(1), FilterOrder(2), SmoothingWidth(3), Smoothing(false),
+    Passes(0), CheckpointInterval(10), DecreasingIterations(-1)
+{;}
+
+
+AASpectrumBackground::~AASpectrumBackground()
+{;}
+
+
+void AASpectrumBackground::Reset()
+{
+  Clipped = Source;
+  Passes = 0;
+  Checkpoints.clear();
+
+  DecreasingResult.clear();
+  DecreasingIterations = -1;
+}
+
+
+void AASpectrumBackground::SetSpectrum(const Double_t *Contents, Int_t NumBins)
+{
+  if((Int_t)Source.size() == NumBins and
+     equal(Source.begin(), Source.end(), Contents))
+    return;
+
+  Source.assign(Contents, Contents+NumBins);
+  Reset();
+}
+
+
+void AASpectrumBackground::SetOptions(Int_t D, Int_t FO, Bool_t S, Int_t SW)
+{
+  if(D == Direction and FO == FilterOrder and S == Smoothing and SW == SmoothingWidth)
+    return;
+
+  Direction = D;
+  FilterOrder = FO;
+  Smoothing = S;
+  SmoothingWidth = SW;
+  Reset();
+}
+
+
+const vector<Double_t> &AASpectrumBackground::Calculate(Int_t Iterations, Bool_t Compton)
+{
+  if(Iterations < 1)
+    Iterations = 1;
+
+  // As with TSpectrum, a clipping window wider than the spectrum
+  // leaves the spectrum unmodified (and without Compton estimation)
+  if((Int_t)Source.size() < 2*Iterations+1){
+    Result = Source;
+    return Result;
+  }
+
+  // Increasing window: continue from the most recent state if
+  // possible, otherwise resume from the nearest prior checkpoint
+  if(Direction == 0){
+
+    if(Iterations < Passes){
+      Int_t C = Iterations / CheckpointInterval;
+      if(C > 0){
+	Clipped = Checkpoints[C-1];
+	Passes = C * CheckpointInterval;
+      }
+      else{
+	Clipped = Source;
+	Passes = 0;
+      }
+    }
+
+    while(Passes < Iterations){
+      Passes++;
+      ClipPass(Clipped, Work, Passes);
+      Clipped.swap(Work);
+
+      if(Passes % CheckpointInterval == 0 and
+	 (Int_t)Checkpoints.size() < Passes / CheckpointInterval)
+	Checkpoints.push_back(Clipped);
+    }
+    Result = Clipped;
+  }
+
+  // Decreasing window: passes run from the largest window to one
+  else{
+    if(Iterations != DecreasingIterations){
+      DecreasingResult = Source;
+      for(Int_t i=Iterations; i>=1; i--){
+	ClipPass(DecreasingResult, Work, i);
+	DecreasingResult.swap(Work);
+      }
+      DecreasingIterations = Iterations;
+    }
+    Result = DecreasingResult;
+  }
+
+  if(Compton)
+    EstimateCompton(Result);
+
+  return Result;
+}
+
+
+// Method to perform a single clipping pass with the specified window
+// (half-width in bins). Each bin is replaced by the minimum of its
+// value and the filter estimate formed from its neighbors. With
+// smoothing the estimate is formed from window averages and, as in
+// TSpectrum, a bin that is not clipped takes its averaged value
+void AASpectrumBackground::ClipPass(const vector<Double_t> &In, vector<Double_t> &Out, Int_t Window)
+{
+  const Int_t N = In.size();
+  Out = In;
+
+  const Double_t *V = &In[0];
+  if(Smoothing){
+    ComputeAverages(In);
+    V = &Average[0];
+  }
+
+  if(N < 2*Window+1)
+    return;
+
+  const Int_t A2 = Window / 2;
+  const Int_t A3 = Window / 3;
+  const Int_t A4 = Window / 4;
+
+  for(Int_t j=Window; j<N-Window; j++){
+
+    Double_t a = In[j];
+    Double_t b = (V[j-Window] + V[j+Window]) / 2.;
+
+    if(FilterOrder >= 4){
+      Double_t c = (-V[j-2*A2] + 4*V[j-A2] + 4*V[j+A2] - V[j+2*A2]) / 6.;
+      if(b < c)
+	b = c;
+    }
+
+    if(FilterOrder >= 6){
+      Double_t d = (V[j-3*A3] - 6*V[j-2*A3] + 15*V[j-A3] +
+		    15*V[j+A3] - 6*V[j+2*A3] + V[j+3*A3]) / 20.;
+      if(b < d)
+	b = d;
+    }
+
+    if(FilterOrder >= 8){
+      Double_t e = (-V[j-4*A4] + 8*V[j-3*A4] - 28*V[j-2*A4] + 56*V[j-A4] +
+		    56*V[j+A4] - 28*V[j+2*A4] + 8*V[j+3*A4] - V[j+4*A4]) / 70.;
+      if(b < e)
+	b = e;
+    }
+
+    Out[j] = (b < a) ? b : V[j];
+  }
+}
+
+
+// Method to compute the average of each bin over the smoothing
+// window (truncated at the spectrum edges) using a running sum such
+// that the cost is independent of the smoothing width
+void AASpectrumBackground::ComputeAverages(const vector<Double_t> &In)
+{
+  const Int_t N = In.size();
+  const Int_t HalfWidth = (SmoothingWidth - 1) / 2;
+
+  RunningSum.resize(N+1);
+  RunningSum[0] = 0.;
+  for(Int_t j=0; j<N; j++)
+    RunningSum[j+1] = RunningSum[j] + In[j];
+
+  Average.resize(N);
+  for(Int_t j=0; j<N; j++){
+    Int_t Low = max(0, j-HalfWidth);
+    Int_t High = min(N-1, j+HalfWidth);
+    Average[j] = (RunningSum[High+1] - RunningSum[Low]) / (High - Low + 1);
+  }
+}
+
+
+// Method to estimate the background beneath peaks that sit on a
+// Compton edge, ported from TSpectrum::Background(). Each region in
+// which the clipped background differs from the spectrum by at least
+// one count is bounded by the bins on either side; the background
+// across the region is replaced by a ramp from the lower to the
+// higher boundary level in proportion to the cumulative spectrum
+// content above the lower level. The clipped background is read
+// while the estimate is written such that regions do not interact
+void AASpectrumBackground::EstimateCompton(vector<Double_t> &Background)
+{
+  const Int_t N = Background.size();
+  const vector<Double_t> Clipped(Background);
+
+  for(Int_t i=0; i<N; i++){
+
+    if(fabs(Clipped[i] - Source[i]) < 1.)
+      continue;
+
+    // The region begins at the bin preceding the first differing bin
+    // and ends one bin beyond the first bin that agrees again
+    Int_t b1 = max(0, i-1);
+    Int_t b2 = b1 + 1;
+    Bool_t Found = false;
+    while(!Found and b2 < N){
+      if(fabs(Clipped[b2] - Source[b2]) < 1.)
+	Found = true;
+      b2++;
+    }
+    if(b2 == N)
+      b2 -= 1;
+
+    Double_t yb1 = Clipped[b1];
+    Double_t yb2 = Clipped[b2];
+
+    if(yb1 <= yb2){
+      Double_t Area = 0.;
+      for(Int_t j=b1; j<=b2; j++)
+	Area += Source[j] - yb1;
+
+      if(Area > 1){
+	Double_t Slope = (yb2 - yb1) / Area;
+	Double_t Cumulative = 0.;
+	for(Int_t j=b1; j<=b2; j++){
+	  Cumulative += Source[j] - yb1;
+	  Background[j] = Slope * Cumulative + yb1;
+	}
+      }
+    }
+    else{
+      Double_t Area = 0.;
+      for(Int_t j=b2; j>=b1; j--)
+	Area += Source[j] - yb2;
+
+      if(Area > 1){
+	Double_t Slope = (yb1 - yb2) / Area;
+	Double_t Cumulative = 0.;
+	for(Int_t j=b2; j>=b1; j--){
+	  Cumulative += Source[j] - yb2;
+	  Background[j] = Slope * Cumulative + yb2;
+	}
+      }
+    }
+
+    i = b2;
+  }
+}
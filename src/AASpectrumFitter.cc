@@ -0,0 +1,415 @@
+/////////////////////////////////////////////////////////////////////////////////
+//                                                                             //
+//                            Copyright (C) 2012-2023                          //
+//                  Zachary Seth Hartwig : All rights reserved                 //
+//                                                                             //
+//      The ADAQAnalysis source code is licensed under the GNU GPL v3.0.       //
+//      You have the right to modify and/or redistribute this source code      //
+//      under the terms specified in the license, which is found online        //
+//      at http://www.gnu.org/licenses or at $ADAQANALYSIS/License.txt.        //
+//                                                                             //
+/////////////////////////////////////////////////////////////////////////////////
+
+/////////////////////////////////////////////////////////////////////////////////
+//
+// name: AASpectrumFitter.cc
+// date: 18 Oct 26
+// auth: Zach Hartwig
+// mail: hartwig@psfc.mit.edu
+//
+// desc: The AASpectrumFitter class performs least-squares fits of one
+//       or more Gaussian peaks plus an optional linear or step
+//       background to a region of a spectrum.
+//
+/////////////////////////////////////////////////////////////////////////////////
+
+// C++
+#include <cmath>
+#include <algorithm>
+using namespace std;
+
+// ADAQAnalysis
+#include "AASpectrumFitter.hh"
+
+
+AASpectrumFitter::AASpectrumFitter()
+  : MaxIterations(200), IntegralInCounts(true), XCenter(0.),
+    NumPeaks(1), Background(zLinearFitBackground),
+    NumBackgroundPars(2), NumPeakPars(3), NumPars(5)
+{;}
+
+
+AASpectrumFitter::~AASpectrumFitter()
+{;}
+
+
+// Method to set the initial parameter values. The fit window is
+// divided into equal regions, one per peak, and each peak is
+// initialized to the maximum within its region. The background is
+// initialized to the line connecting the window endpoints
+void AASpectrumFitter::Initialize(const SpectrumFitWindowStruct &Window)
+{
+  NumPeaks = (Window.NumPeaks > 0) ? Window.NumPeaks : 1;
+  Background = Window.Background;
+
+  NumBackgroundPars = (Background == zNoFitBackground) ? 0 : 2;
+  NumPeakPars = (Background == zStepFitBackground) ? 4 : 3;
+  NumPars = NumBackgroundPars + NumPeaks*NumPeakPars;
+
+  Pars.assign(NumPars, 0.);
+
+  const Int_t N = X.size();
+
+  Double_t Slope = 0., Offset = 0.;
+  if(NumBackgroundPars > 0 and N > 1){
+    Slope = (Y[N-1] - Y[0]) / (X[N-1] - X[0]);
+    Offset = Y[0] + Slope * (XCenter - X[0]);
+    Pars[0] = Offset;
+    Pars[1] = Slope;
+  }
+
+  Double_t Width = (Window.Max - Window.Min) / NumPeaks;
+
+  for(Int_t p=0; p<NumPeaks; p++){
+    Double_t Low = Window.Min + p*Width;
+    Double_t High = Low + Width;
+
+    Double_t MaxY = 0., MaxX = 0.5*(Low+High);
+    for(Int_t i=0; i<N; i++){
+      if(X[i] < Low or X[i] >= High)
+	continue;
+      Double_t Net = Y[i] - (Offset + Slope * (X[i] - XCenter));
+      if(Net > MaxY){
+	MaxY = Net;
+	MaxX = X[i];
+      }
+    }
+
+    Int_t Index = NumBackgroundPars + p*NumPeakPars;
+    Pars[Index] = MaxY;
+    Pars[Index+1] = MaxX;
+    Pars[Index+2] = Width / 6.;
+  }
+
+  // Override the default seeds with those explicitly provided, taking
+  // the constant as the net content of the bin nearest each mean
+  if((Int_t)SeedMeans.size() != NumPeaks or (Int_t)SeedSigmas.size() != NumPeaks)
+    return;
+
+  for(Int_t p=0; p<NumPeaks; p++){
+    Int_t Nearest = -1;
+    for(Int_t i=0; i<N; i++)
+      if(Nearest < 0 or fabs(X[i] - SeedMeans[p]) < fabs(X[Nearest] - SeedMeans[p]))
+	Nearest = i;
+
+    Int_t Index = NumBackgroundPars + p*NumPeakPars;
+    if(Nearest >= 0)
+      Pars[Index] = Y[Nearest] - (Offset + Slope * (X[Nearest] - XCenter));
+    Pars[Index+1] = SeedMeans[p];
+    Pars[Index+2] = SeedSigmas[p];
+  }
+}
+
+
+// Method to evaluate the model at X and (optionally) the derivative
+// of the model with respect to each parameter
+Double_t AASpectrumFitter::Evaluate(Double_t XValue, const vector<Double_t> &P, vector<Double_t> *Gradient)
+{
+  const Double_t InvSqrt2Pi = 1. / sqrt(2*M_PI);
+
+  Double_t Value = 0.;
+
+  if(NumBackgroundPars > 0){
+    Value += P[0] + P[1] * (XValue - XCenter);
+    if(Gradient){
+      (*Gradient)[0] = 1.;
+      (*Gradient)[1] = XValue - XCenter;
+    }
+  }
+
+  for(Int_t p=0; p<NumPeaks; p++){
+    Int_t Index = NumBackgroundPars + p*NumPeakPars;
+
+    Double_t Const = P[Index];
+    Double_t Mean = P[Index+1];
+    Double_t Sigma = P[Index+2];
+
+    Double_t U = (XValue - Mean) / Sigma;
+    Double_t G = exp(-0.5*U*U);
+
+    Value += Const * G;
+
+    if(Gradient){
+      (*Gradient)[Index] = G;
+      (*Gradient)[Index+1] = Const * G * U / Sigma;
+      (*Gradient)[Index+2] = Const * G * U * U / Sigma;
+    }
+
+    // The step background is the complementary error function
+    // centered on the peak with the peak width
+    if(NumPeakPars == 4){
+      Double_t Height = P[Index+3];
+      Double_t Step = 0.5 * erfc(U / sqrt(2.));
+
+      Value += Height * Step;
+
+      if(Gradient){
+	(*Gradient)[Index+1] += Height * G * InvSqrt2Pi / Sigma;
+	(*Gradient)[Index+2] += Height * G * U * InvSqrt2Pi / Sigma;
+	(*Gradient)[Index+3] = Step;
+      }
+    }
+  }
+
+  return Value;
+}
+
+
+Double_t AASpectrumFitter::ChiSquare(const vector<Double_t> &P)
+{
+  Double_t Chi2 = 0.;
+  for(size_t i=0; i<X.size(); i++){
+    Double_t R = Y[i] - Evaluate(X[i], P, NULL);
+    Chi2 += W[i] * R * R;
+  }
+  return Chi2;
+}
+
+
+// Method to invert a symmetric positive definite matrix in place
+// using Gauss-Jordan elimination with partial pivoting
+Bool_t AASpectrumFitter::Invert(vector<Double_t> &A, Int_t N)
+{
+  vector<Double_t> Inv(N*N, 0.);
+  for(Int_t i=0; i<N; i++)
+    Inv[i*N+i] = 1.;
+
+  for(Int_t c=0; c<N; c++){
+
+    Int_t Pivot = c;
+    for(Int_t r=c+1; r<N; r++)
+      if(fabs(A[r*N+c]) > fabs(A[Pivot*N+c]))
+	Pivot = r;
+
+    if(A[Pivot*N+c] == 0.)
+      return false;
+
+    if(Pivot != c){
+      for(Int_t k=0; k<N; k++){
+	swap(A[c*N+k], A[Pivot*N+k]);
+	swap(Inv[c*N+k], Inv[Pivot*N+k]);
+      }
+    }
+
+    Double_t D = A[c*N+c];
+    for(Int_t k=0; k<N; k++){
+      A[c*N+k] /= D;
+      Inv[c*N+k] /= D;
+    }
+
+    for(Int_t r=0; r<N; r++){
+      if(r == c)
+	continue;
+      Double_t F = A[r*N+c];
+      if(F == 0.)
+	continue;
+      for(Int_t k=0; k<N; k++){
+	A[r*N+k] -= F * A[c*N+k];
+	Inv[r*N+k] -= F * Inv[c*N+k];
+      }
+    }
+  }
+
+  A.swap(Inv);
+  return true;
+}
+
+
+// Method to solve the (damped) normal equations A * Delta = B
+Bool_t AASpectrumFitter::Solve(vector<Double_t> &A, vector<Double_t> &B, Int_t N)
+{
+  if(!Invert(A, N))
+    return false;
+
+  vector<Double_t> Delta(N, 0.);
+  for(Int_t i=0; i<N; i++)
+    for(Int_t j=0; j<N; j++)
+      Delta[i] += A[i*N+j] * B[j];
+
+  B.swap(Delta);
+  return true;
+}
+
+
+vector<SpectrumFitResultStruct> AASpectrumFitter::Fit(const vector<Double_t> &BinCenters,
+						      const vector<Double_t> &BinContents,
+						      Double_t BinWidth,
+						      const SpectrumFitWindowStruct &Window)
+{
+  vector<SpectrumFitResultStruct> Results;
+
+  // Extract the nonempty bins within the fit window
+
+  X.clear();
+  Y.clear();
+  W.clear();
+
+  for(size_t i=0; i<BinCenters.size(); i++){
+    if(BinCenters[i] < Window.Min or BinCenters[i] > Window.Max)
+      continue;
+    if(BinContents[i] <= 0.)
+      continue;
+    X.push_back(BinCenters[i]);
+    Y.push_back(BinContents[i]);
+    W.push_back(1. / BinContents[i]);
+  }
+
+  XCenter = 0.5 * (Window.Min + Window.Max);
+
+  Initialize(Window);
+
+  const Int_t N = NumPars;
+
+  if((Int_t)X.size() <= N)
+    return Results;
+
+  ///////////////////////////////
+  // Levenberg-Marquardt iteration
+
+  Double_t Lambda = 1.e-3;
+  Double_t Chi2 = ChiSquare(Pars);
+  Bool_t Converged = false;
+
+  vector<Double_t> Gradient(N, 0.);
+  vector<Double_t> Alpha(N*N), Beta(N), A(N*N), Trial(N);
+
+  for(Int_t Iteration=0; Iteration<MaxIterations; Iteration++){
+
+    fill(Alpha.begin(), Alpha.end(), 0.);
+    fill(Beta.begin(), Beta.end(), 0.);
+
+    for(size_t i=0; i<X.size(); i++){
+      Double_t R = Y[i] - Evaluate(X[i], Pars, &Gradient);
+      for(Int_t j=0; j<N; j++){
+	Beta[j] += W[i] * R * Gradient[j];
+	for(Int_t k=0; k<=j; k++)
+	  Alpha[j*N+k] += W[i] * Gradient[j] * Gradient[k];
+      }
+    }
+    for(Int_t j=0; j<N; j++)
+      for(Int_t k=j+1; k<N; k++)
+	Alpha[j*N+k] = Alpha[k*N+j];
+
+    Bool_t Improved = false;
+
+    while(Lambda < 1.e10){
+      A = Alpha;
+      for(Int_t j=0; j<N; j++)
+	A[j*N+j] *= (1. + Lambda);
+
+      vector<Double_t> Delta = Beta;
+      if(!Solve(A, Delta, N)){
+	Lambda *= 10.;
+	continue;
+      }
+
+      for(Int_t j=0; j<N; j++)
+	Trial[j] = Pars[j] + Delta[j];
+
+      Double_t TrialChi2 = ChiSquare(Trial);
+
+      if(TrialChi2 <= Chi2){
+	Improved = (Chi2 - TrialChi2) > 1.e-6 * (Chi2 + 1.e-12);
+	Pars = Trial;
+	Chi2 = TrialChi2;
+	Lambda = max(Lambda / 10., 1.e-12);
+	break;
+      }
+      Lambda *= 10.;
+    }
+
+    if(!Improved){
+      Converged = (Lambda < 1.e10);
+      break;
+    }
+  }
+
+  ////////////////////////////////////////
+  // Covariance matrix and fit results
+
+  fill(Alpha.begin(), Alpha.end(), 0.);
+  for(size_t i=0; i<X.size(); i++){
+    Evaluate(X[i], Pars, &Gradient);
+    for(Int_t j=0; j<N; j++)
+      for(Int_t k=0; k<N; k++)
+	Alpha[j*N+k] += W[i] * Gradient[j] * Gradient[k];
+  }
+
+  vector<Double_t> Covariance = Alpha;
+  if(!Invert(Covariance, N))
+    Converged = false;
+
+  for(Int_t p=0; p<NumPeaks; p++){
+    Int_t Index = NumBackgroundPars + p*NumPeakPars;
+
+    SpectrumFitResultStruct Result;
+    Result.WindowMin = Window.Min;
+    Result.WindowMax = Window.Max;
+    Result.Peak = p;
+    Result.NumPeaks = NumPeaks;
+    Result.BinWidth = BinWidth;
+
+    Result.Const = Pars[Index];
+    Result.Mean = Pars[Index+1];
+    Result.Sigma = fabs(Pars[Index+2]);
+
+    // The sign of the sigma parameter is arbitrary in the Gaussian;
+    // the covariances are transformed to correspond to |sigma|
+    Double_t Sign[3] = {1., 1., (Pars[Index+2] < 0.) ? -1. : 1.};
+    
+    for(Int_t i=0; i<3; i++)
+      for(Int_t j=0; j<3; j++)
+	Result.Cov[i][j] = Sign[i] * Sign[j] * Covariance[(Index+i)*N + (Index+j)];
+
+    Result.ConstErr = sqrt(fabs(Result.Cov[0][0]));
+    Result.MeanErr = sqrt(fabs(Result.Cov[1][1]));
+    Result.SigmaErr = sqrt(fabs(Result.Cov[2][2]));
+
+    Double_t Errors[3] = {Result.ConstErr, Result.MeanErr, Result.SigmaErr};
+    for(Int_t i=0; i<3; i++)
+      for(Int_t j=0; j<3; j++)
+	Result.Cor[i][j] = (Errors[i] > 0. and Errors[j] > 0.) ? Result.Cov[i][j] / (Errors[i]*Errors[j]) : 0.;
+
+    Result.Res = 2.35 * Result.Sigma / Result.Mean * 100;
+    Result.ResErr = Result.Res * sqrt(pow(Result.SigmaErr/Result.Sigma,2) + pow(Result.MeanErr/Result.Mean,2));
+
+    Result.CovConstSigma = Result.Cov[2][0];
+
+    // Integral of the Gaussian and its error, computed as in
+    // AAComputation::FitSpectrum(): the Gaussian is summed at the
+    // centers of the bins spanning the fit window (multiplied by the
+    // bin width unless the integral is in counts) while the error is
+    // that of the analytic integral in counts
+    Result.Integral = 0.;
+    for(size_t i=0; i<BinCenters.size(); i++){
+      if(BinCenters[i] + 0.5*BinWidth <= Window.Min or BinCenters[i] - 0.5*BinWidth > Window.Max)
+	continue;
+      Double_t U = (BinCenters[i] - Result.Mean) / Result.Sigma;
+      Result.Integral += Result.Const * exp(-0.5*U*U);
+    }
+    if(!IntegralInCounts)
+      Result.Integral *= BinWidth;
+    
+    Result.IntegralErr = sqrt(2*M_PI) * sqrt(pow(Result.Sigma*Result.ConstErr,2) +
+					     pow(Result.Const*Result.SigmaErr,2) +
+					     2*Result.Sigma*Result.Const*Result.CovConstSigma) / BinWidth;
+
+    Result.ChiSquare = Chi2;
+    Result.NDF = X.size() - N;
+    Result.Converged = Converged;
+
+    Results.push_back(Result);
+  }
+
+  return Results;
+}
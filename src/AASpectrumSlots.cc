@@ -87,9 +87,8 @@ void AASpectrumSlots::HandleComboBoxes(int ComboBoxID, int SelectedID)
 
   case ASIMEventTree_CB_ID:{
     
-    TList *ASIMEventTreeList = ComputationMgr->GetASIMEventTreeList();
-    TString EventTreeName = TheInterface->ASIMEventTree_CB->GetSelectedEntry()->GetTitle();
-    TTree *EventTree = (TTree *)ASIMEventTreeList->FindObject(EventTreeName);
+    string EventTreeName = TheInterface->ASIMEventTree_CB->GetSelectedEntry()->GetTitle();
+    TTree *EventTree = ComputationMgr->GetASIMEventTree(EventTreeName);
     if(EventTree == NULL)
       return;
     
@@ -307,8 +306,12 @@ void AASpectrumSlots::HandleTextButtons()
     // Sequential waveform processing
     if(TheInterface->ProcessingSeq_RB->IsDown()){
       
-      if(TheInterface->ADAQFileLoaded)
-	ComputationMgr->ProcessSpectrumWaveforms();
+      // The waveforms are processed in the background thread; the
+      // spectrum is plotted once the job has finished
+      if(TheInterface->ADAQFileLoaded){
+	TheInterface->StartProcessing(zSpectrumProcessingJob);
+	break;
+      }
 
       if(ComputationMgr->GetSpectrumExists())
 	GraphicsMgr->PlotSpectrum();
@@ -337,6 +340,29 @@ void AASpectrumSlots::HandleTextButtons()
     
     break;
   }
+
+  case CreateASIMSpectra_TB_ID:{
+
+    // Create a spectrum for each event tree selected in the list box,
+    // or for every event tree in the ASIM file(s) if none are
+    // selected, using the present spectrum binning and calibration
+    TList Selected;
+    TheInterface->ASIMEventTrees_LB->GetSelectedEntries(&Selected);
+    
+    vector<string> Names;
+    TIter Next(&Selected);
+    while(TGTextLBEntry *Entry = (TGTextLBEntry *)Next())
+      Names.push_back(Entry->GetText()->GetString());
+    
+    vector<TH1F *> Spectra = ComputationMgr->CreateASIMSpectra(Names);
+
+    if(Spectra.empty())
+      TheInterface->CreateMessageBox("No ASIM event trees could be histogrammed!","Stop");
+    else
+      GraphicsMgr->PlotASIMSpectra();
+    
+    break;
+  }
     
     // This slot handles creating a pulse spectrum by using previously
     // computed values from analyzed waveforms
@@ -542,5 +568,138 @@ void AASpectrumSlots::HandleTextButtons()
     }
     break;
   }
+
+  case GainDriftCompute_TB_ID:{
+
+    // Assemble the gain references from the widgets; references with
+    // type "None" or an empty window are ignored
+    vector<GainReferenceStruct> References;
+    for(int r=0; r<TheInterface->NumGainDriftRefs; r++){
+      int Type = TheInterface->GainDriftRefType_CBL[r]->GetComboBox()->GetSelected();
+      
+      GainReferenceStruct Reference;
+      Reference.Min = TheInterface->GainDriftRefMin_NEL[r]->GetEntry()->GetNumber();
+      Reference.Max = TheInterface->GainDriftRefMax_NEL[r]->GetEntry()->GetNumber();
+      Reference.Edge = (Type == 2);
+
+      if(Type != 0 and Reference.Min != Reference.Max)
+	References.push_back(Reference);
+    }
+
+    if(References.empty()){
+      TheInterface->CreateMessageBox("At least one gain reference window must be specified!","Stop");
+      break;
+    }
+
+    if(ComputationMgr->GetSpectrumPreviewOrder()){
+      TheInterface->CreateMessageBox("A gain drift correction requires the spectrum to be created sequentially rather than as a preview!","Stop");
+      break;
+    }
+    
+    int NumSlices = TheInterface->GainDriftSlices_NEL->GetEntry()->GetIntNumber();
+    
+    bool Success = ComputationMgr->CreateGainDriftCorrection(References, NumSlices);
+    
+    if(Success){
+      TheInterface->GainDriftApply_CB->SetState(kButtonDown);
+      TheInterface->GainDriftSave_TB->SetState(kButtonUp);
+
+      // Recreate the spectrum with the correction applied
+      TheInterface->SaveSettings();
+      ComputationMgr->CreateSpectrum();
+      if(ComputationMgr->GetSpectrumExists())
+	GraphicsMgr->PlotSpectrum();
+      TheInterface->UpdateForSpectrumCreation();
+    }
+    else{
+      TheInterface->GainDriftApply_CB->SetState(kButtonUp);
+      TheInterface->GainDriftApply_CB->SetState(kButtonDisabled);
+      TheInterface->GainDriftSave_TB->SetState(kButtonDisabled);
+      TheInterface->CreateMessageBox("The gain references could not be located! Please check the reference windows.","Stop");
+    }
+    break;
+  }
+
+  case GainDriftSave_TB_ID:{
+
+    const char *FileTypes[] = {"ASCII file", "*.dat",
+			       "All files",  "*.*",
+			       0, 0};
+    
+    TGFileInfo FileInformation;
+    FileInformation.fFileTypes = FileTypes;
+    FileInformation.fIniDir = StrDup(getenv("PWD"));
+
+    new TGFileDialog(gClient->GetRoot(), TheInterface, kFDSave, &FileInformation);
+
+    if(FileInformation.fFilename == NULL)
+      TheInterface->CreateMessageBox("No file was selected! The gain drift correction table was not saved!","Stop");
+    else{
+      string FileName = FileInformation.fFilename;
+      if(FileName.find(".") == string::npos)
+	FileName += ".dat";
+      
+      if(!ComputationMgr->WriteGainDriftCorrectionFile(FileName))
+	TheInterface->CreateMessageBox("The gain drift correction table could not be written!","Stop");
+    }
+    break;
+  }
+
+  case SettingsSweep_TB_ID:{
+
+    if(!TheInterface->ADAQFileLoaded){
+      TheInterface->CreateMessageBox("Settings sweeps can only be run on ADAQ files!","Stop");
+      break;
+    }
+
+    if(!TheInterface->ProcessingSeq_RB->IsDown() or TheInterface->ADAQSpectrumAlgorithmWD_RB->IsDown()){
+      TheInterface->CreateMessageBox("Settings sweeps require sequential processing of the waveforms!","Stop");
+      break;
+    }
+    
+    // Each variant begins from the present extraction parameters
+    SettingsVariantStruct Present;
+    Present.Floor = TheInterface->Floor_NEL->GetEntry()->GetIntNumber();
+    Present.Sigma = TheInterface->Sigma_NEL->GetEntry()->GetIntNumber();
+    Present.Resolution = TheInterface->Resolution_NEL->GetEntry()->GetNumber();
+    Present.BaselineRegionMin = TheInterface->BaselineRegionMin_NEL->GetEntry()->GetIntNumber();
+    Present.BaselineRegionMax = TheInterface->BaselineRegionMax_NEL->GetEntry()->GetIntNumber();
+    Present.AnalysisRegionMin = TheInterface->AnalysisRegionMin_NEL->GetEntry()->GetIntNumber();
+    Present.AnalysisRegionMax = TheInterface->AnalysisRegionMax_NEL->GetEntry()->GetIntNumber();
+
+    int Parameter = TheInterface->SettingsSweepParameter_CBL->GetComboBox()->GetSelected();
+    double Min = TheInterface->SettingsSweepMin_NEL->GetEntry()->GetNumber();
+    double Max = TheInterface->SettingsSweepMax_NEL->GetEntry()->GetNumber();
+    int Steps = TheInterface->SettingsSweepSteps_NEL->GetEntry()->GetIntNumber();
+
+    vector<SettingsVariantStruct> Variants;
+    for(int i=0; i<Steps; i++){
+      double Value = (Steps == 1) ? Min : Min + i*(Max - Min)/(Steps-1);
+      
+      SettingsVariantStruct Variant = Present;
+      if(Parameter == 0)
+	Variant.Floor = (int)Value;
+      else if(Parameter == 1)
+	Variant.Sigma = (int)Value;
+      else if(Parameter == 2)
+	Variant.Resolution = Value;
+      else if(Parameter == 3)
+	Variant.BaselineRegionMin = (int)Value;
+      else if(Parameter == 4)
+	Variant.BaselineRegionMax = (int)Value;
+      else if(Parameter == 5)
+	Variant.AnalysisRegionMin = (int)Value;
+      else if(Parameter == 6)
+	Variant.AnalysisRegionMax = (int)Value;
+      Variants.push_back(Variant);
+    }
+
+    // The sweep runs in the background thread; the results are
+    // reported by AAInterface::UpdateForSettingsSweep()
+    ComputationMgr->SetSettingsSweep(Variants);
+    TheInterface->StartProcessing(zSettingsSweepJob);
+    
+    break;
+  }
   }
 }
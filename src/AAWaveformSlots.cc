@@ -67,6 +67,11 @@ void AAWaveformSlots::HandleCheckButtons()
     GraphicsMgr->PlotWaveform();
     break;
 
+  case UsePSDRejection_CB_ID:
+    if(TheInterface->UsePSDRejection_CB->IsDown())
+      ComputationMgr->BuildWaveformIndex();
+    break;
+
   case PlotFloor_CB_ID:
   case PlotCrossings_CB_ID:
   case PlotPeakIntegratingRegion_CB_ID:
@@ -121,14 +126,32 @@ void AAWaveformSlots::HandleNumberEntries()
     Int_t Waveform = TheInterface->WaveformSelector_NEL->GetEntry()->GetIntNumber();
     
     if(TheInterface->UsePSDRejection_CB->IsDown()){
-      while(ComputationMgr->RejectPSD(Channel, Waveform)){
-	Waveform++;
+
+      // Use the waveform summary index to jump directly to the next
+      // waveform that passes the PSD region if the index is valid
+      // for the present settings; otherwise, (re)start building the
+      // index and test each waveform in turn until it is available
+      
+      if(ComputationMgr->GetWaveformIndexValid()){
+	Waveform = ComputationMgr->FindNextPSDWaveform(Waveform);
+	if(Waveform < 0)
+	  Waveform = 0;
+	
 	TheInterface->WaveformSelector_NEL->GetEntry()->SetIntNumber(Waveform);
 	TheInterface->WaveformSelector_HS->SetPosition(Waveform);
-	if(Waveform == TheInterface->Waveforms_NEL->GetNumber()-1){
-	  TheInterface->WaveformSelector_NEL->GetEntry()->SetIntNumber(0);
-	  TheInterface->WaveformSelector_HS->SetPosition(0);
-	  break;
+      }
+      else{
+	ComputationMgr->BuildWaveformIndex();
+	
+	while(ComputationMgr->RejectPSD(Channel, Waveform)){
+	  Waveform++;
+	  TheInterface->WaveformSelector_NEL->GetEntry()->SetIntNumber(Waveform);
+	  TheInterface->WaveformSelector_HS->SetPosition(Waveform);
+	  if(Waveform == TheInterface->Waveforms_NEL->GetNumber()-1){
+	    TheInterface->WaveformSelector_NEL->GetEntry()->SetIntNumber(0);
+	    TheInterface->WaveformSelector_HS->SetPosition(0);
+	    break;
+	  }
 	}
       }
       TheInterface->SaveSettings();
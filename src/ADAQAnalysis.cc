@@ -101,17 +101,25 @@ int main(int argc, char *argv[])
   
   // Run ROOT in standalone mode
   TApplication *TheApplication = new TApplication("ADAQAnalysis", &argc, argv);
+
+  AAInterface::AddStartupTime("ROOT application");
   
   // Create the singleton analysis manager
   AAComputation *TheComputation = new AAComputation(CmdLineArg, ParallelArchitecture);
+
+  AAInterface::AddStartupTime("Computation manager");
   
   if(!ParallelArchitecture){
 
     // Create the singleton graphics manager
     AAGraphics *TheGraphics = new AAGraphics;
 
+    AAInterface::AddStartupTime("Graphics manager");
+
     // Create the singletone interpolation manager
     AAInterpolation *TheInterpolation = new AAInterpolation;
+
+    AAInterface::AddStartupTime("Interpolation manager");
     
     // Create the graphical user interface
     AAInterface *TheInterface = new AAInterface(CmdLineArg);